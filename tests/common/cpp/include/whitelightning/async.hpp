@@ -0,0 +1,142 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace whitelightning {
+
+// Where an async predict delivers its completion, e.g. a post to the
+// caller's event loop. It is invoked on an ORT intra-op thread, so it should
+// only enqueue.
+using Executor = std::function<void(std::function<void()>)>;
+
+// Runs completions right on the ORT thread that finished the Run
+inline Executor inline_executor() {
+    return [](std::function<void()> task) { task(); };
+}
+
+// Completions queued for one thread to run, e.g. an I/O loop between polls.
+// executor() is the Executor to hand to an AsyncRunner.
+class CompletionQueue {
+public:
+    Executor executor() {
+        return [this](std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                tasks_.push_back(std::move(task));
+            }
+            ready_.notify_one();
+        };
+    }
+    
+    // Run everything queued so far; returns how many ran
+    size_t run_pending() {
+        std::deque<std::function<void()>> tasks;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks.swap(tasks_);
+        }
+        for (auto& task : tasks) task();
+        return tasks.size();
+    }
+    
+    // Wait up to timeout_ms for a completion, then run_pending()
+    size_t wait_and_run(double timeout_ms) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ready_.wait_for(lock, std::chrono::duration<double, std::milli>(timeout_ms),
+                            [this]() { return !tasks_.empty(); });
+        }
+        return run_pending();
+    }
+    
+private:
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<std::function<void()>> tasks_;
+};
+
+// In-flight bookkeeping of a classifier's AsyncRunner: which of its
+// preallocated slots are free, and how many runs have not finished their
+// completion yet. A slot is released before the completion is handed to the
+// executor, so a callback may submit again without deadlocking, while the
+// runner itself stays alive until finish().
+class AsyncSlots {
+public:
+    explicit AsyncSlots(size_t count) : capacity_(count) {
+        for (size_t i = count; i > 0; i--) free_.push_back(i - 1);
+    }
+    
+    size_t capacity() const { return capacity_; }
+    
+    bool try_acquire(size_t& slot) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_.empty()) return false;
+        slot = take();
+        return true;
+    }
+    
+    size_t acquire() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [this]() { return !free_.empty(); });
+        return take();
+    }
+    
+    // The slot's buffers may be reused; the run is still active
+    void release(size_t slot) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_.push_back(slot);
+        }
+        changed_.notify_all();
+    }
+    
+    // The completion was handed off; nothing touches the runner for this run.
+    // Notifies under the lock: wait_idle() may return, and the runner be
+    // destroyed, as soon as it is released.
+    void finish() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        active_--;
+        changed_.notify_all();
+    }
+    
+    // A slot acquired but never submitted
+    void cancel(size_t slot) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_.push_back(slot);
+        active_--;
+        changed_.notify_all();
+    }
+    
+    size_t in_flight() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return active_;
+    }
+    
+    void wait_idle() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [this]() { return active_ == 0; });
+    }
+    
+private:
+    size_t take() {
+        size_t slot = free_.back();
+        free_.pop_back();
+        active_++;
+        return slot;
+    }
+    
+    const size_t capacity_;
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    std::vector<size_t> free_;
+    size_t active_ = 0;
+};
+
+}  // namespace whitelightning
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "whitelightning/async.hpp"
+#include "whitelightning/benchmark.hpp"
+#include "whitelightning/latency_histogram.hpp"
+
+namespace whitelightning {
+
+// --async-bench: one caller thread keeps up to `depth` requests in flight
+// through an AsyncRunner, vectorizing each text itself and running
+// completions from a CompletionQueue between submits, against the same
+// texts run one at a time with a blocking Binding::run
+struct AsyncBenchConfig {
+    std::vector<int> depths = {1, 2, 4, 8, 16, 32};
+    int requests = 2000;  // per depth
+};
+
+struct AsyncDepthPoint {
+    int depth = 0;
+    double seconds = 0;
+    double throughput = 0;     // completed requests/sec
+    LatencyHistogram latency;  // submit (before vectorizing) to callback
+};
+
+struct AsyncBenchResult {
+    int requests = 0;
+    int intra_op_threads = 0;  // of the session, set by the caller
+    double blocking_throughput = 0;
+    LatencyHistogram blocking_latency;
+    std::vector<AsyncDepthPoint> points;
+};
+
+// Submit corpus text `text` if the runner has a free slot (false otherwise);
+// done is called on the completion, through the runner's executor
+using AsyncSubmit = std::function<bool(size_t text, std::function<void()> done)>;
+
+// An AsyncRunner with `depth` slots delivering to `executor`, kept alive by
+// the returned AsyncSubmit
+using AsyncRunnerFactory = std::function<AsyncSubmit(int depth, Executor executor)>;
+
+// Classify corpus text `text` with the blocking Run
+using BlockingHandler = std::function<void(size_t text)>;
+
+// Request k is text k % num_texts
+AsyncBenchResult run_async_benchmark(const AsyncBenchConfig& config, size_t num_texts, const BlockingHandler& blocking,
+                                     const AsyncRunnerFactory& make_runner);
+
+void print_async_benchmark(const AsyncBenchResult& result);
+json async_benchmark_report(const std::string& name, const Corpus& corpus, const AsyncBenchResult& result,
+                            const SystemInfo& system_info);
+
+}  // namespace whitelightning
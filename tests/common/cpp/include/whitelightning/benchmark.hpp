@@ -0,0 +1,151 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "whitelightning/classifier.hpp"
+#include "whitelightning/execution_provider.hpp"
+#include "whitelightning/latency_histogram.hpp"
+#include "whitelightning/metrics.hpp"
+#include "whitelightning/session_config.hpp"
+
+namespace whitelightning {
+
+using json = nlohmann::json;
+
+// Benchmark input: the built-in sentence or a --corpus file (plain text or
+// JSONL {"text": ...} per line), optionally shuffled with --seed
+struct Corpus {
+    std::string source;
+    std::vector<std::string> texts;
+    bool shuffled = false;
+    uint64_t seed = 0;
+};
+
+Corpus load_corpus(const std::string& path, bool shuffle, uint64_t seed);
+
+// Token-count buckets for the per-length benchmark breakdown
+struct LengthBucket {
+    const char* name;
+    size_t max_tokens;
+};
+
+const LengthBucket kLengthBuckets[] = {
+    {"1-8", 8}, {"9-16", 16}, {"17-30", 30}, {"31-64", 64}, {"65+", SIZE_MAX}
+};
+constexpr size_t kNumLengthBuckets = sizeof(kLengthBuckets) / sizeof(kLengthBuckets[0]);
+
+size_t length_bucket(size_t tokens);
+
+struct LengthBucketStats {
+    size_t texts = 0;
+    uint64_t tokens = 0;
+    uint64_t oov_tokens = 0;
+    LatencyHistogram latency;
+    LatencyHistogram preprocessing;
+};
+
+// Machine-readable --benchmark --report output, stable enough to diff in CI
+json latency_summary(const LatencyHistogram& histogram);
+json length_bucket_report(const std::vector<LengthBucketStats>& buckets);
+json result_cache_report(const ResultCacheStats& cache);
+json startup_report(const StartupTiming& startup);
+// Platform, CPU topology, ORT version and the --pin placement
+json system_report(const SystemInfo& system_info);
+
+json benchmark_report(const std::string& name, const Corpus& corpus, int num_runs, double total_time_ms,
+                      const LatencyHistogram& latency, const LatencyHistogram& preprocessing,
+                      const LatencyHistogram& inference, const LatencyHistogram& postprocessing,
+                      const SystemInfo& system_info);
+void write_benchmark_report(const std::string& path, const json& report);
+
+// One side of --compare-variants: the same corpus timed end to end on one
+// model variant, plus the label it predicts for every corpus text
+struct VariantResult {
+    std::string name;
+    std::string model_path;
+    double load_ms = 0;
+    double load_rss_mb = 0;  // resident growth from loading the session
+    double run_rss_mb = 0;   // resident growth by the end of the timed runs
+    double total_time_ms = 0;
+    LatencyHistogram latency;
+    std::vector<int> labels;
+};
+
+// Fraction of corpus texts both variants give the same label
+double label_agreement(const VariantResult& baseline, const VariantResult& candidate);
+void print_variant_comparison(const VariantResult& baseline, const VariantResult& candidate, const Corpus& corpus,
+                              const std::vector<std::string>& label_names);
+json variant_comparison_report(const std::string& name, const Corpus& corpus, int num_runs,
+                               const VariantResult& baseline, const VariantResult& candidate,
+                               const SystemInfo& system_info);
+
+// --sessions N: resident growth (get_memory_usage_mb deltas) from keeping N
+// more sessions of the same model alive in one loading mode
+struct SessionMemoryResult {
+    std::string mode;
+    int sessions = 0;
+    double first_mb = 0;       // the first extra session
+    double additional_mb = 0;  // mean over every later one
+};
+
+// Call load() `sessions` times and append each result to held. Nothing is
+// freed until the caller drops held, so no measurement reuses heap another
+// mode released.
+template <typename Held, typename Load>
+SessionMemoryResult measure_session_memory(const std::string& mode, int sessions, std::vector<Held>& held, Load&& load) {
+    SessionMemoryResult result;
+    result.mode = mode;
+    result.sessions = sessions;
+    double later_mb = 0;
+    for (int i = 0; i < sessions; i++) {
+        double before = get_memory_usage_mb();
+        held.push_back(load());
+        double delta = get_memory_usage_mb() - before;
+        if (i == 0) {
+            result.first_mb = delta;
+        } else {
+            later_mb += delta;
+        }
+    }
+    result.additional_mb = sessions > 1 ? later_mb / (sessions - 1) : result.first_mb;
+    return result;
+}
+
+// The first result is the baseline the others' savings are measured against
+void print_session_memory(const std::vector<SessionMemoryResult>& results);
+json session_memory_report(const std::vector<SessionMemoryResult>& results);
+
+// --sweep-providers: one execution provider at one batch size, timed over
+// the corpus through Classifier::predict_batch
+struct ProviderSweepResult {
+    ExecutionProvider requested = ExecutionProvider::Cpu;
+    ExecutionProvider provider = ExecutionProvider::Cpu;  // differs from requested after a fallback
+    int batch_size = 0;                                   // 0 when the provider fell back and was not timed
+    std::string error;                                    // set when the bundle failed to load at all
+    double load_ms = 0;
+    size_t texts = 0;
+    double total_time_ms = 0;
+    LatencyHistogram latency;                             // per batch
+};
+
+// Load the bundle once per provider in available_execution_providers() and
+// time about num_runs texts at each batch size 1, 2, 4, ..., max_batch. A
+// provider whose load throws is recorded as an untimed fallback entry.
+std::vector<ProviderSweepResult> sweep_providers(const ModelBundle& bundle, SessionConfig config, int num_runs,
+                                                 int max_batch, const std::vector<std::string>& texts);
+void print_provider_sweep(const std::vector<ProviderSweepResult>& results);
+json provider_sweep_report(const std::vector<ProviderSweepResult>& results);
+
+// --cold-start: session creation from model.onnx with full optimization
+// versus from the cached ORT-format graph (populated first if missing)
+int run_cold_start_benchmark(const std::string& model_path, int num_runs = 3);
+
+// --compile-vocab: write the vocab (and scaler idf, if given) as a vocab.bin
+// image, then time opening it
+int compile_vocab(const std::string& vocab_path, const std::string& output_path, const std::string& scaler_path = "");
+
+}  // namespace whitelightning
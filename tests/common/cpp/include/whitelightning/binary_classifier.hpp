@@ -0,0 +1,606 @@
+#pragma once
+
+#include <onnxruntime_cxx_api.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "whitelightning/async.hpp"
+#include "whitelightning/containers.hpp"
+#include "whitelightning/execution_provider.hpp"
+#include "whitelightning/mapped_model.hpp"
+#include "whitelightning/metrics.hpp"
+#include "whitelightning/model_cache.hpp"
+#include "whitelightning/result_cache.hpp"
+#include "whitelightning/session_config.hpp"
+#include "whitelightning/tokenizer.hpp"
+#include "whitelightning/topology.hpp"
+#include "whitelightning/trace.hpp"
+#include "whitelightning/vocab_index.hpp"
+
+namespace whitelightning {
+
+// Long-lived classifier: vocab, IDF, scaler and ONNX session are loaded once
+// and reused for every text, so predict() only pays tokenization and Run.
+class BinaryClassifier {
+public:
+    BinaryClassifier(const std::string& model_path, const std::string& vocab_path, const std::string& scaler_path,
+                     const SessionConfig& config = {})
+        : env_(nullptr),
+          session_(nullptr),
+          memory_info_(Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault)) {
+        double env_start = get_time_ms();
+        env_ = Ort::Env(ORT_LOGGING_LEVEL_WARNING, "binary_classifier");
+        startup_.env_init_ms = get_time_ms() - env_start;
+        
+        // Prefer the precompiled vocab.bin; otherwise compile vocab.json in memory
+        double vocab_start = get_time_ms();
+        std::string compiled_path = VocabIndex::compiled_path(vocab_path);
+        if (VocabIndex::is_fresh(compiled_path, {vocab_path, scaler_path})) {
+            vocab_.open(compiled_path);
+            vocab_source_ = compiled_path + " (mmap)";
+        } else {
+            vocab_.adopt(VocabIndex::compile(vocab_path, scaler_path));
+            vocab_source_ = vocab_path + " (compiled in memory)";
+        }
+        
+        vocab_size_ = vocab_.size();
+        size_t baseline_count = 0, coef_count = 0;
+        baseline_ = vocab_.array(VocabIndex::kTagBaseline, &baseline_count);
+        coef_ = vocab_.array(VocabIndex::kTagCoef, &coef_count);
+        if (baseline_ == nullptr || coef_ == nullptr) {
+            // vocab.bin predates the folded arrays: fold them here instead
+            size_t idf_count = 0, mean_count = 0, scale_count = 0;
+            const float* idf = vocab_.array(VocabIndex::kTagIdf, &idf_count);
+            const float* mean = vocab_.array(VocabIndex::kTagMean, &mean_count);
+            const float* scale = vocab_.array(VocabIndex::kTagScale, &scale_count);
+            std::vector<float> baseline, coef;
+            VocabIndex::fold_scaler(std::vector<float>(idf, idf + idf_count), std::vector<float>(mean, mean + mean_count),
+                                    std::vector<float>(scale, scale + scale_count), baseline, coef);
+            folded_baseline_.assign(baseline.begin(), baseline.end());
+            folded_coef_.assign(coef.begin(), coef.end());
+            baseline_ = folded_baseline_.data();
+            coef_ = folded_coef_.data();
+            baseline_count = folded_baseline_.size();
+            coef_count = folded_coef_.size();
+        }
+        if (baseline_count < vocab_size_ || coef_count < vocab_size_) {
+            throw std::runtime_error("Vocab/scaler size mismatch: vocab has " + std::to_string(vocab_size_) + " entries");
+        }
+        double vocab_end = get_time_ms();
+        startup_.vocab_load_ms = vocab_end - vocab_start;
+        record_trace_span("vocab_load", vocab_start, vocab_end);
+        
+        // One session is shared by every worker thread (Run is thread-safe)
+        auto configure = [&](Ort::SessionOptions& options) {
+            intra_op_threads_ = configure_intra_op_threads(options, config);
+            if (config.inter_op_threads > 0) {
+                // Inter-op threads are only used by the parallel executor
+                options.SetInterOpNumThreads(config.inter_op_threads);
+                options.SetExecutionMode(ExecutionMode::ORT_PARALLEL);
+            }
+            if (!config.profile_prefix.empty()) {
+                options.EnableProfiling(config.profile_prefix.c_str());
+                profiling_ = true;
+            }
+        };
+        std::unique_ptr<OptimizedModelCache> model_cache;
+        auto open = [&](Ort::SessionOptions& options, ExecutionProvider provider) {
+            // The optimized graph is cached per provider
+            std::string session_model_path = model_path;
+            model_cache.reset();
+            if (config.model_cache) {
+                model_cache = std::make_unique<OptimizedModelCache>(model_path, provider);
+                session_model_path = model_cache->configure(options);
+            }
+            if (config.mmap_model) {
+                bool ort_format = model_cache && model_cache->warm();
+                return create_mapped_session(env_, session_model_path, options, ort_format, model_mapping_);
+            }
+            return Ort::Session(env_, session_model_path.c_str(), options);
+        };
+        double session_start = get_time_ms();
+        session_ = create_session(config, session_options_, provider_, configure, open);
+        double session_end = get_time_ms();
+        startup_.session_load_ms = session_end - session_start;
+        record_trace_span("session_load", session_start, session_end);
+        if (model_cache) {
+            model_cache->commit();
+            session_source_ = (model_cache->warm() ? "warm, loaded " : "cold, optimized and saved ") + model_cache->path();
+        } else {
+            session_source_ = model_path;
+        }
+        if (config.mmap_model) {
+            session_source_ += model_mapping_ ? " (mmap, in place)" : " (mmap)";
+        }
+        
+        if (config.result_cache_entries > 0 || config.result_cache_bytes > 0) {
+            result_cache_ = std::make_unique<ResultCache<float>>(config.result_cache_entries, config.result_cache_bytes);
+        }
+        
+        // Dynamic input/output detection
+        Ort::AllocatorWithDefaultOptions allocator;
+        input_name_ = session_.GetInputNameAllocated(0, allocator).get();
+        output_name_ = session_.GetOutputNameAllocated(0, allocator).get();
+        auto input_shape = session_.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        dynamic_batch_ = !input_shape.empty() && input_shape[0] < 0;
+        
+        // Output row shape for preallocated output buffers (dynamic dims count as 1)
+        output_shape_ = session_.GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        output_stride_ = 1;
+        for (size_t i = 1; i < output_shape_.size(); i++) {
+            output_shape_[i] = std::max<int64_t>(output_shape_[i], 1);
+            output_stride_ *= static_cast<size_t>(output_shape_[i]);
+        }
+        
+        // Pay the first Run's one-off setup here, not in the first prediction
+        FeatureVector warmup = preprocess("");
+        double first_run_start = get_time_ms();
+        infer(warmup);
+        double first_run_end = get_time_ms();
+        startup_.first_run_ms = first_run_end - first_run_start;
+        record_trace_span("first_run", first_run_start, first_run_end);
+    }
+    
+    size_t feature_count() const { return vocab_size_; }
+    bool supports_dynamic_batch() const { return dynamic_batch_; }
+    const std::string& vocab_source() const { return vocab_source_; }
+    const std::string& session_source() const { return session_source_; }
+    const StartupTiming& startup() const { return startup_; }
+    // The provider the session runs on, after any fallback to cpu
+    ExecutionProvider provider() const { return provider_; }
+    // Size of the session's intra-op pool
+    int intra_op_threads() const { return intra_op_threads_; }
+    
+    // Stop ORT profiling (SessionConfig::profile_prefix) and return the
+    // profile for write_chrome_trace(); an empty path when it was not enabled
+    OrtProfile end_profiling(const std::string& label) {
+        OrtProfile profile{label, "", 0};
+        if (!profiling_) return profile;
+        Ort::AllocatorWithDefaultOptions allocator;
+        profile.start_ns = session_.GetProfilingStartTimeNs();
+        profile.path = session_.EndProfilingAllocated(allocator).get();
+        profiling_ = false;
+        return profile;
+    }
+    
+    // Lowercase, tokenize, TF-IDF and standardize one text
+    FeatureVector preprocess(std::string_view text) const {
+        FeatureVector vector(vocab_size_);
+        preprocess_into(text, vector.data());
+        return vector;
+    }
+    
+    // Write the standardized TF-IDF vector into out[feature_count()]: copy the
+    // precomputed baseline, then patch only the features present in the text
+    void preprocess_into(std::string_view text, float* out) const {
+        preprocess_words_into(tokenize_words(text, tokenizer_scratch()), out);
+    }
+    
+    // preprocess_into() for the words tokenize_words() (or split_words())
+    // produced, e.g. once for several models in a FanOutClassifier
+    void preprocess_words_into(const std::vector<std::string_view>& tokens, float* out) const {
+        TraceSpan span("vectorize");
+        std::memcpy(out, baseline_, vocab_size_ * sizeof(float));
+        
+        // Count by vocab index in the per-thread scratch
+        IndexCounter& counts = tokenizer_scratch().counts;
+        counts.clear();
+        for (std::string_view token : tokens) {
+            int32_t idx = vocab_.find(token);
+            if (idx >= 0 && static_cast<size_t>(idx) < vocab_size_) {
+                counts.add(idx);
+            }
+        }
+        
+        // TF (normalized by total words) times the folded idf/scale coefficient
+        float total_words = static_cast<float>(tokens.size());
+        counts.for_each([&](int32_t idx, int32_t count) {
+            out[idx] = baseline_[idx] + (count / total_words) * coef_[idx];
+        });
+    }
+    
+    // Token and OOV counts with the same tokenizer as preprocess_into
+    TokenStats token_stats(std::string_view text) const {
+        TokenStats stats;
+        for (std::string_view token : tokenize_words(text, tokenizer_scratch())) {
+            stats.tokens++;
+            stats.oov += vocab_.find(token) < 0;
+        }
+        return stats;
+    }
+    
+    // Original tokenizer (std::string copies, std::map counts), kept as the
+    // baseline for --alloc-bench
+    void preprocess_legacy(std::string_view text, float* out) const {
+        std::memcpy(out, baseline_, vocab_size_ * sizeof(float));
+        
+        std::string text_lower(text);
+        std::transform(text_lower.begin(), text_lower.end(), text_lower.begin(), ::tolower);
+        std::map<std::string, int> word_counts;
+        int total_words = 0;
+        
+        size_t start = 0, end;
+        while ((end = text_lower.find(' ', start)) != std::string::npos) {
+            if (end > start) {
+                word_counts[text_lower.substr(start, end - start)]++;
+                total_words++;
+            }
+            start = end + 1;
+        }
+        if (start < text_lower.length()) {
+            word_counts[text_lower.substr(start)]++;
+            total_words++;
+        }
+        
+        for (const auto& [word, count] : word_counts) {
+            int32_t idx = vocab_.find(word);
+            if (idx >= 0 && static_cast<size_t>(idx) < vocab_size_) {
+                out[idx] = baseline_[idx] + (static_cast<float>(count) / total_words) * coef_[idx];
+            }
+        }
+    }
+    
+    // Run the session on an already vectorized text
+    float infer(FeatureVector& features) {
+        float prediction = 0.0f;
+        infer_batch(features.data(), 1, &prediction);
+        return prediction;
+    }
+    
+    // Run n vectorized rows (row-major [n, feature_count()]) as one batch and
+    // write one probability per row. Models with a fixed batch dimension are
+    // run row by row.
+    void infer_batch(float* features, size_t n, float* predictions) {
+        if (!dynamic_batch_ && n > 1) {
+            for (size_t i = 0; i < n; i++) {
+                infer_batch(features + i * vocab_size_, 1, predictions + i);
+            }
+            return;
+        }
+        
+        std::vector<int64_t> input_shape = {static_cast<int64_t>(n), static_cast<int64_t>(vocab_size_)};
+        Ort::Value input_tensor{nullptr};
+        {
+            TraceSpan span("tensor_create");
+            input_tensor = Ort::Value::CreateTensor<float>(memory_info_, features, n * vocab_size_,
+                                                           input_shape.data(), input_shape.size());
+        }
+        
+        const char* input_names[] = {input_name_.c_str()};
+        const char* output_names[] = {output_name_.c_str()};
+        
+        std::vector<Ort::Value> output_tensors;
+        {
+            TraceSpan span("run");
+            output_tensors = session_.Run(Ort::RunOptions{nullptr}, input_names, &input_tensor, 1, output_names, 1);
+        }
+        
+        // Scatter row i of the [n, k] output back to text i
+        const float* output_data = output_tensors[0].GetTensorMutableData<float>();
+        size_t stride = output_tensors[0].GetTensorTypeAndShapeInfo().GetElementCount() / n;
+        for (size_t i = 0; i < n; i++) {
+            predictions[i] = output_data[i * stride];
+        }
+    }
+    
+    // Result cache: texts with the same normalized_text_hash() skip
+    // vectorization and Run. Without a cache lookups miss and stores are no-ops.
+    bool has_result_cache() const { return result_cache_ != nullptr; }
+    ResultCacheStats result_cache_stats() const { return result_cache_ ? result_cache_->stats() : ResultCacheStats{}; }
+    
+    // Cached probability of text; key is set for a later cache_store() either way
+    bool cache_lookup(std::string_view text, uint64_t& key, float& probability) {
+        if (!result_cache_) return false;
+        key = normalized_text_hash(text);
+        return result_cache_->lookup(key, probability);
+    }
+    void cache_store(uint64_t key, float probability) {
+        if (result_cache_) result_cache_->insert(key, probability);
+    }
+    
+    float predict(std::string_view text) {
+        uint64_t key = 0;
+        float prediction = 0.0f;
+        if (cache_lookup(text, key, prediction)) return prediction;
+        auto features = preprocess(text);
+        prediction = infer(features);
+        cache_store(key, prediction);
+        return prediction;
+    }
+    
+    // Vectorize the texts missing from the result cache into one contiguous
+    // [N, features] buffer and issue a single Run
+    std::vector<float> predict_batch(Span<const std::string_view> texts) {
+        thread_local FeatureVector batch;
+        thread_local std::vector<uint64_t> keys;
+        thread_local std::vector<size_t> misses;
+        thread_local std::vector<float> miss_predictions;
+        batch.resize(texts.size() * vocab_size_);
+        keys.resize(texts.size());
+        misses.clear();
+        std::vector<float> predictions(texts.size());
+        for (size_t i = 0; i < texts.size(); i++) {
+            if (cache_lookup(texts[i], keys[i], predictions[i])) continue;
+            preprocess_into(texts[i], batch.data() + misses.size() * vocab_size_);
+            misses.push_back(i);
+        }
+        if (!misses.empty()) {
+            miss_predictions.resize(misses.size());
+            infer_batch(batch.data(), misses.size(), miss_predictions.data());
+            for (size_t k = 0; k < misses.size(); k++) {
+                predictions[misses[k]] = miss_predictions[k];
+                cache_store(keys[misses[k]], miss_predictions[k]);
+            }
+        }
+        return predictions;
+    }
+    
+    // predict_batch() without the result cache, so every row reaches the model
+    std::vector<float> predict_batch_uncached(Span<const std::string_view> texts) {
+        thread_local FeatureVector batch;
+        batch.resize(texts.size() * vocab_size_);
+        for (size_t i = 0; i < texts.size(); i++) {
+            preprocess_into(texts[i], batch.data() + i * vocab_size_);
+        }
+        std::vector<float> predictions(texts.size());
+        if (!texts.empty()) infer_batch(batch.data(), texts.size(), predictions.data());
+        return predictions;
+    }
+    
+    // Input and output tensors allocated once and bound with Ort::IoBinding,
+    // so a steady-state Run allocates nothing on our side. Tensors are
+    // rebound only when the row count changes. Not thread-safe: one per worker.
+    class Binding {
+    public:
+        explicit Binding(BinaryClassifier& classifier)
+            : classifier_(classifier), binding_(classifier.session_) {}
+        
+        // Row-major [rows, feature_count()] input buffer to vectorize into
+        float* input(size_t rows) {
+            if (rows != rows_) {
+                bind(rows);
+            }
+            return input_.data();
+        }
+        
+        // Run on the rows of the last input() call
+        void run() {
+            TraceSpan span("run");
+            classifier_.session_.Run(run_options_, binding_);
+        }
+        
+        float probability(size_t row) const { return output_[row * classifier_.output_stride_]; }
+        // 1 (Positive) or 0 (Negative)
+        int predicted_class(size_t row) const { return probability(row) > 0.5f ? 1 : 0; }
+        
+    private:
+        void bind(size_t rows) {
+            if (rows > 1 && !classifier_.dynamic_batch_) {
+                throw std::runtime_error("Model has a fixed batch dimension");
+            }
+            size_t features = classifier_.vocab_size_;
+            // Buffers only grow, so alternating batch sizes don't reallocate
+            if (input_.size() < rows * features) {
+                input_.resize(rows * features);
+                output_.resize(rows * classifier_.output_stride_);
+            }
+            
+            TraceSpan span("tensor_create");
+            std::vector<int64_t> input_shape = {static_cast<int64_t>(rows), static_cast<int64_t>(features)};
+            std::vector<int64_t> output_shape = classifier_.output_shape_;
+            output_shape[0] = static_cast<int64_t>(rows);
+            input_tensor_ = Ort::Value::CreateTensor<float>(classifier_.memory_info_, input_.data(), rows * features,
+                                                            input_shape.data(), input_shape.size());
+            output_tensor_ = Ort::Value::CreateTensor<float>(classifier_.memory_info_, output_.data(),
+                                                             rows * classifier_.output_stride_,
+                                                             output_shape.data(), output_shape.size());
+            binding_.ClearBoundInputs();
+            binding_.ClearBoundOutputs();
+            binding_.BindInput(classifier_.input_name_.c_str(), input_tensor_);
+            binding_.BindOutput(classifier_.output_name_.c_str(), output_tensor_);
+            rows_ = rows;
+        }
+        
+        BinaryClassifier& classifier_;
+        Ort::IoBinding binding_;
+        Ort::RunOptions run_options_;
+        FeatureVector input_;
+        std::vector<float> output_;
+        Ort::Value input_tensor_{nullptr};
+        Ort::Value output_tensor_{nullptr};
+        size_t rows_ = 0;
+    };
+    
+    // Non-blocking predict on Ort::Session::RunAsync, so one I/O thread can
+    // keep up to max_in_flight texts in flight. submit() vectorizes on the
+    // calling thread into a preallocated slot and returns once the Run is
+    // queued on the session's intra-op pool; the callback is delivered
+    // through executor. RunAsync needs at least two intra-op threads, so load
+    // the classifier with SessionConfig::async; the constructor throws
+    // otherwise. The result cache is bypassed. Submit from one thread at a time.
+    class AsyncRunner {
+    public:
+        // error is set, and probability meaningless, when the Run failed
+        using Callback = std::function<void(float probability, std::exception_ptr error)>;
+        
+        AsyncRunner(BinaryClassifier& classifier, size_t max_in_flight, Executor executor = inline_executor())
+            : classifier_(classifier), executor_(std::move(executor)), slots_(std::max<size_t>(1, max_in_flight)),
+              requests_(slots_.capacity()) {
+            if (classifier_.intra_op_threads_ < 2) {
+                throw std::runtime_error("AsyncRunner needs an intra-op pool of at least 2 threads (intra-op threads: " +
+                                         std::to_string(classifier_.intra_op_threads_) +
+                                         "); load the classifier with SessionConfig::async");
+            }
+            size_t features = classifier_.vocab_size_;
+            std::vector<int64_t> input_shape = {1, static_cast<int64_t>(features)};
+            std::vector<int64_t> output_shape = classifier_.output_shape_;
+            output_shape[0] = 1;
+            for (size_t i = 0; i < requests_.size(); i++) {
+                Request& request = requests_[i];
+                request.runner = this;
+                request.slot = i;
+                request.input.resize(features);
+                request.output.resize(classifier_.output_stride_);
+                request.input_tensor = Ort::Value::CreateTensor<float>(classifier_.memory_info_, request.input.data(),
+                                                                       features, input_shape.data(), input_shape.size());
+                request.output_tensor = Ort::Value::CreateTensor<float>(classifier_.memory_info_, request.output.data(),
+                                                                        request.output.size(), output_shape.data(),
+                                                                        output_shape.size());
+            }
+        }
+        
+        // Waits for the runs still in flight
+        ~AsyncRunner() { slots_.wait_idle(); }
+        
+        AsyncRunner(const AsyncRunner&) = delete;
+        AsyncRunner& operator=(const AsyncRunner&) = delete;
+        
+        // Blocks only while max_in_flight runs are pending
+        void submit(std::string_view text, Callback done) {
+            start(slots_.acquire(), text, std::move(done));
+        }
+        
+        // submit() unless every slot is in flight
+        bool try_submit(std::string_view text, Callback done) {
+            size_t slot;
+            if (!slots_.try_acquire(slot)) return false;
+            start(slot, text, std::move(done));
+            return true;
+        }
+        
+        std::future<float> predict(std::string_view text) {
+            auto promise = std::make_shared<std::promise<float>>();
+            std::future<float> result = promise->get_future();
+            submit(text, [promise](float probability, std::exception_ptr error) {
+                if (error) {
+                    promise->set_exception(error);
+                } else {
+                    promise->set_value(probability);
+                }
+            });
+            return result;
+        }
+        
+        size_t in_flight() const { return slots_.in_flight(); }
+        size_t capacity() const { return slots_.capacity(); }
+        void wait() { slots_.wait_idle(); }
+        
+    private:
+        struct Request {
+            AsyncRunner* runner = nullptr;
+            size_t slot = 0;
+            FeatureVector input;
+            std::vector<float> output;
+            Ort::Value input_tensor{nullptr};
+            Ort::Value output_tensor{nullptr};
+            Callback done;
+            double start_ms = 0;
+        };
+        
+        void start(size_t slot, std::string_view text, Callback done) {
+            Request& request = requests_[slot];
+            try {
+                classifier_.preprocess_into(text, request.input.data());
+                request.done = std::move(done);
+                request.start_ms = get_time_ms();
+                const char* input_name = classifier_.input_name_.c_str();
+                const char* output_name = classifier_.output_name_.c_str();
+                classifier_.session_.RunAsync(run_options_, &input_name, &request.input_tensor, 1, &output_name,
+                                              &request.output_tensor, 1, &AsyncRunner::on_complete, &request);
+            } catch (...) {
+                request.done = nullptr;
+                slots_.cancel(slot);
+                throw;
+            }
+        }
+        
+        // On an ORT intra-op thread. The slot is free again before the
+        // callback is handed to the executor.
+        static void on_complete(void* user_data, OrtValue**, size_t, OrtStatusPtr status_ptr) {
+            Request& request = *static_cast<Request*>(user_data);
+            AsyncRunner& runner = *request.runner;
+            Ort::Status status(status_ptr);
+            record_trace_span("run", request.start_ms, get_time_ms());
+            float probability = status.IsOK() ? request.output[0] : 0.0f;
+            std::exception_ptr error;
+            if (!status.IsOK()) {
+                error = std::make_exception_ptr(std::runtime_error("RunAsync failed: " + status.GetErrorMessage()));
+            }
+            Callback done = std::move(request.done);
+            runner.slots_.release(request.slot);
+            try {
+                runner.executor_([done = std::move(done), probability, error]() { done(probability, error); });
+            } catch (const std::exception& e) {
+                std::cerr << "❌ Async completion error: " << e.what() << std::endl;
+            }
+            runner.slots_.finish();
+        }
+        
+        BinaryClassifier& classifier_;
+        Executor executor_;
+        Ort::RunOptions run_options_;
+        AsyncSlots slots_;
+        std::vector<Request> requests_;
+    };
+    
+    // Vectorize one text into a single-row binding
+    void preprocess_into(std::string_view text, Binding& binding) const {
+        preprocess_into(text, binding.input(1));
+    }
+    
+    // Vectorize texts into binding as one [n, feature_count()] batch
+    void preprocess_batch_into(Span<const std::string_view> texts, Binding& binding) const {
+        float* input = binding.input(texts.size());
+        for (size_t i = 0; i < texts.size(); i++) {
+            preprocess_into(texts[i], input + i * vocab_size_);
+        }
+    }
+    
+    // Binding for the calling (main) thread, created on first use
+    Binding& binding() {
+        if (!binding_) {
+            binding_ = std::make_unique<Binding>(*this);
+        }
+        return *binding_;
+    }
+    
+private:
+    VocabIndex vocab_;
+    std::string vocab_source_;
+    std::string session_source_;
+    StartupTiming startup_;
+    ExecutionProvider provider_ = ExecutionProvider::Cpu;
+    int intra_op_threads_ = 0;
+    bool profiling_ = false;
+    const float* baseline_ = nullptr;
+    const float* coef_ = nullptr;
+    FeatureVector folded_baseline_;
+    FeatureVector folded_coef_;
+    size_t vocab_size_ = 0;
+    
+    Ort::Env env_;
+    Ort::SessionOptions session_options_;
+    std::shared_ptr<const MappedModel> model_mapping_;  // destroyed after session_
+    Ort::Session session_;
+    Ort::MemoryInfo memory_info_;
+    std::string input_name_;
+    std::string output_name_;
+    bool dynamic_batch_ = false;
+    std::vector<int64_t> output_shape_;
+    size_t output_stride_ = 1;
+    std::unique_ptr<Binding> binding_;
+    std::unique_ptr<ResultCache<float>> result_cache_;
+};
+
+}  // namespace whitelightning
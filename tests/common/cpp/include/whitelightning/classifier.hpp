@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "whitelightning/execution_provider.hpp"
+#include "whitelightning/latency_histogram.hpp"
+#include "whitelightning/metrics.hpp"
+#include "whitelightning/model_variant.hpp"
+#include "whitelightning/result_cache.hpp"
+#include "whitelightning/session_config.hpp"
+
+namespace whitelightning {
+
+// Stable API for embedding an exported model. Only standard library types
+// cross it, so callers don't depend on ONNX Runtime headers or on the
+// concrete BinaryClassifier / TopicClassifier / EmotionClassifier types.
+
+// Kind of model a bundle holds, matching the tests/<model>/ directories
+enum class ModelType { Binary, Multiclass, MultiLabel };
+
+// Files one exported model ships with; a fresh vocab.bin next to vocab.json
+// is picked up automatically
+struct ModelBundle {
+    ModelType type = ModelType::Binary;
+    std::string model_path;
+    std::string vocab_path;
+    std::string scaler_path;
+    
+    // model.onnx (or model.int8.onnx), vocab.json and scaler.json in one directory
+    static ModelBundle from_directory(const std::string& directory, ModelType type,
+                                      ModelVariant variant = ModelVariant::Fp32);
+};
+
+// Result for one text. scores has one entry per label: {1 - p, p} for a
+// binary model, the softmax for multiclass and independent sigmoid
+// probabilities for multi-label models.
+struct Prediction {
+    size_t label = 0;  // index of the highest score
+    float confidence = 0.0f;
+    std::vector<float> scores;
+};
+
+// Counters since load() or the last reset_stats(). Latencies are per call:
+// one text for predict(), one whole batch for predict_batch().
+struct ClassifierStats {
+    uint64_t calls = 0;
+    uint64_t texts = 0;
+    double total_ms = 0.0;
+    double mean_ms = 0.0;
+    double p50_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+    ResultCacheStats result_cache;  // all zero unless SessionConfig enables the cache
+    StartupTiming startup;          // load() phases; not cleared by reset_stats()
+    ExecutionProvider provider = ExecutionProvider::Cpu;  // after any --provider fallback
+};
+
+class Classifier {
+public:
+    // Throws std::runtime_error when a file is missing or malformed
+    static std::unique_ptr<Classifier> load(const ModelBundle& bundle, const SessionConfig& config = {});
+    
+    virtual ~Classifier() = default;
+    Classifier(const Classifier&) = delete;
+    Classifier& operator=(const Classifier&) = delete;
+    
+    ModelType type() const { return type_; }
+    const std::vector<std::string>& labels() const { return labels_; }
+    
+    // Safe to call from several threads at once: the session is shared and
+    // scratch buffers are per thread
+    Prediction predict(std::string_view text);
+    std::vector<Prediction> predict_batch(const std::vector<std::string>& texts);
+    
+    ClassifierStats stats() const;
+    void reset_stats();
+    
+protected:
+    Classifier(ModelType type, std::vector<std::string> labels) : type_(type), labels_(std::move(labels)) {}
+    
+    // Write labels().size() scores per text into scores[i]
+    virtual void score(const std::vector<std::string_view>& texts, std::vector<std::vector<float>>& scores) = 0;
+    virtual ResultCacheStats result_cache_stats() const { return {}; }
+    virtual StartupTiming startup() const { return {}; }
+    virtual ExecutionProvider provider() const { return ExecutionProvider::Cpu; }
+    
+private:
+    std::vector<Prediction> run(const std::vector<std::string_view>& texts);
+    
+    ModelType type_;
+    std::vector<std::string> labels_;
+    mutable std::mutex stats_mutex_;
+    LatencyHistogram latency_;
+    uint64_t texts_ = 0;
+    double total_ms_ = 0.0;
+};
+
+}  // namespace whitelightning
@@ -0,0 +1,382 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "whitelightning/async_benchmark.hpp"
+#include "whitelightning/benchmark.hpp"
+#include "whitelightning/containers.hpp"
+#include "whitelightning/load_generator.hpp"
+#include "whitelightning/metrics.hpp"
+#include "whitelightning/model_variant.hpp"
+#include "whitelightning/session_config.hpp"
+#include "whitelightning/stream_io.hpp"
+#include "whitelightning/topology.hpp"
+#include "whitelightning/worker_pool.hpp"
+
+namespace whitelightning {
+
+// Benchmark and --stream loops shared by the model executables, written once
+// over a classifier with a nested Binding (IoBinding path) and AsyncRunner.
+// A classifier provides preprocess_into(text, Binding&),
+// preprocess_batch_into(texts, Binding&) and Binding::predicted_class(row).
+
+// Throughput of 1, 2, 4, ... max_workers workers sharing one session, each
+// request taking the next of texts. Efficiency is speedup / workers relative
+// to a single worker.
+template <typename ClassifierT>
+int run_scaling_benchmark(ClassifierT& classifier, int num_runs, int max_workers, const SessionConfig& config,
+                          const std::vector<std::string>& texts) {
+    using Binding = typename ClassifierT::Binding;
+    std::cout << "\n🧵 WORKER SCALING (" << num_runs << " texts, intra-op threads: "
+              << (config.intra_op_threads > 0 ? std::to_string(config.intra_op_threads) : "default")
+              << ", inter-op threads: "
+              << (config.inter_op_threads > 0 ? std::to_string(config.inter_op_threads) : "default") << ")\n";
+    std::cout << "============================================================\n";
+    
+    std::vector<int> worker_counts;
+    for (int count = 1; count < max_workers; count *= 2) {
+        worker_counts.push_back(count);
+    }
+    worker_counts.push_back(max_workers);
+    
+    try {
+        double single_worker_throughput = 0.0;
+        for (int num_workers : worker_counts) {
+            WorkerPool pool(num_workers, active_cpu_placement().cpus);
+            std::vector<std::unique_ptr<Binding>> bindings;
+            for (size_t i = 0; i < pool.size(); i++) {
+                bindings.push_back(std::make_unique<Binding>(classifier));
+            }
+            auto classify = [&](size_t index, size_t worker) {
+                auto& binding = *bindings[worker];
+                classifier.preprocess_into(texts[index % texts.size()], binding);
+                binding.run();
+            };
+            pool.run(pool.size(), classify);
+            
+            uint64_t steals_before = pool.steals();
+            double start = get_time_ms();
+            pool.run(num_runs, classify);
+            double elapsed = get_time_ms() - start;
+            
+            double throughput = num_runs * 1000.0 / elapsed;
+            if (num_workers == 1) {
+                single_worker_throughput = throughput;
+            }
+            double speedup = throughput / single_worker_throughput;
+            std::cout << "   Workers " << std::setw(3) << num_workers << ": " << std::fixed << std::setprecision(1)
+                      << std::setw(10) << throughput << " texts/sec, speedup " << std::setprecision(2) << speedup
+                      << "x, efficiency " << std::setprecision(1) << speedup * 100.0 / num_workers << "%, steals "
+                      << pool.steals() - steals_before << "\n";
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Benchmark error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// --load-sweep: throughput and p50/p99 over workers x batch size x load, each
+// worker vectorizing its micro-batch into its own Binding
+template <typename ClassifierT>
+int run_load_sweep_benchmark(ClassifierT& classifier, LoadSweepConfig config, const Corpus& corpus,
+                             const std::string& report_path, const std::string& model_name) {
+    using Binding = typename ClassifierT::Binding;
+    if (!classifier.supports_dynamic_batch() && config.batch_sizes != std::vector<int>{1}) {
+        std::cout << "⚠️ Model has a fixed batch dimension - sweeping batch size 1 only\n";
+        config.batch_sizes = {1};
+    }
+    
+    try {
+        std::vector<int> workers = load_sweep_workers(config);
+        std::vector<std::unique_ptr<Binding>> bindings;
+        std::vector<std::vector<std::string_view>> batch_texts(*std::max_element(workers.begin(), workers.end()));
+        for (size_t i = 0; i < batch_texts.size(); i++) {
+            bindings.push_back(std::make_unique<Binding>(classifier));
+        }
+        auto classify = [&](size_t worker, Span<const size_t> batch) {
+            std::vector<std::string_view>& texts = batch_texts[worker];
+            texts.clear();
+            for (size_t text : batch) texts.push_back(corpus.texts[text]);
+            auto& binding = *bindings[worker];
+            classifier.preprocess_batch_into(Span<const std::string_view>(texts.data(), texts.size()), binding);
+            binding.run();
+        };
+        LoadSweepResult result = run_load_sweep(config, corpus.texts.size(), classify);
+        print_load_sweep(result);
+        
+        if (!report_path.empty()) {
+            SystemInfo system_info;
+            get_system_info(system_info);
+            write_benchmark_report(report_path, load_sweep_report(model_name, corpus, result, system_info));
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Benchmark error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// --async-bench: throughput and latency over AsyncRunner in-flight depth
+// from one caller thread, against the single-text blocking Binding::run.
+// Load the classifier with SessionConfig::async.
+template <typename ClassifierT>
+int run_async_depth_benchmark(ClassifierT& classifier, const AsyncBenchConfig& config, const Corpus& corpus,
+                              const std::string& report_path, const std::string& model_name) {
+    using AsyncRunner = typename ClassifierT::AsyncRunner;
+    try {
+        auto& binding = classifier.binding();
+        auto blocking = [&](size_t text) {
+            classifier.preprocess_into(corpus.texts[text], binding);
+            binding.run();
+        };
+        auto make_runner = [&](int depth, Executor executor) -> AsyncSubmit {
+            auto runner = std::make_shared<AsyncRunner>(classifier, depth, std::move(executor));
+            return [runner, &corpus](size_t text, std::function<void()> done) {
+                return runner->try_submit(corpus.texts[text], [done = std::move(done)](const auto&, std::exception_ptr error) {
+                    if (error) std::rethrow_exception(error);
+                    done();
+                });
+            };
+        };
+        AsyncBenchResult result = run_async_benchmark(config, corpus.texts.size(), blocking, make_runner);
+        result.intra_op_threads = classifier.intra_op_threads();
+        print_async_benchmark(result);
+        
+        if (!report_path.empty()) {
+            SystemInfo system_info;
+            get_system_info(system_info);
+            write_benchmark_report(report_path, async_benchmark_report(model_name, corpus, result, system_info));
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Benchmark error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// Loads a classifier on a model file (a variant of the bundle) with config
+template <typename ClassifierT>
+using ClassifierLoader = std::function<std::unique_ptr<ClassifierT>(const std::string& model_path, const SessionConfig& config)>;
+
+// --sessions N: RSS of N extra sessions loaded from the file, then N more
+// from the shared mapping with prepacked weights. All of them stay alive
+// until both modes are measured.
+template <typename ClassifierT>
+std::vector<SessionMemoryResult> measure_session_sharing(const std::string& model_path,
+                                                        const ClassifierLoader<ClassifierT>& load,
+                                                        const SessionConfig& config, int sessions) {
+    SessionConfig file_config = config;
+    file_config.mmap_model = false;
+    file_config.result_cache_entries = 0;
+    file_config.result_cache_bytes = 0;
+    SessionConfig mapped_config = file_config;
+    mapped_config.mmap_model = true;
+    
+    std::vector<std::unique_ptr<ClassifierT>> held;
+    auto loader = [&](const SessionConfig& c) {
+        return [&, c] { return load(model_path, c); };
+    };
+    return {measure_session_memory("file", sessions, held, loader(file_config)),
+            measure_session_memory("mmap", sessions, held, loader(mapped_config))};
+}
+
+// Load one variant in a fresh session, time num_runs requests over texts
+// through the IoBinding path, then label every text once
+template <typename ClassifierT>
+VariantResult run_variant(ModelVariant variant, const std::string& model_path, const ClassifierLoader<ClassifierT>& load,
+                          const SessionConfig& config, int num_runs, const std::vector<std::string>& texts) {
+    VariantResult result;
+    result.name = model_variant_name(variant);
+    result.model_path = model_variant_path(model_path, variant);
+    std::cout << "🔄 " << result.name << ": " << result.model_path << " (" << num_runs << " runs)\n";
+    
+    double rss_start = get_memory_usage_mb();
+    double load_start = get_time_ms();
+    std::unique_ptr<ClassifierT> classifier = load(result.model_path, config);
+    result.load_ms = get_time_ms() - load_start;
+    result.load_rss_mb = get_memory_usage_mb() - rss_start;
+    
+    auto& binding = classifier->binding();
+    for (int i = 0; i < 5; i++) {
+        classifier->preprocess_into(texts[i % texts.size()], binding);
+        binding.run();
+    }
+    
+    double overall_start = get_time_ms();
+    for (int i = 0; i < num_runs; i++) {
+        double start = get_time_ms();
+        classifier->preprocess_into(texts[static_cast<size_t>(i) % texts.size()], binding);
+        binding.run();
+        result.latency.record_ms(get_time_ms() - start);
+    }
+    result.total_time_ms = get_time_ms() - overall_start;
+    result.run_rss_mb = get_memory_usage_mb() - rss_start;
+    
+    result.labels.reserve(texts.size());
+    for (const std::string& text : texts) {
+        classifier->preprocess_into(text, binding);
+        binding.run();
+        result.labels.push_back(binding.predicted_class(0));
+    }
+    return result;
+}
+
+// --compare-variants: model.onnx against model.int8.onnx on the same corpus,
+// one after the other in this process
+template <typename ClassifierT>
+int run_variant_comparison(const std::string& model_path, const ClassifierLoader<ClassifierT>& load,
+                           SessionConfig config, int num_runs, const Corpus& corpus,
+                           const std::vector<std::string>& label_names, const std::string& model_name,
+                           const std::string& report_path = "") {
+    std::cout << "\n⚖️ MODEL VARIANT COMPARISON (" << num_runs << " runs per variant)\n";
+    std::cout << "============================================================\n";
+    
+    std::string int8_path = model_variant_path(model_path, ModelVariant::Int8);
+    if (!std::ifstream(int8_path).good()) {
+        std::cerr << "❌ " << int8_path << " not found - export a quantized model next to " << model_path << "\n";
+        return 1;
+    }
+    
+    SystemInfo system_info;
+    get_system_info(system_info);
+    std::cout << "📚 Corpus: " << corpus.source << " (" << corpus.texts.size() << " texts)\n";
+    
+    // Every request has to reach the model
+    config.result_cache_entries = 0;
+    config.result_cache_bytes = 0;
+    
+    try {
+        VariantResult baseline = run_variant(ModelVariant::Fp32, model_path, load, config, num_runs, corpus.texts);
+        VariantResult candidate = run_variant(ModelVariant::Int8, model_path, load, config, num_runs, corpus.texts);
+        print_variant_comparison(baseline, candidate, corpus, label_names);
+        
+        if (!report_path.empty()) {
+            write_benchmark_report(report_path, variant_comparison_report(model_name, corpus, num_runs, baseline,
+                                                                          candidate, system_info));
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Comparison error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// One --stream line between the reader and the inference thread: the model
+// input it was preprocessed into, or its cached result
+template <typename Input, typename Result>
+struct StreamRecord {
+    uint64_t line = 0;
+    StreamInput input;
+    Input features;
+    uint64_t cache_key = 0;
+    bool cached = false;  // result came from the result cache
+    Result result{};
+};
+
+// --stream: newline-delimited text or JSONL on stdin, one JSON result per
+// line on stdout. A reader thread preprocesses record k+1 with
+// prepare(record) (on a result cache miss) while this thread runs
+// classifier.infer() on record k and emit(result, out) appends the JSON
+// members after "line" and "id". Slot buffers are sized by the caller.
+// Output is flushed whenever the ring runs dry, and both threads sleep
+// rather than spin while the other side is behind.
+template <typename ClassifierT, typename Input, typename Result, typename Prepare, typename Emit>
+int run_stream(ClassifierT& classifier, SpscRing<StreamRecord<Input, Result>>& ring, Prepare prepare, Emit emit) {
+    using Record = StreamRecord<Input, Result>;
+    std::cin.tie(nullptr);
+    std::atomic<bool> reader_failed{false};
+    std::thread reader([&]() {
+        std::string line;
+        uint64_t line_number = 0;
+        try {
+            while (std::getline(std::cin, line)) {
+                line_number++;
+                Record* slot = ring.wait_write_slot();
+                if (!parse_stream_line(line, slot->input)) continue;
+                slot->line = line_number;
+                slot->cached = false;
+                if (slot->input.error.empty()) {
+                    slot->cached = classifier.cache_lookup(slot->input.text, slot->cache_key, slot->result);
+                    if (!slot->cached) prepare(*slot);
+                }
+                ring.publish();
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "❌ Stream reader error: " << e.what() << std::endl;
+            reader_failed = true;
+        }
+        ring.close();
+    });
+    
+    OutputBuffer out(stdout);
+    uint64_t records = 0, errors = 0;
+    double cpu_start = get_process_cpu_seconds();
+    double start = get_time_ms();
+    while (true) {
+        Record* record = ring.read_slot();
+        if (record == nullptr) {
+            // Caught up with the reader: send what is buffered before sleeping
+            out.flush();
+            record = ring.wait_read_slot();
+            if (record == nullptr) break;
+        }
+        
+        out.append("{\"line\":");
+        out.append_number(record->line);
+        if (!record->input.id.empty()) {
+            out.append(",\"id\":");
+            out.append(record->input.id);
+        }
+        if (record->input.error.empty()) {
+            try {
+                if (!record->cached) {
+                    record->result = classifier.infer(record->features);
+                    classifier.cache_store(record->cache_key, record->result);
+                }
+                emit(record->result, out);
+            } catch (const std::exception& e) {
+                record->input.error = e.what();
+            }
+        }
+        if (!record->input.error.empty()) {
+            out.append(",\"error\":");
+            out.append_json_string(record->input.error);
+            errors++;
+        }
+        out.append('}');
+        out.end_record();
+        ring.release();
+        records++;
+    }
+    reader.join();
+    out.flush();
+    
+    double elapsed = get_time_ms() - start;
+    std::cerr << "📊 Streamed " << records << " records (" << errors << " errors) in " << std::fixed
+              << std::setprecision(2) << elapsed << "ms (" << std::setprecision(1)
+              << (elapsed > 0 ? records * 1000.0 / elapsed : 0.0) << " records/sec, " << std::setprecision(3)
+              << (records ? (get_process_cpu_seconds() - cpu_start) * 1000.0 / records : 0.0)
+              << " CPU-s per 1k, peak RSS " << std::setprecision(1) << get_peak_memory_mb() << " MB)\n";
+    if (classifier.has_result_cache()) {
+        ResultCacheStats cache = classifier.result_cache_stats();
+        std::cerr << "🗃️ Result cache: " << cache.hits << " hits, " << cache.misses << " misses ("
+                  << std::setprecision(1) << cache.hit_rate() * 100.0 << "%)\n";
+    }
+    // Per-record errors are reported inline; only a failed reader fails the run
+    return reader_failed ? 1 : 0;
+}
+
+}  // namespace whitelightning
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace whitelightning {
+
+// Open-addressing counter keyed by vocab index. clear() only resets the
+// slots that were used, so reusing it across texts costs O(distinct tokens)
+class IndexCounter {
+public:
+    struct Entry {
+        int32_t key;
+        int32_t count;
+    };
+    
+    IndexCounter() { rehash(64); }
+    
+    void add(int32_t key) {
+        if ((used_.size() + 1) * 2 > slots_.size()) {
+            rehash(slots_.size() * 2);
+        }
+        slots_[find_or_insert(key)].count++;
+    }
+    
+    void clear() {
+        for (uint32_t i : used_) slots_[i].key = kEmpty;
+        used_.clear();
+    }
+    
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (uint32_t i : used_) fn(slots_[i].key, slots_[i].count);
+    }
+    
+private:
+    static constexpr int32_t kEmpty = -1;
+    
+    size_t find_or_insert(int32_t key) {
+        size_t mask = slots_.size() - 1;
+        size_t i = (static_cast<uint32_t>(key) * 2654435761u) & mask;
+        while (slots_[i].key != kEmpty && slots_[i].key != key) {
+            i = (i + 1) & mask;
+        }
+        if (slots_[i].key == kEmpty) {
+            slots_[i] = {key, 0};
+            used_.push_back(static_cast<uint32_t>(i));
+        }
+        return i;
+    }
+    
+    // Capacity is a power of two and kept at least twice the distinct keys
+    void rehash(size_t capacity) {
+        std::vector<Entry> old;
+        old.swap(slots_);
+        slots_.assign(capacity, Entry{kEmpty, 0});
+        std::vector<uint32_t> old_used;
+        old_used.swap(used_);
+        used_.reserve(capacity / 2);
+        for (uint32_t i : old_used) {
+            slots_[find_or_insert(old[i].key)].count = old[i].count;
+        }
+    }
+    
+    std::vector<Entry> slots_;
+    std::vector<uint32_t> used_;
+};
+
+// Cache-line aligned storage for feature vectors and in-memory vocab images
+template <typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+    template <typename U> struct rebind { using other = AlignedAllocator<U, Alignment>; };
+    
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+    
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new[](n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* p, size_t) { ::operator delete[](p, std::align_val_t(Alignment)); }
+    
+    template <typename U> bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U> bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+using FeatureVector = std::vector<float, AlignedAllocator<float>>;
+
+// Minimal non-owning view over contiguous elements (std::span is C++20)
+template <typename T>
+class Span {
+public:
+    Span() = default;
+    Span(T* data, size_t size) : data_(data), size_(size) {}
+    template <typename Container>
+    Span(Container& container) : data_(container.data()), size_(container.size()) {}
+    
+    T* data() const { return data_; }
+    T* begin() const { return data_; }
+    T* end() const { return data_ + size_; }
+    T& operator[](size_t i) const { return data_[i]; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    Span subspan(size_t offset, size_t count) const {
+        offset = std::min(offset, size_);
+        return Span(data_ + offset, std::min(count, size_ - offset));
+    }
+    
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Bounded lock-free single-producer/single-consumer ring. Slots are
+// preallocated and filled in place, so steady-state streaming does not
+// allocate per record. The wait_* calls block on a condition variable that
+// publish/release/close only touch while a side is actually asleep.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+    
+    std::vector<T>& slots() { return slots_; }
+    
+    // Producer side: slot to fill, or nullptr while the ring is full
+    T* write_slot() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == slots_.size()) return nullptr;
+        return &slots_[head & mask_];
+    }
+    // write_slot(), sleeping while the ring is full
+    T* wait_write_slot() {
+        T* slot;
+        while ((slot = write_slot()) == nullptr) {
+            sleep_until([&] { return write_slot() != nullptr; });
+        }
+        return slot;
+    }
+    void publish() {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        wake();
+    }
+    void close() {
+        closed_.store(true, std::memory_order_release);
+        wake();
+    }
+    
+    // Consumer side: next filled slot, or nullptr while the ring is empty
+    T* read_slot() {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) return nullptr;
+        return &slots_[tail & mask_];
+    }
+    // read_slot(), sleeping while the ring is empty; nullptr once it is
+    // closed and drained
+    T* wait_read_slot() {
+        T* slot;
+        while ((slot = read_slot()) == nullptr) {
+            if (closed()) return read_slot();  // published before close()
+            sleep_until([&] { return read_slot() != nullptr || closed(); });
+        }
+        return slot;
+    }
+    void release() {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        wake();
+    }
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+    
+private:
+    // The fences pair the sleeper's sleepers_ increment with the waker's
+    // head_/tail_/closed_ store: either the waker sees a sleeper and
+    // notifies under the mutex, or the sleeper's predicate sees the store
+    template <typename Ready>
+    void sleep_until(Ready ready) {
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleepers_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        wakeup_.wait(lock, ready);
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    void wake() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) == 0) return;
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        wakeup_.notify_all();
+    }
+    
+    std::vector<T> slots_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+    std::atomic<bool> closed_{false};
+    std::atomic<int> sleepers_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable wakeup_;
+};
+
+}  // namespace whitelightning
@@ -0,0 +1,35 @@
+#pragma once
+
+// Everything the test executables share: monitoring, containers, tokenizers,
+// the compiled vocab, the three model classes, benchmark reporting and the
+// benchmark and --stream loops the model executables run.
+// Embedders only need whitelightning/classifier.hpp.
+
+#include "whitelightning/async.hpp"
+#include "whitelightning/async_benchmark.hpp"
+#include "whitelightning/benchmark.hpp"
+#include "whitelightning/binary_classifier.hpp"
+#include "whitelightning/classifier.hpp"
+#include "whitelightning/classifier_runners.hpp"
+#include "whitelightning/containers.hpp"
+#include "whitelightning/emotion_classifier.hpp"
+#include "whitelightning/execution_provider.hpp"
+#include "whitelightning/fanout.hpp"
+#include "whitelightning/labels.hpp"
+#include "whitelightning/latency_histogram.hpp"
+#include "whitelightning/load_generator.hpp"
+#include "whitelightning/mapped_model.hpp"
+#include "whitelightning/metrics.hpp"
+#include "whitelightning/pipeline.hpp"
+#include "whitelightning/model_cache.hpp"
+#include "whitelightning/model_variant.hpp"
+#include "whitelightning/result_cache.hpp"
+#include "whitelightning/server.hpp"
+#include "whitelightning/session_config.hpp"
+#include "whitelightning/stream_io.hpp"
+#include "whitelightning/tokenizer.hpp"
+#include "whitelightning/topic_classifier.hpp"
+#include "whitelightning/topology.hpp"
+#include "whitelightning/trace.hpp"
+#include "whitelightning/vocab_index.hpp"
+#include "whitelightning/worker_pool.hpp"
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <onnxruntime_cxx_api.h>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "whitelightning/containers.hpp"
+#include "whitelightning/execution_provider.hpp"
+#include "whitelightning/labels.hpp"
+#include "whitelightning/mapped_model.hpp"
+#include "whitelightning/metrics.hpp"
+#include "whitelightning/model_cache.hpp"
+#include "whitelightning/session_config.hpp"
+#include "whitelightning/tokenizer.hpp"
+#include "whitelightning/topology.hpp"
+#include "whitelightning/trace.hpp"
+#include "whitelightning/vocab_index.hpp"
+
+namespace whitelightning {
+
+// Long-lived multi-label classifier: vocab, IDF, labels and ONNX session are
+// loaded once and reused for every text. The model ends in a sigmoid, so each
+// output is an independent per-emotion probability and every emotion at or
+// above the threshold is reported.
+class EmotionClassifier {
+public:
+    EmotionClassifier(const std::string& model_path, const std::string& vocab_path, const std::string& scaler_path,
+                      const SessionConfig& config = {})
+        : env_(nullptr),
+          session_(nullptr),
+          memory_info_(Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault)) {
+        double env_start = get_time_ms();
+        env_ = Ort::Env(ORT_LOGGING_LEVEL_WARNING, "multiclass_sigmoid");
+        startup_.env_init_ms = get_time_ms() - env_start;
+        
+        // Prefer the precompiled vocab.bin; otherwise compile vocab.json in memory
+        double vocab_start = get_time_ms();
+        std::string compiled_path = VocabIndex::compiled_path(vocab_path);
+        if (VocabIndex::is_fresh(compiled_path, {vocab_path})) {
+            vocab_.open(compiled_path);
+            vocab_source_ = compiled_path + " (mmap)";
+        } else {
+            vocab_.adopt(VocabIndex::compile(vocab_path));
+            vocab_source_ = vocab_path + " (compiled in memory)";
+        }
+        idf_ = vocab_.array(VocabIndex::kTagIdf, &feature_count_);
+        if (idf_ == nullptr || feature_count_ < vocab_.size()) {
+            throw std::runtime_error("Vocab/IDF size mismatch: vocab has " + std::to_string(vocab_.size()) + " entries");
+        }
+        labels_ = load_labels(scaler_path);
+        double vocab_end = get_time_ms();
+        startup_.vocab_load_ms = vocab_end - vocab_start;
+        record_trace_span("vocab_load", vocab_start, vocab_end);
+        
+        auto configure = [&](Ort::SessionOptions& options) {
+            intra_op_threads_ = configure_intra_op_threads(options, config);
+            if (config.inter_op_threads > 0) {
+                // Inter-op threads are only used by the parallel executor
+                options.SetInterOpNumThreads(config.inter_op_threads);
+                options.SetExecutionMode(ExecutionMode::ORT_PARALLEL);
+            }
+            if (!config.profile_prefix.empty()) {
+                options.EnableProfiling(config.profile_prefix.c_str());
+                profiling_ = true;
+            }
+            options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        };
+        auto open = [&](Ort::SessionOptions& options, ExecutionProvider) {
+            if (config.mmap_model) {
+                return create_mapped_session(env_, model_path, options, false, model_mapping_);
+            }
+            return Ort::Session(env_, model_path.c_str(), options);
+        };
+        double session_start = get_time_ms();
+        session_ = create_session(config, session_options_, provider_, configure, open);
+        double session_end = get_time_ms();
+        startup_.session_load_ms = session_end - session_start;
+        record_trace_span("session_load", session_start, session_end);
+        
+        Ort::AllocatorWithDefaultOptions allocator;
+        input_name_ = session_.GetInputNameAllocated(0, allocator).get();
+        output_name_ = session_.GetOutputNameAllocated(0, allocator).get();
+        
+        auto input_shape = session_.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        if (input_shape.size() == 2 && input_shape[1] > 0 && static_cast<size_t>(input_shape[1]) != feature_count_) {
+            throw std::runtime_error("Model expects " + std::to_string(input_shape[1]) + " features, vocab has " +
+                                     std::to_string(feature_count_));
+        }
+        auto output_shape = session_.GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        if (output_shape.size() == 2 && output_shape[1] > 0 && static_cast<size_t>(output_shape[1]) != labels_.size()) {
+            throw std::runtime_error("Model has " + std::to_string(output_shape[1]) + " outputs, scaler.json has " +
+                                     std::to_string(labels_.size()) + " labels");
+        }
+        
+        // Pay the first Run's one-off setup here, not in the first prediction
+        FeatureVector warmup = preprocess("");
+        std::vector<float> probabilities(labels_.size());
+        double first_run_start = get_time_ms();
+        infer(warmup, probabilities.data());
+        double first_run_end = get_time_ms();
+        startup_.first_run_ms = first_run_end - first_run_start;
+        record_trace_span("first_run", first_run_start, first_run_end);
+    }
+    
+    size_t feature_count() const { return feature_count_; }
+    size_t num_classes() const { return labels_.size(); }
+    const std::string& vocab_source() const { return vocab_source_; }
+    const std::string& label(size_t i) const { return labels_[i]; }
+    const StartupTiming& startup() const { return startup_; }
+    // The provider the session runs on, after any fallback to cpu
+    ExecutionProvider provider() const { return provider_; }
+    // Size of the session's intra-op pool
+    int intra_op_threads() const { return intra_op_threads_; }
+    
+    // Stop ORT profiling (SessionConfig::profile_prefix) and return the
+    // profile for write_chrome_trace(); an empty path when it was not enabled
+    OrtProfile end_profiling(const std::string& label) {
+        OrtProfile profile{label, "", 0};
+        if (!profiling_) return profile;
+        Ort::AllocatorWithDefaultOptions allocator;
+        profile.start_ns = session_.GetProfilingStartTimeNs();
+        profile.path = session_.EndProfilingAllocated(allocator).get();
+        profiling_ = false;
+        return profile;
+    }
+    
+    FeatureVector preprocess(std::string_view text) const {
+        FeatureVector vector(feature_count_);
+        preprocess_into(text, vector.data());
+        return vector;
+    }
+    
+    // Write the L2-normalized TF-IDF vector (raw counts times IDF, as sklearn's
+    // TfidfVectorizer) into out[feature_count()]. Only the features present in
+    // the text are computed; the rest of the row is a plain zero fill.
+    void preprocess_into(std::string_view text, float* out) const {
+        preprocess_words_into(tokenize_words(text, tokenizer_scratch()), out);
+    }
+    
+    // preprocess_into() for the words tokenize_words() (or split_words())
+    // produced, e.g. once for several models in a FanOutClassifier
+    void preprocess_words_into(const std::vector<std::string_view>& words, float* out) const {
+        TraceSpan span("vectorize");
+        std::memset(out, 0, feature_count_ * sizeof(float));
+        
+        IndexCounter& counts = tokenizer_scratch().counts;
+        counts.clear();
+        for (std::string_view token : words) {
+            int32_t idx = find(token);
+            if (idx >= 0) {
+                counts.add(idx);
+            }
+        }
+        
+        double norm = 0.0;
+        counts.for_each([&](int32_t idx, int32_t count) {
+            float value = count * idf_[idx];
+            out[idx] = value;
+            norm += static_cast<double>(value) * value;
+        });
+        if (norm > 0.0) {
+            float inv_norm = static_cast<float>(1.0 / std::sqrt(norm));
+            counts.for_each([&](int32_t idx, int32_t) { out[idx] *= inv_norm; });
+        }
+    }
+    
+    // Token and OOV counts with the same tokenizer as preprocess_into
+    TokenStats token_stats(std::string_view text) const {
+        TokenStats stats;
+        for (std::string_view token : tokenize_words(text, tokenizer_scratch())) {
+            stats.tokens++;
+            stats.oov += find(token) < 0;
+        }
+        return stats;
+    }
+    
+    // Run the session on an already vectorized text and write num_classes()
+    // probabilities
+    void infer(FeatureVector& features, float* probabilities) {
+        std::vector<int64_t> input_shape = {1, static_cast<int64_t>(feature_count_)};
+        Ort::Value input_tensor{nullptr};
+        {
+            TraceSpan span("tensor_create");
+            input_tensor = Ort::Value::CreateTensor<float>(memory_info_, features.data(), feature_count_,
+                                                           input_shape.data(), input_shape.size());
+        }
+        
+        const char* input_names[] = {input_name_.c_str()};
+        const char* output_names[] = {output_name_.c_str()};
+        std::vector<Ort::Value> output_tensors;
+        {
+            TraceSpan span("run");
+            output_tensors = session_.Run(Ort::RunOptions{nullptr}, input_names, &input_tensor, 1, output_names, 1);
+        }
+        
+        const float* output_data = output_tensors[0].GetTensorMutableData<float>();
+        size_t count = output_tensors[0].GetTensorTypeAndShapeInfo().GetElementCount();
+        if (count < labels_.size()) {
+            throw std::runtime_error("Model returned " + std::to_string(count) + " outputs for " +
+                                     std::to_string(labels_.size()) + " labels");
+        }
+        std::copy(output_data, output_data + labels_.size(), probabilities);
+    }
+    
+    std::vector<float> predict(std::string_view text) {
+        auto features = preprocess(text);
+        std::vector<float> probabilities(labels_.size());
+        infer(features, probabilities.data());
+        return probabilities;
+    }
+    
+    // Input and output tensors allocated once and bound with Ort::IoBinding,
+    // so a steady-state Run allocates nothing on our side. Not thread-safe.
+    class Binding {
+    public:
+        explicit Binding(EmotionClassifier& classifier)
+            : classifier_(classifier),
+              binding_(classifier.session_),
+              input_(classifier.feature_count_),
+              output_(classifier.labels_.size()) {
+            TraceSpan span("tensor_create");
+            std::vector<int64_t> input_shape = {1, static_cast<int64_t>(input_.size())};
+            std::vector<int64_t> output_shape = {1, static_cast<int64_t>(output_.size())};
+            input_tensor_ = Ort::Value::CreateTensor<float>(classifier.memory_info_, input_.data(), input_.size(),
+                                                            input_shape.data(), input_shape.size());
+            output_tensor_ = Ort::Value::CreateTensor<float>(classifier.memory_info_, output_.data(), output_.size(),
+                                                             output_shape.data(), output_shape.size());
+            binding_.BindInput(classifier.input_name_.c_str(), input_tensor_);
+            binding_.BindOutput(classifier.output_name_.c_str(), output_tensor_);
+        }
+        
+        // [feature_count()] input buffer to vectorize into
+        float* input() { return input_.data(); }
+        
+        void run() {
+            TraceSpan span("run");
+            classifier_.session_.Run(run_options_, binding_);
+        }
+        
+        const float* probabilities() const { return output_.data(); }
+    
+    private:
+        EmotionClassifier& classifier_;
+        Ort::IoBinding binding_;
+        Ort::RunOptions run_options_;
+        FeatureVector input_;
+        std::vector<float> output_;
+        Ort::Value input_tensor_{nullptr};
+        Ort::Value output_tensor_{nullptr};
+    };
+    
+    // Binding for the calling (main) thread, created on first use
+    Binding& binding() {
+        if (!binding_) {
+            binding_ = std::make_unique<Binding>(*this);
+        }
+        return *binding_;
+    }
+
+private:
+    int32_t find(std::string_view token) const { return vocab_.find(token); }
+    
+    VocabIndex vocab_;
+    std::string vocab_source_;
+    const float* idf_ = nullptr;  // feature_count_ values in vocab_
+    size_t feature_count_ = 0;
+    std::vector<std::string> labels_;
+    StartupTiming startup_;
+    ExecutionProvider provider_ = ExecutionProvider::Cpu;
+    int intra_op_threads_ = 0;
+    bool profiling_ = false;
+    
+    Ort::Env env_;
+    Ort::SessionOptions session_options_;
+    std::shared_ptr<const MappedModel> model_mapping_;  // destroyed after session_
+    Ort::Session session_;
+    Ort::MemoryInfo memory_info_;
+    std::string input_name_;
+    std::string output_name_;
+    std::unique_ptr<Binding> binding_;
+};
+
+// Emotions at or above the threshold, strongest first
+std::vector<size_t> detected_emotions(const float* probabilities, size_t num_classes, float threshold);
+
+}  // namespace whitelightning
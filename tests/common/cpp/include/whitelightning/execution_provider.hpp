@@ -0,0 +1,65 @@
+#pragma once
+
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace Ort {
+struct Session;
+struct SessionOptions;
+}
+
+namespace whitelightning {
+
+struct SessionConfig;
+
+// ONNX Runtime execution providers a session can be placed on with
+// --provider. Every provider but cpu needs an ORT build that includes it.
+enum class ExecutionProvider { Cpu, Xnnpack, Cuda, CoreML, OpenVino };
+
+const ExecutionProvider kExecutionProviders[] = {
+    ExecutionProvider::Cpu, ExecutionProvider::Xnnpack, ExecutionProvider::Cuda,
+    ExecutionProvider::CoreML, ExecutionProvider::OpenVino
+};
+
+inline const char* execution_provider_name(ExecutionProvider provider) {
+    switch (provider) {
+        case ExecutionProvider::Xnnpack: return "xnnpack";
+        case ExecutionProvider::Cuda: return "cuda";
+        case ExecutionProvider::CoreML: return "coreml";
+        case ExecutionProvider::OpenVino: return "openvino";
+        default: return "cpu";
+    }
+}
+
+// --provider cpu|xnnpack|cuda|coreml|openvino
+inline bool parse_execution_provider(std::string_view name, ExecutionProvider& provider) {
+    for (ExecutionProvider candidate : kExecutionProviders) {
+        if (name == execution_provider_name(candidate)) {
+            provider = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// The providers above that the loaded ONNX Runtime was built with; cpu is
+// always first
+std::vector<ExecutionProvider> available_execution_providers();
+
+// Register config.provider on options ahead of the default CPU provider.
+// A provider missing from this ORT build, or one that fails to initialize
+// (no GPU, missing driver), falls back to cpu with a warning on stderr.
+// Returns the provider the session will actually use.
+ExecutionProvider append_execution_provider(Ort::SessionOptions& options, const SessionConfig& config);
+
+// Open a session on config.provider: options is reset, set up by configure
+// (threads, profiling, ...) and given the provider, then open creates the
+// session from it. Providers often fail only here, when the session looks
+// for its device, so a failing non-cpu session is retried once on fresh
+// CPU-only options with a warning. provider is set to the one in use.
+Ort::Session create_session(const SessionConfig& config, Ort::SessionOptions& options, ExecutionProvider& provider,
+                            const std::function<void(Ort::SessionOptions&)>& configure,
+                            const std::function<Ort::Session(Ort::SessionOptions&, ExecutionProvider)>& open);
+
+}  // namespace whitelightning
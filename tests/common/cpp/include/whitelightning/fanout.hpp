@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "whitelightning/binary_classifier.hpp"
+#include "whitelightning/emotion_classifier.hpp"
+#include "whitelightning/session_config.hpp"
+#include "whitelightning/topic_classifier.hpp"
+#include "whitelightning/worker_pool.hpp"
+
+namespace whitelightning {
+
+// Model directories (model.onnx, vocab.json, scaler.json) of a
+// FanOutClassifier; an empty directory leaves that model out
+struct FanOutModels {
+    std::string binary_dir;
+    std::string topic_dir;
+    std::string emotion_dir;
+};
+
+// Merged result of one text. Models left out keep empty scores.
+struct FanOutResult {
+    bool has_sentiment = false;
+    float sentiment = 0.0f;       // P(positive) from the binary model
+    std::vector<float> topic;     // softmax over topic_labels()
+    std::vector<float> emotions;  // independent sigmoid probabilities over emotion_labels()
+    
+    double tokenize_ms = 0.0;     // the shared lowercase + split
+    double binary_ms = 0.0;       // per model: vectorize + Run
+    double topic_ms = 0.0;
+    double emotion_ms = 0.0;
+};
+
+// Runs the sentiment, topic and emotion models on one text. The text is
+// lowercased once: the 30-slot topic token IDs come from its Keras tokens,
+// and the sklearn-style words the binary and emotion models share are split
+// from the same lowercased copy. Each model then vectorizes into its own
+// IoBinding and the sessions run concurrently on one WorkerPool, one worker
+// per model.
+//
+// classify() owns the bindings and the shared token buffers, so call it
+// from one thread at a time; the pool provides the parallelism.
+class FanOutClassifier {
+public:
+    // Throws std::runtime_error when a model file is missing or malformed
+    explicit FanOutClassifier(const FanOutModels& models, const SessionConfig& config = {});
+    
+    FanOutResult classify(std::string_view text);
+    
+    size_t model_count() const { return tasks_.size(); }
+    BinaryClassifier* binary() { return binary_.get(); }
+    TopicClassifier* topic() { return topic_.get(); }
+    EmotionClassifier* emotion() { return emotion_.get(); }
+    const std::vector<std::string>& topic_labels() const { return topic_labels_; }
+    const std::vector<std::string>& emotion_labels() const { return emotion_labels_; }
+    
+private:
+    std::unique_ptr<BinaryClassifier> binary_;
+    std::unique_ptr<BinaryClassifier::Binding> binary_binding_;
+    std::unique_ptr<TopicClassifier> topic_;
+    std::unique_ptr<TopicClassifier::Binding> topic_binding_;
+    std::vector<std::string> topic_labels_;
+    std::unique_ptr<EmotionClassifier> emotion_;
+    std::unique_ptr<EmotionClassifier::Binding> emotion_binding_;
+    std::vector<std::string> emotion_labels_;
+    
+    // The shared token stream of the text being classified
+    TokenizerScratch scratch_;
+    std::vector<std::string_view> words_;
+    
+    // One task per loaded model, writing its part of the result
+    std::vector<std::function<void(FanOutResult&)>> tasks_;
+    std::unique_ptr<WorkerPool> pool_;
+};
+
+}  // namespace whitelightning
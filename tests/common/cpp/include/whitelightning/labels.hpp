@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace whitelightning {
+
+// Class labels in model output order, from scaler.json: either
+// {"0": "Business", "1": "Sports", ...} or {"labels": ["Business", ...]}
+std::vector<std::string> load_labels(const std::string& scaler_path);
+
+// At least num_classes labels; ids scaler.json doesn't name are labeled with the id
+std::vector<std::string> load_labels(const std::string& scaler_path, size_t num_classes);
+
+}  // namespace whitelightning
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace whitelightning {
+
+// HDR-style latency histogram: nanosecond values keep their top 7 bits, so
+// every percentile is within 1/64 (~1.6%) of the true value at a fixed
+// ~60KB of counters regardless of how many samples are recorded.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 7;
+    static constexpr uint64_t kSubBuckets = uint64_t{1} << kSubBucketBits;
+    
+    LatencyHistogram() : counts_((64 - kSubBucketBits + 1) * kSubBuckets, 0) {}
+    
+    void record_ms(double ms) {
+        ms = std::max(ms, 0.0);
+        counts_[index(static_cast<uint64_t>(ms * 1e6))]++;
+        count_++;
+        sum_ += ms;
+        sum_squares_ += ms * ms;
+        min_ = count_ == 1 ? ms : std::min(min_, ms);
+        max_ = count_ == 1 ? ms : std::max(max_, ms);
+    }
+    
+    uint64_t count() const { return count_; }
+    double min_ms() const { return min_; }
+    double max_ms() const { return max_; }
+    double mean_ms() const { return count_ ? sum_ / count_ : 0.0; }
+    double stddev_ms() const {
+        if (count_ < 2) return 0.0;
+        double variance = (sum_squares_ - sum_ * sum_ / count_) / (count_ - 1);
+        return std::sqrt(std::max(variance, 0.0));
+    }
+    
+    // Upper edge of the bucket holding the p-th percentile sample (p in [0, 100])
+    double percentile_ms(double p) const {
+        if (count_ == 0) return 0.0;
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p / 100.0 * count_)));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); i++) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                return std::min(upper_ns(i) * 1e-6, max_);
+            }
+        }
+        return max_;
+    }
+    
+    // fn(lower_ms, upper_ms, count) for every non-empty bucket, in order
+    template <typename Fn>
+    void for_each_bucket(Fn fn) const {
+        for (size_t i = 0; i < counts_.size(); i++) {
+            if (counts_[i] != 0) {
+                fn(lower_ns(i) * 1e-6, upper_ns(i) * 1e-6, counts_[i]);
+            }
+        }
+    }
+    
+private:
+    // Values below kSubBuckets are exact; larger values are shifted right
+    // until only kSubBucketBits significant bits remain
+    static size_t index(uint64_t ns) {
+        int bits = 0;
+        while (bits < 64 && (ns >> bits) != 0) bits++;
+        int shift = std::max(0, bits - kSubBucketBits);
+        return static_cast<size_t>(shift) * kSubBuckets + static_cast<size_t>(ns >> shift);
+    }
+    static double lower_ns(size_t i) { return static_cast<double>((i % kSubBuckets) << (i / kSubBuckets)); }
+    static double upper_ns(size_t i) { return static_cast<double>((i % kSubBuckets + 1) << (i / kSubBuckets)); }
+    
+    std::vector<uint64_t> counts_;
+    uint64_t count_ = 0;
+    double sum_ = 0.0;
+    double sum_squares_ = 0.0;
+    double min_ = 0.0;
+    double max_ = 0.0;
+};
+
+}  // namespace whitelightning
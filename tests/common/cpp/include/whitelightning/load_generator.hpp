@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "whitelightning/benchmark.hpp"
+#include "whitelightning/containers.hpp"
+#include "whitelightning/latency_histogram.hpp"
+
+namespace whitelightning {
+
+// --load-sweep: drive the classifier like a service would, from a request
+// queue served by a WorkerPool that takes up to batch_size queued requests
+// per Run, and record the throughput/latency curve over
+// workers x batch size x load. Load is closed-loop (N clients, each with one
+// request in flight) or, with qps set, open-loop Poisson arrivals, whose
+// latency counts from the scheduled arrival so a backlog is not hidden.
+struct LoadSweepConfig {
+    std::vector<int> workers;  // empty: 1, 2, 4, ... up to the pinned or online CPUs
+    std::vector<int> batch_sizes = {1, 8, 32};
+    std::vector<int> concurrency = {1, 4, 16, 64};
+    std::vector<int> qps;   // non-empty: open loop at each rate instead of concurrency
+    int requests = 2000;    // per point
+    uint64_t seed = 42;     // Poisson arrivals
+    
+    bool open_loop() const { return !qps.empty(); }
+};
+
+struct LoadPoint {
+    int workers = 0;
+    int batch_size = 0;
+    int load = 0;              // clients (closed loop) or target QPS (open loop)
+    size_t requests = 0;
+    double seconds = 0;
+    double throughput = 0;     // completed requests/sec
+    double mean_batch = 0;     // requests per Run actually formed
+    double cpu_percent = 0;    // process CPU time over wall time, of the --pin CPUs or all cores
+    LatencyHistogram latency;  // arrival to completion
+};
+
+struct LoadSweepResult {
+    bool open_loop = false;
+    int requests = 0;
+    std::vector<LoadPoint> points;
+    // Index into points for each workers x batch series: the lowest load
+    // reaching 95% of the series' peak throughput (closed loop) or the
+    // highest rate still served at 95% of target (open loop)
+    std::vector<size_t> saturation;
+};
+
+// Classify the corpus texts at these indices as one batch on pool worker
+// `worker`, e.g. into that worker's Binding
+using LoadHandler = std::function<void(size_t worker, Span<const size_t> texts)>;
+
+// config.workers, or its default when empty
+std::vector<int> load_sweep_workers(const LoadSweepConfig& config);
+
+// Request k is text k % num_texts. handler is called with at most
+// max(config.batch_sizes) texts and worker < max(load_sweep_workers(config)).
+LoadSweepResult run_load_sweep(const LoadSweepConfig& config, size_t num_texts, const LoadHandler& handler);
+
+void print_load_sweep(const LoadSweepResult& result);
+json load_sweep_report(const std::string& name, const Corpus& corpus, const LoadSweepResult& result,
+                       const SystemInfo& system_info);
+
+// --sweep-workers 1,2,4 and friends: comma-separated positive integers
+bool parse_count_list(std::string_view text, std::vector<int>& values);
+
+}  // namespace whitelightning
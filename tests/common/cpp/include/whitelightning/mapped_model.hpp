@@ -0,0 +1,112 @@
+#pragma once
+
+#include <onnxruntime_cxx_api.h>
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__APPLE__) || defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace whitelightning {
+
+// Read-only mapping of a model file (--mmap-model). The pages are backed by
+// the page cache, so every session and process that maps the same file
+// shares one physical copy instead of reading it into private heap.
+class MappedModel {
+public:
+    explicit MappedModel(const std::string& path) {
+#if defined(__APPLE__) || defined(__linux__)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open model file: " + path);
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            throw std::runtime_error("Failed to stat model file: " + path);
+        }
+        void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            throw std::runtime_error("Failed to mmap model file: " + path);
+        }
+        data_ = addr;
+        size_ = static_cast<size_t>(st.st_size);
+#else
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) {
+            throw std::runtime_error("Failed to open model file: " + path);
+        }
+        owned_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data_ = owned_.data();
+        size_ = owned_.size();
+#endif
+    }
+    
+    ~MappedModel() {
+#if defined(__APPLE__) || defined(__linux__)
+        munmap(data_, size_);
+#endif
+    }
+    
+    MappedModel(const MappedModel&) = delete;
+    MappedModel& operator=(const MappedModel&) = delete;
+    
+    const void* data() const { return data_; }
+    size_t size() const { return size_; }
+    
+    // One mapping per path while any session still holds it
+    static std::shared_ptr<const MappedModel> open(const std::string& path) {
+        static std::mutex mutex;
+        static std::unordered_map<std::string, std::weak_ptr<const MappedModel>> mappings;
+        std::lock_guard<std::mutex> lock(mutex);
+        std::shared_ptr<const MappedModel> mapping = mappings[path].lock();
+        if (!mapping) {
+            mapping = std::make_shared<const MappedModel>(path);
+            mappings[path] = mapping;
+        }
+        return mapping;
+    }
+    
+private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+    std::vector<char> owned_;
+};
+
+// Prepacked MatMul/Gemm weights of every mapped session in the process.
+// ORT keys entries by weight contents, so sessions of the same model reuse
+// one packed copy; it is never destroyed, so it outlives every session.
+inline Ort::PrepackedWeightsContainer& shared_prepacked_weights() {
+    static Ort::PrepackedWeightsContainer* container = new Ort::PrepackedWeightsContainer();
+    return *container;
+}
+
+// Create a session from the shared mapping of path. An ORT-format graph
+// (--model-cache) is used in place: initializers point into the mapping,
+// which `mapping` then keeps alive for the session. A .onnx protobuf is
+// parsed out of the mapping, so its initializers are still copied and the
+// mapping is released once the session exists.
+inline Ort::Session create_mapped_session(const Ort::Env& env, const std::string& path, Ort::SessionOptions& options,
+                                          bool ort_format, std::shared_ptr<const MappedModel>& mapping) {
+    std::shared_ptr<const MappedModel> model = MappedModel::open(path);
+    if (ort_format) {
+        options.AddConfigEntry("session.use_ort_model_bytes_directly", "1");
+        options.AddConfigEntry("session.use_ort_model_bytes_for_initializers", "1");
+        mapping = model;
+    }
+    return Ort::Session(env, model->data(), model->size(), options, shared_prepacked_weights());
+}
+
+}  // namespace whitelightning
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "whitelightning/result_cache.hpp"
+
+namespace whitelightning {
+
+// One-off costs a classifier pays in its constructor, before the first
+// steady-state Run
+struct StartupTiming {
+    double env_init_ms = 0;      // Ort::Env: logging and global runtime state
+    double vocab_load_ms = 0;    // vocab.bin mmap or in-memory compile, scaler, labels
+    double session_load_ms = 0;  // graph load and optimization (Ort::Session)
+    double first_run_ms = 0;     // warmup Run: arena growth, kernel and shape setup
+    
+    double total_ms() const { return env_init_ms + vocab_load_ms + session_load_ms + first_run_ms; }
+};
+
+// Performance and system monitoring structures
+struct TimingMetrics {
+    double total_time_ms = 0;
+    double preprocessing_time_ms = 0;
+    double inference_time_ms = 0;
+    double postprocessing_time_ms = 0;
+    double throughput_per_sec = 0;
+    StartupTiming startup;  // printed as a separate STARTUP section when set
+};
+
+struct ResourceMetrics {
+    double memory_start_mb = 0;
+    double memory_end_mb = 0;
+    double memory_delta_mb = 0;
+    double memory_peak_mb = 0;
+    double cpu_seconds = 0;      // process user + system time while monitored
+    double wall_seconds = 0;
+    double cpu_avg_percent = 0;  // of all cores
+    double cpu_max_percent = 0;
+    int cpu_readings_count = 0;
+    std::vector<double> cpu_readings;
+};
+
+struct SystemInfo {
+    std::string platform;
+    std::string processor;
+    int cpu_count_physical = 0;
+    int cpu_count_logical = 0;
+    int cpu_packages = 1;
+    int numa_nodes = 1;
+    double total_memory_gb = 0;
+    std::string runtime = "C++ Implementation";
+};
+
+// Global CPU monitoring: samples process CPU time every interval_ms
+// (--cpu-interval) until the atomic stop flag is cleared
+struct CPUMonitor {
+    std::atomic<bool> monitoring{false};
+    int interval_ms = 100;
+    double cpu_start_seconds = 0;
+    double wall_start_seconds = 0;
+    std::vector<double> cpu_readings;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread monitor_thread;
+};
+
+extern CPUMonitor g_cpu_monitor;
+
+// Utility functions
+double get_time_ms();
+double get_memory_usage_mb();
+// Peak resident set size of the process so far
+double get_peak_memory_mb();
+// User + system CPU time consumed by this process, in seconds
+double get_process_cpu_seconds();
+int get_online_cpu_count();
+// CPUs this run may use: the --pin placement's, else every online CPU.
+// CPU percentages are relative to this count.
+int get_usable_cpu_count();
+void get_system_info(SystemInfo& info);
+void start_cpu_monitoring();
+void stop_cpu_monitoring(ResourceMetrics& metrics);
+void print_system_info(const SystemInfo& info);
+// Steady-state phases and rating; timing.startup is reported on its own and
+// never counts towards the total. cache adds a RESULT CACHE section when the
+// run used one
+void print_performance_summary(const TimingMetrics& timing, const ResourceMetrics& resources,
+                               const ResultCacheStats* cache = nullptr);
+void print_startup_timing(const StartupTiming& startup);
+void print_result_cache_stats(const ResultCacheStats& cache);
+
+}  // namespace whitelightning
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <onnxruntime_cxx_api.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "whitelightning/execution_provider.hpp"
+
+namespace whitelightning {
+
+// Opt-in cache of the fully optimized graph in ORT format, stored next to
+// the model as <model>.<content hash>.ort-<ORT version>[.<provider>].ort so
+// a changed model, runtime or execution provider never picks up a stale
+// graph. A cold start runs the optimizer and saves its output; warm starts
+// load the saved graph and skip graph optimization entirely.
+class OptimizedModelCache {
+public:
+    explicit OptimizedModelCache(const std::string& model_path, ExecutionProvider provider = ExecutionProvider::Cpu)
+        : model_path_(model_path) {
+        char key[17];
+        std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash_file(model_path)));
+        std::string stem = model_path.substr(0, model_path.rfind(".onnx"));
+        // Graphs optimized for another provider may hold its fused kernels
+        std::string suffix = provider == ExecutionProvider::Cpu ? "" : std::string(".") + execution_provider_name(provider);
+        path_ = stem + "." + key + ".ort-" + ort_version() + suffix + ".ort";
+        std::ifstream cached(path_, std::ios::binary);
+        warm_ = cached.good() && cached.peek() != std::ifstream::traits_type::eof();
+    }
+    
+    const std::string& path() const { return path_; }
+    bool warm() const { return warm_; }
+    
+    // Set up options for this start and return the path the session should load
+    std::string configure(Ort::SessionOptions& options) {
+        if (warm_) {
+            // The saved graph is already optimized
+            options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_DISABLE_ALL);
+            options.AddConfigEntry("session.load_model_format", "ORT");
+            return path_;
+        }
+        // Write to a private temp file so concurrently starting processes
+        // never load a half-written graph; commit() moves it into place
+        temp_path_ = path_ + ".tmp" + std::to_string(getpid());
+        options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        options.SetOptimizedModelFilePath(temp_path_.c_str());
+        options.AddConfigEntry("session.save_model_format", "ORT");
+        return model_path_;
+    }
+    
+    // Call once the session is created; publishes the graph saved on a cold start
+    void commit() {
+        if (!warm_ && !temp_path_.empty() && std::rename(temp_path_.c_str(), path_.c_str()) != 0) {
+            std::remove(temp_path_.c_str());
+            throw std::runtime_error("Failed to save optimized model: " + path_);
+        }
+    }
+    
+    static std::string ort_version() { return OrtGetApiBase()->GetVersionString(); }
+    
+    // FNV-1a over 8-byte words of the file contents
+    static uint64_t hash_file(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open model file: " + path);
+        }
+        uint64_t h = 1469598103934665603ULL;
+        std::vector<char> buffer(1 << 16);
+        while (file) {
+            file.read(buffer.data(), buffer.size());
+            size_t length = static_cast<size_t>(file.gcount());
+            size_t i = 0;
+            for (; i + 8 <= length; i += 8) {
+                uint64_t word;
+                std::memcpy(&word, buffer.data() + i, 8);
+                h = (h ^ word) * 1099511628211ULL;
+            }
+            for (; i < length; i++) {
+                h = (h ^ static_cast<unsigned char>(buffer[i])) * 1099511628211ULL;
+            }
+        }
+        return h;
+    }
+    
+private:
+    std::string model_path_;
+    std::string path_;
+    std::string temp_path_;
+    bool warm_ = false;
+};
+
+}  // namespace whitelightning
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace whitelightning {
+
+// Exported graphs a model directory may hold: model.onnx and its dynamically
+// quantized model.int8.onnx
+enum class ModelVariant { Fp32, Int8 };
+
+inline const char* model_variant_name(ModelVariant variant) {
+    return variant == ModelVariant::Int8 ? "int8" : "fp32";
+}
+
+// --model-variant fp32|int8
+inline bool parse_model_variant(std::string_view name, ModelVariant& variant) {
+    if (name == "fp32") {
+        variant = ModelVariant::Fp32;
+    } else if (name == "int8") {
+        variant = ModelVariant::Int8;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// model.onnx -> model.int8.onnx; the fp32 path is returned unchanged
+inline std::string model_variant_path(const std::string& model_path, ModelVariant variant) {
+    if (variant == ModelVariant::Fp32) return model_path;
+    size_t extension = model_path.rfind(".onnx");
+    std::string stem = extension == std::string::npos ? model_path : model_path.substr(0, extension);
+    return stem + "." + model_variant_name(variant) + ".onnx";
+}
+
+}  // namespace whitelightning
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "whitelightning/binary_classifier.hpp"
+#include "whitelightning/classifier.hpp"
+#include "whitelightning/emotion_classifier.hpp"
+#include "whitelightning/tokenizer.hpp"
+#include "whitelightning/topic_classifier.hpp"
+#include "whitelightning/trace.hpp"
+
+namespace whitelightning {
+
+// How a model turns tokens into its input tensor
+enum class FeatureKind {
+    ScaledTfidf,      // binary: TF-IDF over sklearn words, standardized
+    NormalizedTfidf,  // multi-label: sklearn words, L2-normalized TF-IDF
+    TokenIds          // multiclass: token IDs zero-padded to a fixed length
+};
+
+// How the output row becomes a label
+enum class OutputKind {
+    Probability,  // one P(positive), label 1 above 0.5
+    Argmax,       // softmax row, highest class
+    Threshold     // independent sigmoids, every class at or above a threshold
+};
+
+// Compile-time description of one model bundle's pipeline
+template <FeatureKind Features, typename Input, size_t MaxSequenceLength, OutputKind Output>
+struct PipelineConfig {
+    static constexpr FeatureKind features = Features;
+    using input_type = Input;
+    static constexpr size_t max_sequence_length = MaxSequenceLength;
+    static constexpr OutputKind output = Output;
+    
+    static_assert((Features == FeatureKind::TokenIds) == std::is_same_v<Input, int32_t>,
+                  "token-ID models take int32 input, TF-IDF models float");
+    static_assert((Features == FeatureKind::TokenIds) == (MaxSequenceLength > 0),
+                  "only token-ID models have a sequence length");
+};
+
+// The model class and constexpr pipeline config of each ModelType
+template <ModelType Type> struct ModelPipeline;
+
+template <> struct ModelPipeline<ModelType::Binary> {
+    using Model = BinaryClassifier;
+    using Config = PipelineConfig<FeatureKind::ScaledTfidf, float, 0, OutputKind::Probability>;
+};
+
+template <> struct ModelPipeline<ModelType::Multiclass> {
+    using Model = TopicClassifier;
+    using Config = PipelineConfig<FeatureKind::TokenIds, int32_t, TopicClassifier::kMaxSequenceLength, OutputKind::Argmax>;
+};
+
+template <> struct ModelPipeline<ModelType::MultiLabel> {
+    using Model = EmotionClassifier;
+    using Config = PipelineConfig<FeatureKind::NormalizedTfidf, float, 0, OutputKind::Threshold>;
+};
+
+// One text's label without a scores vector. For Threshold models `detected`
+// has bit i set for every class at or above the threshold.
+struct PipelineResult {
+    size_t label = 0;
+    float confidence = 0.0f;
+    uint64_t detected = 0;
+};
+
+// Tokenize, vectorize, Run and postprocess one text with every model-kind
+// decision made at compile time: the tensors are bound once at their final
+// shape ({1, features} or {1, max_sequence_length}), the input is written
+// straight into them and postprocessing is the one inlined loop the config
+// selects. No virtual calls, result vectors or shape checks per text.
+//
+// Owns one IoBinding, so use one Pipeline per thread; the model is shared.
+template <ModelType Type>
+class Pipeline {
+public:
+    using Model = typename ModelPipeline<Type>::Model;
+    using Config = typename ModelPipeline<Type>::Config;
+    
+    static constexpr size_t kMaxDetected = 64;
+    
+    explicit Pipeline(Model& model, float threshold = 0.5f)
+        : model_(model), binding_(model), threshold_(threshold) {
+        if constexpr (Config::features == FeatureKind::TokenIds) {
+            input_ = binding_.input(1, Config::max_sequence_length);
+            num_classes_ = model.num_classes();
+        } else if constexpr (Config::features == FeatureKind::NormalizedTfidf) {
+            input_ = binding_.input();
+            num_classes_ = model.num_classes();
+        } else {
+            input_ = binding_.input(1);
+            num_classes_ = 2;
+        }
+        if constexpr (Config::output == OutputKind::Threshold) {
+            if (num_classes_ > kMaxDetected) {
+                throw std::runtime_error("Pipeline supports up to " + std::to_string(kMaxDetected) + " labels, model has " +
+                                         std::to_string(num_classes_));
+            }
+        }
+    }
+    
+    size_t num_classes() const { return num_classes_; }
+    
+    PipelineResult predict(std::string_view text) {
+        TokenizerScratch& scratch = tokenizer_scratch();
+        if constexpr (Config::features == FeatureKind::TokenIds) {
+            model_.template write_fixed_ids<Config::max_sequence_length>(tokenize(text, scratch), input_);
+        } else {
+            model_.preprocess_words_into(tokenize_words(text, scratch), input_);
+        }
+        binding_.run();
+        return postprocess();
+    }
+    
+private:
+    PipelineResult postprocess() const {
+        TraceSpan span("postprocess");
+        PipelineResult result;
+        if constexpr (Config::output == OutputKind::Probability) {
+            float p = binding_.probability(0);
+            result.label = p > 0.5f;
+            result.confidence = result.label ? p : 1.0f - p;
+        } else {
+            const float* p;
+            if constexpr (Config::output == OutputKind::Argmax) {
+                p = binding_.probabilities(0);
+            } else {
+                p = binding_.probabilities();
+            }
+            float best = p[0];
+            for (size_t i = 1; i < num_classes_; i++) {
+                if (p[i] > best) {
+                    best = p[i];
+                    result.label = i;
+                }
+            }
+            result.confidence = best;
+            if constexpr (Config::output == OutputKind::Threshold) {
+                for (size_t i = 0; i < num_classes_; i++) {
+                    result.detected |= static_cast<uint64_t>(p[i] >= threshold_) << i;
+                }
+            }
+        }
+        return result;
+    }
+    
+    Model& model_;
+    typename Model::Binding binding_;
+    typename Config::input_type* input_ = nullptr;
+    size_t num_classes_ = 0;
+    float threshold_;
+};
+
+using BinaryPipeline = Pipeline<ModelType::Binary>;
+using TopicPipeline = Pipeline<ModelType::Multiclass>;
+using EmotionPipeline = Pipeline<ModelType::MultiLabel>;
+
+}  // namespace whitelightning
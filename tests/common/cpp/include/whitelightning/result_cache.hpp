@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace whitelightning {
+
+// Counters summed over all shards of a ResultCache
+struct ResultCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+    
+    double hit_rate() const { return hits + misses ? static_cast<double>(hits) / (hits + misses) : 0.0; }
+};
+
+// Heap bytes a cached value owns beyond its own size
+inline size_t cache_payload_bytes(float) { return 0; }
+inline size_t cache_payload_bytes(const std::vector<float>& value) { return value.capacity() * sizeof(float); }
+
+// LRU map from a 64-bit text hash (normalized_text_hash) to a model result,
+// split into independently locked shards so worker threads rarely contend.
+// Either limit may be zero (unbounded); each shard gets 1/kShards of both.
+template <typename Value>
+class ResultCache {
+public:
+    static constexpr int kShardBits = 4;
+    static constexpr size_t kShards = size_t{1} << kShardBits;
+    
+    ResultCache(size_t max_entries, size_t max_bytes)
+        : max_entries_(max_entries ? std::max<size_t>(1, (max_entries + kShards - 1) / kShards) : 0),
+          max_bytes_(max_bytes ? std::max<size_t>(1, (max_bytes + kShards - 1) / kShards) : 0) {}
+    
+    // Copy the cached value for key into value and mark it most recently used
+    bool lookup(uint64_t key, Value& value) {
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            shard.misses++;
+            return false;
+        }
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        value = it->second->value;
+        shard.hits++;
+        return true;
+    }
+    
+    void insert(uint64_t key, const Value& value) {
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            // Another thread computed the same text first
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            return;
+        }
+        size_t bytes = kEntryOverhead + cache_payload_bytes(value);
+        if (max_bytes_ && bytes > max_bytes_) return;
+        while (!shard.lru.empty() && ((max_entries_ && shard.lru.size() >= max_entries_) ||
+                                      (max_bytes_ && shard.bytes + bytes > max_bytes_))) {
+            shard.bytes -= shard.lru.back().bytes;
+            shard.index.erase(shard.lru.back().key);
+            shard.lru.pop_back();
+            shard.evictions++;
+        }
+        shard.lru.push_front(Entry{key, value, bytes});
+        shard.index.emplace(key, shard.lru.begin());
+        shard.bytes += bytes;
+    }
+    
+    ResultCacheStats stats() const {
+        ResultCacheStats stats;
+        for (const Shard& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            stats.hits += shard.hits;
+            stats.misses += shard.misses;
+            stats.evictions += shard.evictions;
+            stats.entries += shard.lru.size();
+            stats.bytes += shard.bytes;
+        }
+        return stats;
+    }
+    
+private:
+    struct Entry {
+        uint64_t key;
+        Value value;
+        size_t bytes;
+    };
+    
+    // List node, hash node and bucket pointer per entry, approximately
+    static constexpr size_t kEntryOverhead = sizeof(Entry) + 6 * sizeof(void*) + sizeof(uint64_t);
+    
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> lru;
+        std::unordered_map<uint64_t, typename std::list<Entry>::iterator> index;
+        size_t bytes = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+    };
+    
+    // The top bits pick the shard; the hash map uses the low bits
+    Shard& shard_for(uint64_t key) { return shards_[key >> (64 - kShardBits)]; }
+    
+    size_t max_entries_;
+    size_t max_bytes_;
+    std::array<Shard, kShards> shards_;
+};
+
+}  // namespace whitelightning
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "whitelightning/containers.hpp"
+
+namespace whitelightning {
+
+// --serve: where to listen and how far the micro-batcher may go
+struct ServerConfig {
+    std::string unix_path;             // --listen-unix PATH
+    std::string tcp_host = "127.0.0.1";
+    int tcp_port = 0;                  // --listen-tcp [HOST:]PORT; 0 disables TCP
+    double slo_ms = 5.0;               // --slo-ms: p99 target for queueing + batch inference
+    size_t max_batch = 32;             // --batch: upper bound of the adaptive batch size
+    int stats_interval_s = 10;         // --stats-interval: seconds between stderr reports, 0 for none
+};
+
+// Scores one micro-batch on the batching thread: results[i] receives the JSON
+// members for texts[i] without braces, e.g. "label":"Positive","probability":0.9
+using BatchHandler = std::function<void(Span<const std::string_view> texts, std::vector<std::string>& results)>;
+
+// Serve until SIGINT or SIGTERM. Every frame in either direction is a 4-byte
+// big-endian payload length followed by the payload. A request payload is a
+// --stream line (plain text or {"id": ..., "text": ...}); the response is one
+// JSON object with the handler's members, "id" if given and "latency_ms".
+// Responses on a connection come back in request order, so clients may
+// pipeline. {"op":"stats"} is answered immediately with live server stats.
+// Replies go out on a writer thread per connection, so a client that stops
+// reading only stalls itself; it is dropped once 16 MiB of replies are queued
+// or a send blocks for a second.
+int run_server(const ServerConfig& config, const BatchHandler& handler);
+
+}  // namespace whitelightning
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "whitelightning/execution_provider.hpp"
+
+namespace whitelightning {
+
+// Session configuration shared by every classifier.
+// Zero thread counts keep the ONNX Runtime defaults.
+struct SessionConfig {
+    int intra_op_threads = 0;
+    int inter_op_threads = 0;
+    bool model_cache = false;  // --model-cache: reuse the ORT-optimized graph
+    bool mmap_model = false;   // --mmap-model: shared model mapping and prepacked weights
+    ExecutionProvider provider = ExecutionProvider::Cpu;  // --provider, falls back to cpu
+    // --cache-entries / --cache-bytes: ResultCache limits; both zero disables it
+    size_t result_cache_entries = 0;
+    size_t result_cache_bytes = 0;
+    // --trace: ORT operator profiling (EnableProfiling) into files with this
+    // prefix; empty disables it
+    std::string profile_prefix;
+    // --pin: logical CPUs ORT's intra-op threads are placed on; empty leaves
+    // them to the OS scheduler
+    std::vector<int> pinned_cpus;
+    // AsyncRunner use: RunAsync needs an intra-op pool of at least 2 threads,
+    // so the pool is raised to 2 whatever the other settings give
+    bool async = false;
+};
+
+}  // namespace whitelightning
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace whitelightning {
+
+// Accumulates output in one large buffer and hands it to stdio in big
+// writes instead of one std::cout call per field.
+class OutputBuffer {
+public:
+    explicit OutputBuffer(FILE* file, size_t flush_bytes = 1 << 16) : file_(file), flush_bytes_(flush_bytes) {
+        buffer_.reserve(flush_bytes_ + 4096);
+    }
+    ~OutputBuffer() { flush(); }
+    
+    void append(std::string_view s) { buffer_.append(s.data(), s.size()); }
+    void append(char c) { buffer_.push_back(c); }
+    void append_number(double value, int precision) {
+        char number[32];
+        int length = std::snprintf(number, sizeof(number), "%.*f", precision, value);
+        buffer_.append(number, length);
+    }
+    void append_number(uint64_t value) {
+        char number[24];
+        int length = std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(value));
+        buffer_.append(number, length);
+    }
+    
+    // Append s as a quoted, escaped JSON string
+    void append_json_string(std::string_view s) {
+        static const char* hex = "0123456789abcdef";
+        buffer_.push_back('"');
+        for (char c : s) {
+            switch (c) {
+                case '"': buffer_.append("\\\""); break;
+                case '\\': buffer_.append("\\\\"); break;
+                case '\n': buffer_.append("\\n"); break;
+                case '\r': buffer_.append("\\r"); break;
+                case '\t': buffer_.append("\\t"); break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        buffer_.append("\\u00");
+                        buffer_.push_back(hex[(c >> 4) & 0xF]);
+                        buffer_.push_back(hex[c & 0xF]);
+                    } else {
+                        buffer_.push_back(c);
+                    }
+            }
+        }
+        buffer_.push_back('"');
+    }
+    
+    // Call after each complete record; writes once the buffer is large enough
+    void end_record() {
+        buffer_.push_back('\n');
+        if (buffer_.size() >= flush_bytes_) flush();
+    }
+    
+    void flush() {
+        if (!buffer_.empty()) {
+            std::fwrite(buffer_.data(), 1, buffer_.size(), file_);
+            buffer_.clear();
+        }
+        std::fflush(file_);
+    }
+    
+private:
+    FILE* file_;
+    size_t flush_bytes_;
+    std::string buffer_;
+};
+
+// One line of --stream input. A line starting with '{' is parsed as JSONL
+// ({"text": ..., "id": ...}); anything else is the text itself.
+struct StreamInput {
+    std::string id;     // "id" re-serialized as JSON, empty if absent
+    std::string text;
+    std::string error;
+};
+
+bool parse_stream_line(const std::string& line, StreamInput& input);
+
+}  // namespace whitelightning
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "whitelightning/containers.hpp"
+
+namespace whitelightning {
+
+// Per-thread tokenizer scratch: the lowercased copy of the text, the token
+// views into it and the index counter keep their capacity between calls, so
+// once warmed up tokenizing a text does not touch the heap
+struct TokenizerScratch {
+    std::string lowered;
+    std::vector<std::string_view> tokens;
+    IndexCounter counts;
+};
+
+TokenizerScratch& tokenizer_scratch();
+
+// Python's str.lower() of UTF-8 text into out. ASCII runs are lowercased
+// 32 bytes at a time (AVX2, SSE2 or NEON); chunks with bytes >= 0x80 are
+// decoded and mapped through the Unicode tables in src/unicode_tables.inc.
+void lowercase(std::string_view text, std::string& out);
+
+// Keras Tokenizer's text_to_word_sequence, as used to build the multiclass
+// vocab.json: lowercase text into scratch.lowered, drop the default filters
+// (!"#$%&()*+,-./:;<=>?@[\]^_`{|}~, tab and newline; apostrophes stay) and
+// split on spaces into views
+const std::vector<std::string_view>& tokenize(std::string_view text, TokenizerScratch& scratch);
+
+// 64-bit hash of the text lowercased (ASCII) with runs of ' ', '\t' and
+// '\n' collapsed, computed in one pass without tokenizing. Both tokenizers
+// give equal tokens for equal keys, so texts that differ only in case or
+// spacing share a result cache key.
+uint64_t normalized_text_hash(std::string_view text);
+
+// sklearn's TfidfVectorizer tokenization, as used to build the binary and
+// multi-label vocab.json: lowercase text into scratch.lowered and keep the
+// runs of two or more \w code points (default token_pattern \b\w\w+\b,
+// Unicode-aware like Python's re)
+const std::vector<std::string_view>& tokenize_words(std::string_view text, TokenizerScratch& scratch);
+
+// The tokenize_words() split of text that is already lowercased, e.g.
+// scratch.lowered after tokenize(), so one lowercase pass serves both
+// tokenizers; words view lowered
+void split_words(std::string_view lowered, std::vector<std::string_view>& words);
+
+// SIMD kernel the tokenizers use on this CPU: "avx2", "sse2", "neon" or "scalar"
+const char* tokenizer_kernel();
+
+// Token and out-of-vocabulary counts of one text, for benchmark breakdowns
+struct TokenStats {
+    size_t tokens = 0;
+    size_t oov = 0;
+};
+
+// Real tokens versus sequence positions fed to the model; the rest is padding
+struct PaddingStats {
+    uint64_t tokens = 0;
+    uint64_t positions = 0;
+    
+    void add(size_t text_tokens, size_t sequence_length) {
+        tokens += std::min(text_tokens, sequence_length);
+        positions += sequence_length;
+    }
+    // Share of positions that are padding
+    double ratio() const { return positions ? 1.0 - static_cast<double>(tokens) / positions : 0.0; }
+};
+
+}  // namespace whitelightning
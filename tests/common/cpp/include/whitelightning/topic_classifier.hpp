@@ -0,0 +1,729 @@
+#pragma once
+
+#include <onnxruntime_cxx_api.h>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "whitelightning/async.hpp"
+#include "whitelightning/containers.hpp"
+#include "whitelightning/execution_provider.hpp"
+#include "whitelightning/mapped_model.hpp"
+#include "whitelightning/metrics.hpp"
+#include "whitelightning/model_cache.hpp"
+#include "whitelightning/result_cache.hpp"
+#include "whitelightning/session_config.hpp"
+#include "whitelightning/tokenizer.hpp"
+#include "whitelightning/topology.hpp"
+#include "whitelightning/trace.hpp"
+#include "whitelightning/vocab_index.hpp"
+
+namespace whitelightning {
+
+// Long-lived classifier: tokenizer and ONNX session are loaded once and
+// reused for every text, so predict() only pays tokenization and Run.
+class TopicClassifier {
+public:
+    static constexpr size_t kMaxSequenceLength = 30;
+    // Padded lengths for single texts when the sequence dimension is dynamic:
+    // few distinct shapes keep ORT's per-shape memory plans warm
+    static constexpr size_t kSequenceBuckets[] = {8, 16, kMaxSequenceLength};
+    
+    TopicClassifier(const std::string& model_path, const std::string& tokenizer_path,
+                    const SessionConfig& config = {})
+        : env_(nullptr),
+          session_(nullptr),
+          memory_info_(Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault)) {
+        double env_start = get_time_ms();
+        env_ = Ort::Env(ORT_LOGGING_LEVEL_WARNING, "topic_classifier");
+        startup_.env_init_ms = get_time_ms() - env_start;
+        
+        // Prefer the precompiled vocab.bin; otherwise compile vocab.json in memory
+        double vocab_start = get_time_ms();
+        std::string compiled_path = VocabIndex::compiled_path(tokenizer_path);
+        if (VocabIndex::is_fresh(compiled_path, {tokenizer_path})) {
+            tokenizer_.open(compiled_path);
+            vocab_source_ = compiled_path + " (mmap)";
+        } else {
+            tokenizer_.adopt(VocabIndex::compile(tokenizer_path));
+            vocab_source_ = tokenizer_path + " (compiled in memory)";
+        }
+        oov_id_ = tokenizer_.oov_id();
+        double vocab_end = get_time_ms();
+        startup_.vocab_load_ms = vocab_end - vocab_start;
+        record_trace_span("vocab_load", vocab_start, vocab_end);
+        
+        // One session is shared by every worker thread (Run is thread-safe)
+        auto configure = [&](Ort::SessionOptions& options) {
+            intra_op_threads_ = configure_intra_op_threads(options, config);
+            if (config.inter_op_threads > 0) {
+                // Inter-op threads are only used by the parallel executor
+                options.SetInterOpNumThreads(config.inter_op_threads);
+                options.SetExecutionMode(ExecutionMode::ORT_PARALLEL);
+            }
+            if (!config.profile_prefix.empty()) {
+                options.EnableProfiling(config.profile_prefix.c_str());
+                profiling_ = true;
+            }
+        };
+        std::unique_ptr<OptimizedModelCache> model_cache;
+        auto open = [&](Ort::SessionOptions& options, ExecutionProvider provider) {
+            // The optimized graph is cached per provider
+            std::string session_model_path = model_path;
+            model_cache.reset();
+            if (config.model_cache) {
+                model_cache = std::make_unique<OptimizedModelCache>(model_path, provider);
+                session_model_path = model_cache->configure(options);
+            }
+            if (config.mmap_model) {
+                bool ort_format = model_cache && model_cache->warm();
+                return create_mapped_session(env_, session_model_path, options, ort_format, model_mapping_);
+            }
+            return Ort::Session(env_, session_model_path.c_str(), options);
+        };
+        double session_start = get_time_ms();
+        session_ = create_session(config, session_options_, provider_, configure, open);
+        double session_end = get_time_ms();
+        startup_.session_load_ms = session_end - session_start;
+        record_trace_span("session_load", session_start, session_end);
+        if (model_cache) {
+            model_cache->commit();
+            session_source_ = (model_cache->warm() ? "warm, loaded " : "cold, optimized and saved ") + model_cache->path();
+        } else {
+            session_source_ = model_path;
+        }
+        if (config.mmap_model) {
+            session_source_ += model_mapping_ ? " (mmap, in place)" : " (mmap)";
+        }
+        
+        if (config.result_cache_entries > 0 || config.result_cache_bytes > 0) {
+            result_cache_ = std::make_unique<ResultCache<std::vector<float>>>(config.result_cache_entries,
+                                                                              config.result_cache_bytes);
+        }
+        
+        // Dynamic input/output detection
+        Ort::AllocatorWithDefaultOptions allocator;
+        input_name_ = session_.GetInputNameAllocated(0, allocator).get();
+        output_name_ = session_.GetOutputNameAllocated(0, allocator).get();
+        auto input_shape = session_.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        dynamic_batch_ = !input_shape.empty() && input_shape[0] < 0;
+        dynamic_sequence_ = input_shape.size() >= 2 && input_shape[1] < 0;
+        
+        // The first Run pays one-off setup here, not in the first prediction
+        std::vector<int32_t> probe(kMaxSequenceLength, 0);
+        double first_run_start = get_time_ms();
+        size_t probe_classes = infer(probe).size();
+        double first_run_end = get_time_ms();
+        startup_.first_run_ms = first_run_end - first_run_start;
+        record_trace_span("first_run", first_run_start, first_run_end);
+        
+        // Output row shape for preallocated output buffers
+        output_shape_ = session_.GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        if (std::any_of(output_shape_.begin() + std::min<size_t>(1, output_shape_.size()), output_shape_.end(),
+                        [](int64_t dim) { return dim < 0; })) {
+            // Dynamic class dimension: take it from the warmup run
+            output_shape_ = {-1, static_cast<int64_t>(probe_classes)};
+        }
+        num_classes_ = 1;
+        for (size_t i = 1; i < output_shape_.size(); i++) {
+            num_classes_ *= static_cast<size_t>(output_shape_[i]);
+        }
+    }
+    
+    const std::string& vocab_source() const { return vocab_source_; }
+    const std::string& session_source() const { return session_source_; }
+    const StartupTiming& startup() const { return startup_; }
+    // The provider the session runs on, after any fallback to cpu
+    ExecutionProvider provider() const { return provider_; }
+    // Size of the session's intra-op pool
+    int intra_op_threads() const { return intra_op_threads_; }
+    
+    // Stop ORT profiling (SessionConfig::profile_prefix) and return the
+    // profile for write_chrome_trace(); an empty path when it was not enabled
+    OrtProfile end_profiling(const std::string& label) {
+        OrtProfile profile{label, "", 0};
+        if (!profiling_) return profile;
+        Ort::AllocatorWithDefaultOptions allocator;
+        profile.start_ns = session_.GetProfilingStartTimeNs();
+        profile.path = session_.EndProfilingAllocated(allocator).get();
+        profiling_ = false;
+        return profile;
+    }
+    bool supports_dynamic_batch() const { return dynamic_batch_; }
+    bool supports_dynamic_sequence() const { return dynamic_sequence_; }
+    size_t num_classes() const { return num_classes_; }
+    
+    // Sequence length a text of `tokens` words is padded to on its own: the
+    // smallest bucket that holds it, or always 30 for a fixed-length model
+    size_t padded_length(size_t tokens) const {
+        if (dynamic_sequence_) {
+            for (size_t bucket : kSequenceBuckets) {
+                if (tokens <= bucket) return bucket;
+            }
+        }
+        return kMaxSequenceLength;
+    }
+    
+    // Sequence length shared by a batch whose longest text has `tokens` words
+    size_t batch_length(size_t tokens) const {
+        return dynamic_sequence_ ? std::clamp<size_t>(tokens, 1, kMaxSequenceLength) : kMaxSequenceLength;
+    }
+    
+    // Lowercase, tokenize and map the first 30 words to token IDs, padded to
+    // padded_length()
+    std::vector<int32_t> preprocess(std::string_view text) const {
+        std::vector<int32_t> vector(kMaxSequenceLength);
+        vector.resize(preprocess_into(text, vector.data(), kPadToText));
+        return vector;
+    }
+    
+    static constexpr size_t kPadToText = 0;
+    
+    // Write the token IDs zero-padded to sequence_length (kPadToText: the
+    // padded_length() of this text) into out and return the length written
+    size_t preprocess_into(std::string_view text, int32_t* out, size_t sequence_length = kMaxSequenceLength) const {
+        return preprocess_tokens_into(tokenize(text, tokenizer_scratch()), out, sequence_length);
+    }
+    
+    // preprocess_into() for the tokens tokenize() produced, e.g. once for
+    // several models in a FanOutClassifier
+    size_t preprocess_tokens_into(const std::vector<std::string_view>& tokens, int32_t* out,
+                                  size_t sequence_length = kMaxSequenceLength) const {
+        if (sequence_length == kPadToText) {
+            sequence_length = padded_length(tokens.size());
+        }
+        return write_ids(tokens, out, sequence_length);
+    }
+    
+    // Token and OOV counts with the same tokenizer as preprocess_into
+    TokenStats token_stats(std::string_view text) const {
+        TokenStats stats;
+        for (std::string_view token : tokenize(text, tokenizer_scratch())) {
+            stats.tokens++;
+            stats.oov += tokenizer_.find(token) < 0;
+        }
+        return stats;
+    }
+    
+    // Original tokenizer (std::string copy per word), kept as the baseline
+    // for --alloc-bench
+    void preprocess_legacy(std::string_view text, int32_t* out) const {
+        std::string text_lower(text);
+        std::transform(text_lower.begin(), text_lower.end(), text_lower.begin(), ::tolower);
+        
+        std::vector<std::string> words;
+        size_t start = 0, end;
+        while ((end = text_lower.find(' ', start)) != std::string::npos) {
+            if (end > start) {
+                words.push_back(text_lower.substr(start, end - start));
+            }
+            start = end + 1;
+        }
+        if (start < text_lower.length()) {
+            words.push_back(text_lower.substr(start));
+        }
+        
+        std::fill(out, out + kMaxSequenceLength, 0);
+        for (size_t i = 0; i < std::min(words.size(), kMaxSequenceLength); i++) {
+            int32_t id = tokenizer_.find(words[i]);
+            out[i] = id >= 0 ? id : oov_id_;
+        }
+    }
+    
+    // Run the session on an already tokenized text and return class probabilities
+    std::vector<float> infer(std::vector<int32_t>& tokens) {
+        std::vector<std::vector<float>> probabilities;
+        infer_batch(tokens.data(), 1, tokens.size(), probabilities);
+        return std::move(probabilities[0]);
+    }
+    
+    // Run n tokenized rows (row-major [n, sequence_length]) as one batch and
+    // append one probability vector per row. Models with a fixed batch
+    // dimension are run row by row.
+    void infer_batch(int32_t* tokens, size_t n, size_t sequence_length, std::vector<std::vector<float>>& out) {
+        if (!dynamic_batch_ && n > 1) {
+            for (size_t i = 0; i < n; i++) {
+                infer_batch(tokens + i * sequence_length, 1, sequence_length, out);
+            }
+            return;
+        }
+        
+        std::vector<int64_t> input_shape = {static_cast<int64_t>(n), static_cast<int64_t>(sequence_length)};
+        Ort::Value input_tensor{nullptr};
+        {
+            TraceSpan span("tensor_create");
+            input_tensor = Ort::Value::CreateTensor<int32_t>(memory_info_, tokens, n * sequence_length,
+                                                             input_shape.data(), input_shape.size());
+        }
+        
+        const char* input_names[] = {input_name_.c_str()};
+        const char* output_names[] = {output_name_.c_str()};
+        
+        std::vector<Ort::Value> output_tensors;
+        {
+            TraceSpan span("run");
+            output_tensors = session_.Run(Ort::RunOptions{nullptr}, input_names, &input_tensor, 1, output_names, 1);
+        }
+        
+        // Scatter row i of the [n, classes] output back to text i
+        const float* output_data = output_tensors[0].GetTensorMutableData<float>();
+        size_t num_classes = output_tensors[0].GetTensorTypeAndShapeInfo().GetElementCount() / n;
+        for (size_t i = 0; i < n; i++) {
+            out.emplace_back(output_data + i * num_classes, output_data + (i + 1) * num_classes);
+        }
+    }
+    
+    // Result cache: texts with the same normalized_text_hash() skip
+    // tokenization and Run. Without a cache lookups miss and stores are no-ops.
+    bool has_result_cache() const { return result_cache_ != nullptr; }
+    ResultCacheStats result_cache_stats() const { return result_cache_ ? result_cache_->stats() : ResultCacheStats{}; }
+    
+    // Cached probabilities of text; key is set for a later cache_store() either way
+    bool cache_lookup(std::string_view text, uint64_t& key, std::vector<float>& probabilities) {
+        if (!result_cache_) return false;
+        key = normalized_text_hash(text);
+        return result_cache_->lookup(key, probabilities);
+    }
+    void cache_store(uint64_t key, const std::vector<float>& probabilities) {
+        if (result_cache_) result_cache_->insert(key, probabilities);
+    }
+    
+    std::vector<float> predict(std::string_view text) {
+        uint64_t key = 0;
+        std::vector<float> probabilities;
+        if (cache_lookup(text, key, probabilities)) return probabilities;
+        auto tokens = preprocess(text);
+        probabilities = infer(tokens);
+        cache_store(key, probabilities);
+        return probabilities;
+    }
+    
+    // Tokenize texts into one contiguous [N, L] buffer and issue a single Run.
+    // L is the longest text in the batch when the sequence dimension is
+    // dynamic, 30 otherwise.
+    std::vector<std::vector<float>> predict_batch(Span<const std::string_view> texts, PaddingStats* padding = nullptr) {
+        return cached_batch(texts, [&](Span<const std::string_view> batch) {
+            return predict_batch_uncached(batch, padding);
+        });
+    }
+    
+    // predict_batch() without the result cache, so every row reaches the model
+    std::vector<std::vector<float>> predict_batch_uncached(Span<const std::string_view> texts,
+                                                           PaddingStats* padding = nullptr) {
+        const TokenizedTexts& tokenized = tokenize_batch(texts);
+        thread_local std::vector<size_t> rows;
+        rows.resize(texts.size());
+        for (size_t i = 0; i < rows.size(); i++) rows[i] = i;
+        std::vector<std::vector<float>> probabilities;
+        probabilities.reserve(texts.size());
+        run_padded(tokenized, rows, probabilities, padding);
+        return probabilities;
+    }
+    
+    // Group texts by length bucket (8/16/30 tokens) and run each bucket in
+    // batches of up to max_batch, so short texts are not padded to the
+    // longest text in the queue. Results come back in input order.
+    std::vector<std::vector<float>> predict_bucketed(Span<const std::string_view> texts, size_t max_batch,
+                                                     PaddingStats* padding = nullptr) {
+        return cached_batch(texts, [&](Span<const std::string_view> batch) {
+            return predict_bucketed_uncached(batch, max_batch, padding);
+        });
+    }
+    
+    // predict_bucketed() without the result cache
+    std::vector<std::vector<float>> predict_bucketed_uncached(Span<const std::string_view> texts, size_t max_batch,
+                                                              PaddingStats* padding = nullptr) {
+        const TokenizedTexts& tokenized = tokenize_batch(texts);
+        std::vector<size_t> order[std::size(kSequenceBuckets)];
+        for (size_t i = 0; i < texts.size(); i++) {
+            size_t bucket = 0;
+            while (bucket + 1 < std::size(kSequenceBuckets) && tokenized.lengths[i] > kSequenceBuckets[bucket]) bucket++;
+            order[bucket].push_back(i);
+        }
+        
+        std::vector<std::vector<float>> probabilities(texts.size());
+        std::vector<std::vector<float>> batch_probabilities;
+        for (const auto& indices : order) {
+            for (size_t offset = 0; offset < indices.size(); offset += max_batch) {
+                size_t count = std::min(max_batch, indices.size() - offset);
+                batch_probabilities.clear();
+                run_padded(tokenized, Span<const size_t>(indices.data() + offset, count), batch_probabilities, padding);
+                for (size_t k = 0; k < count; k++) {
+                    probabilities[indices[offset + k]] = std::move(batch_probabilities[k]);
+                }
+            }
+        }
+        return probabilities;
+    }
+    
+    // Input and output tensors allocated once and bound with Ort::IoBinding,
+    // so a steady-state Run allocates nothing on our side. Tensors are
+    // rebound only when the row count changes. Not thread-safe: one per worker.
+    class Binding {
+    public:
+        explicit Binding(TopicClassifier& classifier)
+            : classifier_(classifier), binding_(classifier.session_) {}
+        
+        // Row-major [rows, sequence_length] input buffer to tokenize into
+        int32_t* input(size_t rows, size_t sequence_length = kMaxSequenceLength) {
+            if (rows != rows_ || sequence_length != sequence_length_) {
+                bind(rows, sequence_length);
+            }
+            return input_.data();
+        }
+        
+        size_t sequence_length() const { return sequence_length_; }
+        
+        // Run on the rows of the last input() call
+        void run() {
+            TraceSpan span("run");
+            classifier_.session_.Run(run_options_, binding_);
+        }
+        
+        // num_classes() probabilities for one row
+        const float* probabilities(size_t row) const { return output_.data() + row * classifier_.num_classes_; }
+        size_t num_classes() const { return classifier_.num_classes_; }
+        // Highest-probability class (ties keep the lower index)
+        int predicted_class(size_t row) const {
+            const float* row_probabilities = probabilities(row);
+            return static_cast<int>(std::max_element(row_probabilities, row_probabilities + num_classes()) -
+                                    row_probabilities);
+        }
+        
+    private:
+        void bind(size_t rows, size_t sequence_length) {
+            if (rows > 1 && !classifier_.dynamic_batch_) {
+                throw std::runtime_error("Model has a fixed batch dimension");
+            }
+            if (sequence_length != kMaxSequenceLength && !classifier_.dynamic_sequence_) {
+                throw std::runtime_error("Model has a fixed sequence length");
+            }
+            // Buffers only grow and are sized for the longest sequence, so
+            // alternating batch sizes and lengths don't reallocate
+            if (input_.size() < rows * kMaxSequenceLength) {
+                input_.resize(rows * kMaxSequenceLength);
+                output_.resize(rows * classifier_.num_classes_);
+            }
+            
+            TraceSpan span("tensor_create");
+            std::vector<int64_t> input_shape = {static_cast<int64_t>(rows), static_cast<int64_t>(sequence_length)};
+            std::vector<int64_t> output_shape = classifier_.output_shape_;
+            output_shape[0] = static_cast<int64_t>(rows);
+            input_tensor_ = Ort::Value::CreateTensor<int32_t>(classifier_.memory_info_, input_.data(),
+                                                              rows * sequence_length,
+                                                              input_shape.data(), input_shape.size());
+            output_tensor_ = Ort::Value::CreateTensor<float>(classifier_.memory_info_, output_.data(),
+                                                             rows * classifier_.num_classes_,
+                                                             output_shape.data(), output_shape.size());
+            binding_.ClearBoundInputs();
+            binding_.ClearBoundOutputs();
+            binding_.BindInput(classifier_.input_name_.c_str(), input_tensor_);
+            binding_.BindOutput(classifier_.output_name_.c_str(), output_tensor_);
+            rows_ = rows;
+            sequence_length_ = sequence_length;
+        }
+        
+        TopicClassifier& classifier_;
+        Ort::IoBinding binding_;
+        Ort::RunOptions run_options_;
+        std::vector<int32_t> input_;
+        std::vector<float> output_;
+        Ort::Value input_tensor_{nullptr};
+        Ort::Value output_tensor_{nullptr};
+        size_t rows_ = 0;
+        size_t sequence_length_ = 0;
+    };
+    
+    // Non-blocking predict on Ort::Session::RunAsync, so one I/O thread can
+    // keep up to max_in_flight texts in flight. submit() tokenizes on the
+    // calling thread into a preallocated kMaxSequenceLength slot and returns
+    // once the Run is queued on the session's intra-op pool; the callback is
+    // delivered through executor. RunAsync needs at least two intra-op
+    // threads, so load the classifier with SessionConfig::async; the
+    // constructor throws otherwise. The result cache is bypassed. Submit from
+    // one thread at a time.
+    class AsyncRunner {
+    public:
+        // error is set, and probabilities empty, when the Run failed
+        using Callback = std::function<void(std::vector<float> probabilities, std::exception_ptr error)>;
+        
+        AsyncRunner(TopicClassifier& classifier, size_t max_in_flight, Executor executor = inline_executor())
+            : classifier_(classifier), executor_(std::move(executor)), slots_(std::max<size_t>(1, max_in_flight)),
+              requests_(slots_.capacity()) {
+            if (classifier_.intra_op_threads_ < 2) {
+                throw std::runtime_error("AsyncRunner needs an intra-op pool of at least 2 threads (intra-op threads: " +
+                                         std::to_string(classifier_.intra_op_threads_) +
+                                         "); load the classifier with SessionConfig::async");
+            }
+            std::vector<int64_t> input_shape = {1, static_cast<int64_t>(kMaxSequenceLength)};
+            std::vector<int64_t> output_shape = classifier_.output_shape_;
+            output_shape[0] = 1;
+            for (size_t i = 0; i < requests_.size(); i++) {
+                Request& request = requests_[i];
+                request.runner = this;
+                request.slot = i;
+                request.input.resize(kMaxSequenceLength);
+                request.output.resize(classifier_.num_classes_);
+                request.input_tensor = Ort::Value::CreateTensor<int32_t>(classifier_.memory_info_, request.input.data(),
+                                                                         kMaxSequenceLength, input_shape.data(),
+                                                                         input_shape.size());
+                request.output_tensor = Ort::Value::CreateTensor<float>(classifier_.memory_info_, request.output.data(),
+                                                                        request.output.size(), output_shape.data(),
+                                                                        output_shape.size());
+            }
+        }
+        
+        // Waits for the runs still in flight
+        ~AsyncRunner() { slots_.wait_idle(); }
+        
+        AsyncRunner(const AsyncRunner&) = delete;
+        AsyncRunner& operator=(const AsyncRunner&) = delete;
+        
+        // Blocks only while max_in_flight runs are pending
+        void submit(std::string_view text, Callback done) {
+            start(slots_.acquire(), text, std::move(done));
+        }
+        
+        // submit() unless every slot is in flight
+        bool try_submit(std::string_view text, Callback done) {
+            size_t slot;
+            if (!slots_.try_acquire(slot)) return false;
+            start(slot, text, std::move(done));
+            return true;
+        }
+        
+        std::future<std::vector<float>> predict(std::string_view text) {
+            auto promise = std::make_shared<std::promise<std::vector<float>>>();
+            std::future<std::vector<float>> result = promise->get_future();
+            submit(text, [promise](std::vector<float> probabilities, std::exception_ptr error) {
+                if (error) {
+                    promise->set_exception(error);
+                } else {
+                    promise->set_value(std::move(probabilities));
+                }
+            });
+            return result;
+        }
+        
+        size_t in_flight() const { return slots_.in_flight(); }
+        size_t capacity() const { return slots_.capacity(); }
+        void wait() { slots_.wait_idle(); }
+        
+    private:
+        struct Request {
+            AsyncRunner* runner = nullptr;
+            size_t slot = 0;
+            std::vector<int32_t> input;
+            std::vector<float> output;
+            Ort::Value input_tensor{nullptr};
+            Ort::Value output_tensor{nullptr};
+            Callback done;
+            double start_ms = 0;
+        };
+        
+        void start(size_t slot, std::string_view text, Callback done) {
+            Request& request = requests_[slot];
+            try {
+                classifier_.preprocess_into(text, request.input.data(), kMaxSequenceLength);
+                request.done = std::move(done);
+                request.start_ms = get_time_ms();
+                const char* input_name = classifier_.input_name_.c_str();
+                const char* output_name = classifier_.output_name_.c_str();
+                classifier_.session_.RunAsync(run_options_, &input_name, &request.input_tensor, 1, &output_name,
+                                              &request.output_tensor, 1, &AsyncRunner::on_complete, &request);
+            } catch (...) {
+                request.done = nullptr;
+                slots_.cancel(slot);
+                throw;
+            }
+        }
+        
+        // On an ORT intra-op thread. The probabilities are copied out and the
+        // slot is free again before the callback is handed to the executor.
+        static void on_complete(void* user_data, OrtValue**, size_t, OrtStatusPtr status_ptr) {
+            Request& request = *static_cast<Request*>(user_data);
+            AsyncRunner& runner = *request.runner;
+            Ort::Status status(status_ptr);
+            record_trace_span("run", request.start_ms, get_time_ms());
+            std::vector<float> probabilities;
+            std::exception_ptr error;
+            if (status.IsOK()) {
+                probabilities = request.output;
+            } else {
+                error = std::make_exception_ptr(std::runtime_error("RunAsync failed: " + status.GetErrorMessage()));
+            }
+            Callback done = std::move(request.done);
+            runner.slots_.release(request.slot);
+            try {
+                runner.executor_([done = std::move(done), probabilities = std::move(probabilities), error]() mutable {
+                    done(std::move(probabilities), error);
+                });
+            } catch (const std::exception& e) {
+                std::cerr << "❌ Async completion error: " << e.what() << std::endl;
+            }
+            runner.slots_.finish();
+        }
+        
+        TopicClassifier& classifier_;
+        Executor executor_;
+        Ort::RunOptions run_options_;
+        AsyncSlots slots_;
+        std::vector<Request> requests_;
+    };
+    
+    // Tokenize one text straight into a single-row binding bound at the
+    // padded_length() of the text; returns that length
+    size_t preprocess_into(std::string_view text, Binding& binding) const {
+        return preprocess_tokens_into(tokenize(text, tokenizer_scratch()), binding);
+    }
+    
+    size_t preprocess_tokens_into(const std::vector<std::string_view>& tokens, Binding& binding) const {
+        size_t sequence_length = padded_length(tokens.size());
+        return write_ids(tokens, binding.input(1, sequence_length), sequence_length);
+    }
+    
+    // Tokenize texts into binding as one batch: a single text at its
+    // padded_length(), several (e.g. a server micro-batch) padded to
+    // kMaxSequenceLength
+    void preprocess_batch_into(Span<const std::string_view> texts, Binding& binding) const {
+        if (texts.size() == 1) {
+            preprocess_into(texts[0], binding);
+            return;
+        }
+        int32_t* input = binding.input(texts.size(), kMaxSequenceLength);
+        for (size_t i = 0; i < texts.size(); i++) {
+            preprocess_into(texts[i], input + i * kMaxSequenceLength, kMaxSequenceLength);
+        }
+    }
+    
+    // Binding for the calling (main) thread, created on first use
+    Binding& binding() {
+        if (!binding_) {
+            binding_ = std::make_unique<Binding>(*this);
+        }
+        return *binding_;
+    }
+    
+    // write_ids() with the length fixed at compile time (Pipeline), so the
+    // padding fill has a constant bound
+    template <size_t SequenceLength>
+    void write_fixed_ids(const std::vector<std::string_view>& tokens, int32_t* out) const {
+        static_assert(SequenceLength > 0 && SequenceLength <= kMaxSequenceLength, "sequence length out of range");
+        TraceSpan span("vectorize");
+        size_t count = std::min(tokens.size(), SequenceLength);
+        for (size_t i = 0; i < count; i++) {
+            int32_t id = tokenizer_.find(tokens[i]);
+            out[i] = id >= 0 ? id : oov_id_;
+        }
+        std::fill(out + count, out + SequenceLength, 0);
+    }
+    
+private:
+    // Map the first sequence_length tokens to IDs and zero-pad the rest
+    size_t write_ids(const std::vector<std::string_view>& tokens, int32_t* out, size_t sequence_length) const {
+        TraceSpan span("vectorize");
+        size_t count = std::min(tokens.size(), sequence_length);
+        for (size_t i = 0; i < count; i++) {
+            int32_t id = tokenizer_.find(tokens[i]);
+            out[i] = id >= 0 ? id : oov_id_;
+        }
+        std::fill(out + count, out + sequence_length, 0);
+        return sequence_length;
+    }
+    
+    // Serve cached texts from the result cache and pass the rest to run as one
+    // Span, storing what it returns
+    template <typename Run>
+    std::vector<std::vector<float>> cached_batch(Span<const std::string_view> texts, Run run) {
+        if (!result_cache_) return run(texts);
+        std::vector<std::vector<float>> probabilities(texts.size());
+        std::vector<uint64_t> keys(texts.size());
+        std::vector<std::string_view> miss_texts;
+        std::vector<size_t> misses;
+        for (size_t i = 0; i < texts.size(); i++) {
+            if (cache_lookup(texts[i], keys[i], probabilities[i])) continue;
+            miss_texts.push_back(texts[i]);
+            misses.push_back(i);
+        }
+        if (misses.empty()) return probabilities;
+        std::vector<std::vector<float>> computed = run(Span<const std::string_view>(miss_texts.data(), miss_texts.size()));
+        for (size_t k = 0; k < misses.size(); k++) {
+            cache_store(keys[misses[k]], computed[k]);
+            probabilities[misses[k]] = std::move(computed[k]);
+        }
+        return probabilities;
+    }
+    
+    // Token IDs of a batch's texts at kMaxSequenceLength, written in the same
+    // pass that counts their tokens, so no text is tokenized twice
+    struct TokenizedTexts {
+        std::vector<int32_t> ids;     // [texts, kMaxSequenceLength]
+        std::vector<size_t> lengths;  // token counts before truncation
+    };
+    
+    // Per-thread, valid until the next call on this thread
+    const TokenizedTexts& tokenize_batch(Span<const std::string_view> texts) const {
+        thread_local TokenizedTexts tokenized;
+        tokenized.ids.resize(texts.size() * kMaxSequenceLength);
+        tokenized.lengths.resize(texts.size());
+        for (size_t i = 0; i < texts.size(); i++) {
+            const std::vector<std::string_view>& tokens = tokenize(texts[i], tokenizer_scratch());
+            tokenized.lengths[i] = tokens.size();
+            write_ids(tokens, tokenized.ids.data() + i * kMaxSequenceLength, kMaxSequenceLength);
+        }
+        return tokenized;
+    }
+    
+    // One Run over the tokenized rows padded to the batch_length() of the
+    // longest; rows beyond it are already zero
+    void run_padded(const TokenizedTexts& tokenized, Span<const size_t> rows, std::vector<std::vector<float>>& out,
+                    PaddingStats* padding) {
+        if (rows.empty()) return;
+        size_t longest = 0;
+        for (size_t row : rows) longest = std::max(longest, tokenized.lengths[row]);
+        size_t sequence_length = batch_length(longest);
+        thread_local std::vector<int32_t> batch;
+        batch.resize(rows.size() * sequence_length);
+        for (size_t i = 0; i < rows.size(); i++) {
+            std::copy_n(tokenized.ids.data() + rows[i] * kMaxSequenceLength, sequence_length,
+                        batch.data() + i * sequence_length);
+            if (padding) padding->add(tokenized.lengths[rows[i]], sequence_length);
+        }
+        infer_batch(batch.data(), rows.size(), sequence_length, out);
+    }
+    
+    VocabIndex tokenizer_;
+    std::string vocab_source_;
+    std::string session_source_;
+    StartupTiming startup_;
+    ExecutionProvider provider_ = ExecutionProvider::Cpu;
+    int intra_op_threads_ = 0;
+    bool profiling_ = false;
+    int32_t oov_id_ = 1;
+    
+    Ort::Env env_;
+    Ort::SessionOptions session_options_;
+    std::shared_ptr<const MappedModel> model_mapping_;  // destroyed after session_
+    Ort::Session session_;
+    Ort::MemoryInfo memory_info_;
+    std::string input_name_;
+    std::string output_name_;
+    bool dynamic_batch_ = false;
+    bool dynamic_sequence_ = false;
+    std::vector<int64_t> output_shape_;
+    size_t num_classes_ = 1;
+    std::unique_ptr<Binding> binding_;
+    std::unique_ptr<ResultCache<std::vector<float>>> result_cache_;
+};
+
+}  // namespace whitelightning
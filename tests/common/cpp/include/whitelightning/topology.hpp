@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Ort {
+struct SessionOptions;
+}
+
+namespace whitelightning {
+
+struct SessionConfig;
+
+// One online logical CPU and where it sits: the physical core it is a
+// hyperthread of, its socket and its NUMA node
+struct LogicalCpu {
+    int id = 0;
+    int core = 0;     // unique across packages
+    int package = 0;
+    int node = 0;
+};
+
+// Online CPUs from sysfs on Linux (cpu/online, cpuN/topology, nodeK/cpulist);
+// elsewhere one package and node with the sysctl core counts
+struct CpuTopology {
+    std::vector<LogicalCpu> cpus;  // ascending id
+    int physical_cores = 1;
+    int packages = 1;
+    int numa_nodes = 1;
+    
+    int logical_cpus() const { return static_cast<int>(cpus.size()); }
+    const LogicalCpu* find(int id) const;
+};
+
+// Detected on first use
+const CpuTopology& cpu_topology();
+
+// --pin: the logical CPUs worker and ORT intra-op threads are placed on and
+// the NUMA nodes they belong to
+struct CpuPlacement {
+    std::string spec;
+    std::vector<int> cpus;
+    std::vector<int> nodes;
+    
+    bool empty() const { return cpus.empty(); }
+};
+
+// --pin 0-3,8 | node:0[,1] | cores (first hyperthread of every physical
+// core). Throws std::runtime_error for a malformed spec or CPUs that are
+// offline or outside this process's affinity mask.
+CpuPlacement resolve_cpu_placement(const std::string& spec);
+
+// "0-3,8"
+std::string format_cpu_list(const std::vector<int>& cpus);
+
+// Restrict the calling thread to cpus; false (with a warning) where thread
+// affinity is not supported
+bool pin_current_thread(const std::vector<int>& cpus);
+
+// Confine the calling (main) thread to the whole placement, record it for
+// reports and print it. Call it before loading anything: threads created afterwards
+// inherit the mask, and memory is allocated on the node of the CPU that
+// first touches it, so the session, vocab and the per-worker input buffers
+// (bound lazily on each worker's first run) stay node-local.
+bool apply_cpu_placement(const CpuPlacement& placement);
+
+// The placement apply_cpu_placement() recorded; empty when unpinned
+const CpuPlacement& active_cpu_placement();
+
+// Size ORT's intra-op pool and place its threads on config.pinned_cpus, one
+// CPU each in order (session.intra_op_thread_affinities). The thread calling
+// Run() counts as the first of them and keeps its own affinity. The size is
+// --intra-op-threads, else one thread per pinned CPU, else ORT's default of
+// one per physical core; config.async raises it to at least 2. Returns the
+// pool size, so every caller sees the same effective value.
+int configure_intra_op_threads(Ort::SessionOptions& options, const SessionConfig& config);
+
+}  // namespace whitelightning
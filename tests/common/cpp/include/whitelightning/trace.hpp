@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "whitelightning/metrics.hpp"
+
+namespace whitelightning {
+
+// --trace: scoped spans over the hot path (corpus and model load, tokenize,
+// vectorize, tensor create, Run, postprocess, server queueing), written as
+// Chrome trace JSON (chrome://tracing, ui.perfetto.dev) together with ORT's
+// operator-level profile. Timestamps are get_time_ms(), the clock ORT's
+// profiler also uses, so both line up on one timeline.
+
+// One finished span; name must outlive the trace (string literals)
+struct TraceEvent {
+    const char* name = nullptr;
+    double start_ms = 0;
+    double duration_ms = 0;
+};
+
+// Fixed-capacity ring of one thread's spans. Only the owning thread pushes,
+// so recording takes no lock; once full the oldest spans are overwritten.
+// Readers take head() with acquire and should run after the traced work.
+class TraceRing {
+public:
+    TraceRing(size_t capacity, uint32_t thread_id);
+    
+    void push(const char* name, double start_ms, double end_ms) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        events_[head & mask_] = {name, start_ms, end_ms - start_ms};
+        head_.store(head + 1, std::memory_order_release);
+    }
+    
+    uint32_t thread_id() const { return thread_id_; }
+    uint64_t head() const { return head_.load(std::memory_order_acquire); }
+    size_t capacity() const { return events_.size(); }
+    const TraceEvent& at(uint64_t index) const { return events_[index & mask_]; }
+    void clear() { head_.store(0, std::memory_order_release); }
+    
+private:
+    std::vector<TraceEvent> events_;
+    uint64_t mask_;
+    uint32_t thread_id_;
+    std::atomic<uint64_t> head_{0};
+};
+
+constexpr size_t kTraceEventsPerThread = 1 << 17;
+
+extern std::atomic<bool> g_tracing;
+
+inline bool tracing() { return g_tracing.load(std::memory_order_relaxed); }
+
+// Record from now on; rings are allocated per thread on its first span
+void start_tracing();
+void stop_tracing();
+
+// The calling thread's ring, registered on first use and kept until exit
+TraceRing& thread_trace_ring();
+
+// A span whose start was taken elsewhere, e.g. a request's enqueue time
+inline void record_trace_span(const char* name, double start_ms, double end_ms) {
+    if (tracing()) thread_trace_ring().push(name, start_ms, end_ms);
+}
+
+// Records [construction, destruction) while tracing. Costs one relaxed load
+// when tracing is off.
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name) : name_(name), start_ms_(tracing() ? get_time_ms() : -1.0) {}
+    ~TraceSpan() {
+        if (start_ms_ >= 0) thread_trace_ring().push(name_, start_ms_, get_time_ms());
+    }
+    
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+    
+private:
+    const char* name_;
+    double start_ms_;
+};
+
+// ORT's profile of one session: the file EndProfilingAllocated wrote and
+// the profiler's start time, which its relative timestamps count from
+struct OrtProfile {
+    std::string label;
+    std::string path;
+    uint64_t start_ns = 0;
+};
+
+// Spans of every thread plus the events of each ORT profile, one process
+// row per source
+void write_chrome_trace(const std::string& path, const std::vector<OrtProfile>& ort_profiles = {});
+
+// ORT profile file prefix for a --trace path: out.json -> out_ort (ORT
+// appends a timestamp and .json)
+std::string ort_profile_prefix(const std::string& trace_path);
+
+// Scope of one --trace run: starts tracing when path is non-empty and, on
+// destruction, ends the registered ORT profiles and writes the trace.
+// Declare it after the classifiers it collects profiles from.
+class TraceRecorder {
+public:
+    explicit TraceRecorder(std::string path);
+    ~TraceRecorder();
+    
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+    
+    bool enabled() const { return !path_.empty(); }
+    // Called once at the end, e.g. [&] { return classifier->end_profiling("binary"); }
+    void add_ort_profile(std::function<OrtProfile()> end_profiling);
+    
+private:
+    std::string path_;
+    std::vector<std::function<OrtProfile()>> profiles_;
+};
+
+}  // namespace whitelightning
@@ -0,0 +1,413 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__APPLE__) || defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#include <sys/stat.h>
+
+#include "whitelightning/containers.hpp"
+
+namespace whitelightning {
+
+using json = nlohmann::json;
+
+// Compiled vocabulary ("vocab.bin"): a minimal perfect hash over the vocab
+// words plus the string pool and float arrays (IDF, scaler mean/scale).
+// The file is mmap-ed read-only, so loading is one syscall, a lookup is one
+// hash plus one memcmp, and worker processes on a host share the pages.
+class VocabIndex {
+public:
+    static constexpr uint32_t kMagic = 0x42564C57;     // "WLVB"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr uint32_t kTagIdf = 0x20666469;    // "idf "
+    static constexpr uint32_t kTagMean = 0x6E61656D;   // "mean"
+    static constexpr uint32_t kTagScale = 0x6C616373;  // "scal"
+    static constexpr uint32_t kTagBaseline = 0x65736162;  // "base": -mean/scale
+    static constexpr uint32_t kTagCoef = 0x66656F63;      // "coef": idf/scale
+    static constexpr uint32_t kMaxArrays = 8;
+    static constexpr size_t kArrayAlignment = 64;
+    
+    VocabIndex() = default;
+    VocabIndex(const VocabIndex&) = delete;
+    VocabIndex& operator=(const VocabIndex&) = delete;
+    ~VocabIndex() { unmap(); }
+    
+    // Build a file image from vocab.json (TF-IDF {"vocab","idf"} form or flat
+    // tokenizer form) and, when it holds "mean"/"scale", scaler.json
+    static std::vector<uint8_t> compile(const std::string& vocab_path, const std::string& scaler_path = "") {
+        std::ifstream vf(vocab_path);
+        if (!vf.is_open()) {
+            throw std::runtime_error("Failed to open vocab file: " + vocab_path);
+        }
+        json vocab_data;
+        vf >> vocab_data;
+        
+        const json* words = &vocab_data;
+        if (vocab_data.contains("vocab")) {
+            words = &vocab_data["vocab"];
+        } else if (vocab_data.contains("vocabulary")) {
+            words = &vocab_data["vocabulary"];
+        }
+        bool tokenizer_form = words == &vocab_data;
+        
+        std::vector<std::pair<std::string, int32_t>> entries;
+        entries.reserve(words->size());
+        for (const auto& [word, value] : words->items()) {
+            if (value.is_number_integer()) {
+                entries.emplace_back(word, value.get<int32_t>());
+            }
+        }
+        
+        int32_t oov_id = -1;
+        if (tokenizer_form) {
+            auto oov = words->find("<OOV>");
+            oov_id = oov != words->end() ? oov->get<int32_t>() : 1;
+        }
+        
+        std::vector<std::pair<uint32_t, std::vector<float>>> arrays;
+        if (vocab_data.contains("idf")) {
+            // A "max_features" wider than the IDF list is zero-filled, so the
+            // array length is the model's feature count
+            std::vector<float> idf = vocab_data["idf"].get<std::vector<float>>();
+            idf.resize(std::max(idf.size(), vocab_data.value("max_features", idf.size())), 0.0f);
+            arrays.emplace_back(kTagIdf, std::move(idf));
+        }
+        if (!scaler_path.empty()) {
+            std::ifstream sf(scaler_path);
+            if (!sf.is_open()) {
+                throw std::runtime_error("Failed to open scaler file: " + scaler_path);
+            }
+            json scaler_data;
+            sf >> scaler_data;
+            if (scaler_data.contains("mean") && scaler_data.contains("scale")) {
+                arrays.emplace_back(kTagMean, scaler_data["mean"].get<std::vector<float>>());
+                arrays.emplace_back(kTagScale, scaler_data["scale"].get<std::vector<float>>());
+            }
+        }
+        
+        // Fold the standard scaler into the TF-IDF weights at compile time
+        if (arrays.size() == 3) {
+            std::vector<float> baseline, coef;
+            fold_scaler(arrays[0].second, arrays[1].second, arrays[2].second, baseline, coef);
+            arrays.emplace_back(kTagBaseline, std::move(baseline));
+            arrays.emplace_back(kTagCoef, std::move(coef));
+        }
+        
+        return build_image(entries, oov_id, arrays);
+    }
+    
+    // (tf * idf - mean) / scale == baseline + tf * coef, where a feature that
+    // does not occur in the text is exactly baseline
+    static void fold_scaler(const std::vector<float>& idf, const std::vector<float>& mean, const std::vector<float>& scale,
+                            std::vector<float>& baseline, std::vector<float>& coef) {
+        size_t n = std::min({idf.size(), mean.size(), scale.size()});
+        baseline.resize(n);
+        coef.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            baseline[i] = -mean[i] / scale[i];
+            coef[i] = idf[i] / scale[i];
+        }
+    }
+    
+    static void write(const std::string& path, const std::vector<uint8_t>& image) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("Failed to create compiled vocab file: " + path);
+        }
+        out.write(reinterpret_cast<const char*>(image.data()), image.size());
+        if (!out.good()) {
+            throw std::runtime_error("Failed to write compiled vocab file: " + path);
+        }
+    }
+    
+    // True when the compiled file exists and is newer than all of its sources
+    static bool is_fresh(const std::string& bin_path, const std::vector<std::string>& sources) {
+        struct stat bin_stat;
+        if (stat(bin_path.c_str(), &bin_stat) != 0) {
+            return false;
+        }
+        for (const auto& source : sources) {
+            struct stat source_stat;
+            if (!source.empty() && stat(source.c_str(), &source_stat) == 0 && source_stat.st_mtime > bin_stat.st_mtime) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    // "vocab.json" -> "vocab.bin"
+    static std::string compiled_path(const std::string& vocab_path) {
+        const std::string ext = ".json";
+        if (vocab_path.size() > ext.size() && vocab_path.compare(vocab_path.size() - ext.size(), ext.size(), ext) == 0) {
+            return vocab_path.substr(0, vocab_path.size() - ext.size()) + ".bin";
+        }
+        return vocab_path + ".bin";
+    }
+    
+    // Map a compiled file read-only
+    void open(const std::string& path) {
+        unmap();
+#if defined(__APPLE__) || defined(__linux__)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open compiled vocab file: " + path);
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            throw std::runtime_error("Failed to stat compiled vocab file: " + path);
+        }
+        void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            throw std::runtime_error("Failed to mmap compiled vocab file: " + path);
+        }
+        map_addr_ = addr;
+        map_len_ = static_cast<size_t>(st.st_size);
+        attach(static_cast<const uint8_t*>(addr), map_len_);
+#else
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) {
+            throw std::runtime_error("Failed to open compiled vocab file: " + path);
+        }
+        adopt(std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()));
+#endif
+    }
+    
+    // Use an in-memory image (e.g. compiled on the fly when vocab.bin is missing)
+    void adopt(const std::vector<uint8_t>& image) {
+        unmap();
+        owned_.assign(image.begin(), image.end());
+        attach(owned_.data(), owned_.size());
+    }
+    
+    // Value stored for word (vocab index or token ID), -1 when absent
+    int32_t find(std::string_view word) const {
+        if (header_ == nullptr || header_->num_keys == 0) {
+            return -1;
+        }
+        uint64_t h = hash(word);
+        uint32_t seed = seeds_[bucket_index(h, header_->num_buckets)];
+        const Slot& slot = slots_[slot_index(h, seed, header_->num_keys)];
+        if (slot.length == word.size() && std::memcmp(pool_ + slot.offset, word.data(), word.size()) == 0) {
+            return slot.value;
+        }
+        return -1;
+    }
+    
+    size_t size() const { return header_ ? header_->num_keys : 0; }
+    int32_t oov_id() const { return header_ ? header_->oov_id : -1; }
+    size_t byte_size() const { return map_addr_ ? map_len_ : owned_.size(); }
+    bool is_mapped() const { return map_addr_ != nullptr; }
+    
+    // Float array stored under tag, nullptr when absent
+    const float* array(uint32_t tag, size_t* count) const {
+        for (uint32_t i = 0; header_ && i < header_->num_arrays; i++) {
+            if (header_->arrays[i].tag == tag) {
+                *count = header_->arrays[i].count;
+                return reinterpret_cast<const float*>(base_ + header_->arrays[i].offset);
+            }
+        }
+        *count = 0;
+        return nullptr;
+    }
+    
+private:
+    struct ArrayEntry {
+        uint32_t tag;
+        uint32_t count;
+        uint64_t offset;
+    };
+    
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t num_keys;
+        uint32_t num_buckets;
+        int32_t oov_id;
+        uint32_t num_arrays;
+        uint64_t seeds_offset;
+        uint64_t slots_offset;
+        uint64_t pool_offset;
+        uint64_t pool_bytes;
+        ArrayEntry arrays[kMaxArrays];
+    };
+    
+    struct Slot {
+        uint32_t offset;
+        uint32_t length;
+        int32_t value;
+    };
+    
+    // FNV-1a; vocab words are short so byte-at-a-time is fine
+    static uint64_t hash(std::string_view word) {
+        uint64_t h = 1469598103934665603ULL;
+        for (unsigned char c : word) {
+            h = (h ^ c) * 1099511628211ULL;
+        }
+        return h;
+    }
+    
+    static uint32_t bucket_index(uint64_t h, uint32_t num_buckets) {
+        return static_cast<uint32_t>((h >> 32) % num_buckets);
+    }
+    
+    static uint32_t slot_index(uint64_t h, uint32_t seed, uint32_t num_keys) {
+        uint64_t x = h ^ (static_cast<uint64_t>(seed) * 0x9E3779B97F4A7C15ULL);
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return static_cast<uint32_t>(x % num_keys);
+    }
+    
+    static size_t align8(size_t n) { return (n + 7) & ~size_t(7); }
+    static size_t align_array(size_t n) { return (n + kArrayAlignment - 1) & ~(kArrayAlignment - 1); }
+    
+    // Hash-and-displace construction: place the largest buckets first, each
+    // with the first seed that sends all of its keys to free slots
+    static std::vector<uint8_t> build_image(const std::vector<std::pair<std::string, int32_t>>& entries, int32_t oov_id,
+                                            const std::vector<std::pair<uint32_t, std::vector<float>>>& arrays) {
+        if (arrays.size() > kMaxArrays) {
+            throw std::runtime_error("Too many float arrays for compiled vocab");
+        }
+        uint32_t num_keys = static_cast<uint32_t>(entries.size());
+        uint32_t num_buckets = num_keys / 4 + 1;
+        
+        std::vector<uint64_t> hashes(num_keys);
+        std::vector<std::vector<uint32_t>> buckets(num_buckets);
+        for (uint32_t i = 0; i < num_keys; i++) {
+            hashes[i] = hash(entries[i].first);
+            buckets[bucket_index(hashes[i], num_buckets)].push_back(i);
+        }
+        std::vector<uint32_t> order(num_buckets);
+        for (uint32_t b = 0; b < num_buckets; b++) order[b] = b;
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return buckets[a].size() > buckets[b].size();
+        });
+        
+        std::vector<uint32_t> seeds(num_buckets, 0);
+        std::vector<int64_t> slot_key(num_keys, -1);
+        std::vector<uint32_t> candidate;
+        for (uint32_t b : order) {
+            const auto& keys = buckets[b];
+            if (keys.empty()) break;
+            bool placed = false;
+            for (uint32_t seed = 1; seed < (1u << 24) && !placed; seed++) {
+                candidate.clear();
+                placed = true;
+                for (uint32_t k : keys) {
+                    uint32_t s = slot_index(hashes[k], seed, num_keys);
+                    if (slot_key[s] >= 0 || std::find(candidate.begin(), candidate.end(), s) != candidate.end()) {
+                        placed = false;
+                        break;
+                    }
+                    candidate.push_back(s);
+                }
+                if (placed) {
+                    seeds[b] = seed;
+                    for (size_t j = 0; j < keys.size(); j++) slot_key[candidate[j]] = keys[j];
+                }
+            }
+            if (!placed) {
+                throw std::runtime_error("Failed to build perfect hash (duplicate vocab words?)");
+            }
+        }
+        
+        // Layout: header | seeds | slots | float arrays (cache-line aligned) | string pool
+        Header header{};
+        header.magic = kMagic;
+        header.version = kVersion;
+        header.num_keys = num_keys;
+        header.num_buckets = num_buckets;
+        header.oov_id = oov_id;
+        header.num_arrays = static_cast<uint32_t>(arrays.size());
+        header.seeds_offset = align8(sizeof(Header));
+        header.slots_offset = align8(header.seeds_offset + num_buckets * sizeof(uint32_t));
+        size_t offset = align_array(header.slots_offset + num_keys * sizeof(Slot));
+        for (size_t i = 0; i < arrays.size(); i++) {
+            header.arrays[i] = {arrays[i].first, static_cast<uint32_t>(arrays[i].second.size()), offset};
+            offset = align_array(offset + arrays[i].second.size() * sizeof(float));
+        }
+        header.pool_offset = offset;
+        for (const auto& entry : entries) header.pool_bytes += entry.first.size();
+        
+        std::vector<uint8_t> image(header.pool_offset + header.pool_bytes, 0);
+        std::memcpy(image.data(), &header, sizeof(Header));
+        std::memcpy(image.data() + header.seeds_offset, seeds.data(), seeds.size() * sizeof(uint32_t));
+        for (size_t i = 0; i < arrays.size(); i++) {
+            std::memcpy(image.data() + header.arrays[i].offset, arrays[i].second.data(), arrays[i].second.size() * sizeof(float));
+        }
+        
+        uint32_t pool_pos = 0;
+        Slot* slots = reinterpret_cast<Slot*>(image.data() + header.slots_offset);
+        for (uint32_t s = 0; s < num_keys; s++) {
+            const auto& entry = entries[slot_key[s]];
+            slots[s] = {pool_pos, static_cast<uint32_t>(entry.first.size()), entry.second};
+            std::memcpy(image.data() + header.pool_offset + pool_pos, entry.first.data(), entry.first.size());
+            pool_pos += static_cast<uint32_t>(entry.first.size());
+        }
+        return image;
+    }
+    
+    void attach(const uint8_t* base, size_t len) {
+        if (len < sizeof(Header)) {
+            throw std::runtime_error("Compiled vocab file is truncated");
+        }
+        const Header* header = reinterpret_cast<const Header*>(base);
+        if (header->magic != kMagic || header->version != kVersion) {
+            throw std::runtime_error("Compiled vocab file has wrong magic/version (rebuild with --compile-vocab)");
+        }
+        bool in_bounds = header->num_buckets > 0 && header->num_arrays <= kMaxArrays &&
+                         header->seeds_offset + header->num_buckets * sizeof(uint32_t) <= len &&
+                         header->slots_offset + header->num_keys * sizeof(Slot) <= len &&
+                         header->pool_offset + header->pool_bytes <= len;
+        for (uint32_t i = 0; in_bounds && i < header->num_arrays; i++) {
+            in_bounds = header->arrays[i].offset + header->arrays[i].count * sizeof(float) <= len;
+        }
+        if (!in_bounds) {
+            throw std::runtime_error("Compiled vocab file is corrupt");
+        }
+        base_ = base;
+        header_ = header;
+        seeds_ = reinterpret_cast<const uint32_t*>(base + header->seeds_offset);
+        slots_ = reinterpret_cast<const Slot*>(base + header->slots_offset);
+        pool_ = reinterpret_cast<const char*>(base + header->pool_offset);
+    }
+    
+    void unmap() {
+#if defined(__APPLE__) || defined(__linux__)
+        if (map_addr_ != nullptr) {
+            munmap(map_addr_, map_len_);
+        }
+#endif
+        map_addr_ = nullptr;
+        map_len_ = 0;
+        owned_.clear();
+        header_ = nullptr;
+    }
+    
+    std::vector<uint8_t, AlignedAllocator<uint8_t>> owned_;
+    void* map_addr_ = nullptr;
+    size_t map_len_ = 0;
+    const uint8_t* base_ = nullptr;
+    const Header* header_ = nullptr;
+    const uint32_t* seeds_ = nullptr;
+    const Slot* slots_ = nullptr;
+    const char* pool_ = nullptr;
+};
+
+}  // namespace whitelightning
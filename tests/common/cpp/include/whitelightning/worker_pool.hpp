@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "whitelightning/topology.hpp"
+
+namespace whitelightning {
+
+// Fixed set of worker threads. Each run() deals the task indices out to
+// per-worker deques; a worker pops from the back of its own deque and, once
+// that is empty, steals from the front of the others. With cpus (--pin)
+// worker i is pinned to cpus[i % cpus.size()].
+class WorkerPool {
+public:
+    explicit WorkerPool(size_t num_workers, std::vector<int> cpus = {}) : cpus_(std::move(cpus)) {
+        num_workers = std::max<size_t>(1, num_workers);
+        for (size_t i = 0; i < num_workers; i++) {
+            queues_.push_back(std::make_unique<WorkQueue>());
+        }
+        for (size_t i = 0; i < num_workers; i++) {
+            threads_.emplace_back([this, i]() { worker_loop(i); });
+        }
+    }
+    
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        start_cv_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+    
+    size_t size() const { return threads_.size(); }
+    uint64_t steals() const { return steals_.load(std::memory_order_relaxed); }
+    
+    // Call fn(task, worker) for every task in [0, num_tasks) and wait for all
+    // of them; the first exception thrown by fn is rethrown here
+    void run(size_t num_tasks, const std::function<void(size_t, size_t)>& fn) {
+        size_t per_worker = (num_tasks + size() - 1) / size();
+        for (size_t w = 0; w < size(); w++) {
+            std::lock_guard<std::mutex> lock(queues_[w]->mutex);
+            for (size_t task = w * per_worker; task < std::min(num_tasks, (w + 1) * per_worker); task++) {
+                queues_[w]->tasks.push_back(task);
+            }
+        }
+        
+        std::unique_lock<std::mutex> lock(mutex_);
+        job_ = &fn;
+        error_ = nullptr;
+        active_ = size();
+        generation_++;
+        start_cv_.notify_all();
+        done_cv_.wait(lock, [this]() { return active_ == 0; });
+        job_ = nullptr;
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+    
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+    
+    bool pop_local(size_t worker, size_t& task) {
+        std::lock_guard<std::mutex> lock(queues_[worker]->mutex);
+        if (queues_[worker]->tasks.empty()) return false;
+        task = queues_[worker]->tasks.back();
+        queues_[worker]->tasks.pop_back();
+        return true;
+    }
+    
+    bool steal(size_t worker, size_t& task) {
+        for (size_t offset = 1; offset < size(); offset++) {
+            WorkQueue& victim = *queues_[(worker + offset) % size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.front();
+                victim.tasks.pop_front();
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    void worker_loop(size_t worker) {
+        if (!cpus_.empty()) {
+            pin_current_thread({cpus_[worker % cpus_.size()]});
+        }
+        uint64_t seen_generation = 0;
+        while (true) {
+            const std::function<void(size_t, size_t)>* job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_cv_.wait(lock, [&]() { return stopping_ || generation_ != seen_generation; });
+                if (stopping_) return;
+                seen_generation = generation_;
+                job = job_;
+            }
+            
+            size_t task;
+            while (pop_local(worker, task) || steal(worker, task)) {
+                try {
+                    (*job)(task, worker);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (!error_) error_ = std::current_exception();
+                }
+            }
+            
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--active_ == 0) {
+                done_cv_.notify_one();
+            }
+        }
+    }
+    
+    std::vector<int> cpus_;
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(size_t, size_t)>* job_ = nullptr;
+    uint64_t generation_ = 0;
+    size_t active_ = 0;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+    std::atomic<uint64_t> steals_{0};
+};
+
+}  // namespace whitelightning
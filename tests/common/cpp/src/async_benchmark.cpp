@@ -0,0 +1,119 @@
+#include "whitelightning/async_benchmark.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+#include "whitelightning/metrics.hpp"
+
+namespace whitelightning {
+
+namespace {
+
+AsyncDepthPoint run_depth(int depth, size_t total, size_t num_texts, const AsyncRunnerFactory& make_runner) {
+    CompletionQueue completions;
+    AsyncSubmit submit = make_runner(depth, completions.executor());
+    AsyncDepthPoint point;
+    point.depth = depth;
+    size_t issued = 0, completed = 0;
+    
+    auto drive = [&](size_t count, bool measure) {
+        size_t end = issued + count;
+        size_t done_target = completed + count;
+        while (completed < done_target) {
+            while (issued < end) {
+                double submitted = get_time_ms();
+                bool accepted = submit(issued % num_texts, [&, submitted, measure]() {
+                    if (measure) point.latency.record_ms(get_time_ms() - submitted);
+                    completed++;
+                });
+                if (!accepted) break;
+                issued++;
+            }
+            completions.wait_and_run(1.0);
+        }
+    };
+    
+    // Warm every slot's tensors
+    drive(static_cast<size_t>(depth), false);
+    double start = get_time_ms();
+    drive(total, true);
+    point.seconds = (get_time_ms() - start) / 1000.0;
+    point.throughput = total / point.seconds;
+    return point;
+}
+
+}  // namespace
+
+AsyncBenchResult run_async_benchmark(const AsyncBenchConfig& config, size_t num_texts, const BlockingHandler& blocking,
+                                     const AsyncRunnerFactory& make_runner) {
+    AsyncBenchResult result;
+    result.requests = config.requests;
+    const size_t total = static_cast<size_t>(config.requests);
+    
+    for (size_t i = 0; i < std::min<size_t>(num_texts, 10); i++) blocking(i);
+    double start = get_time_ms();
+    for (size_t i = 0; i < total; i++) {
+        double request_start = get_time_ms();
+        blocking(i % num_texts);
+        result.blocking_latency.record_ms(get_time_ms() - request_start);
+    }
+    result.blocking_throughput = total * 1000.0 / (get_time_ms() - start);
+    
+    std::vector<int> depths = config.depths;
+    std::sort(depths.begin(), depths.end());
+    for (int depth : depths) {
+        result.points.push_back(run_depth(depth, total, num_texts, make_runner));
+    }
+    return result;
+}
+
+void print_async_benchmark(const AsyncBenchResult& result) {
+    std::cout << "\n🔁 ASYNC IN-FLIGHT DEPTH (" << result.requests << " requests per depth, one caller thread, "
+              << result.intra_op_threads << " intra-op threads)\n";
+    std::cout << "============================================================\n";
+    std::cout << std::fixed << "   Blocking Run:  " << std::setprecision(1) << result.blocking_throughput
+              << " texts/sec, p50 " << std::setprecision(3) << result.blocking_latency.percentile_ms(50) << "ms, p99 "
+              << result.blocking_latency.percentile_ms(99) << "ms\n";
+    std::cout << "   Depth    Texts/sec     p50 ms     p99 ms  vs blocking\n";
+    for (const AsyncDepthPoint& point : result.points) {
+        std::cout << "   " << std::setw(5) << point.depth << std::setprecision(1) << std::setw(13) << point.throughput
+                  << std::setprecision(3) << std::setw(11) << point.latency.percentile_ms(50) << std::setw(11)
+                  << point.latency.percentile_ms(99) << std::setprecision(2) << std::setw(12) << point.throughput / result.blocking_throughput << "x\n";
+    }
+    
+    auto best = std::max_element(result.points.begin(), result.points.end(),
+                                 [](const AsyncDepthPoint& a, const AsyncDepthPoint& b) { return a.throughput < b.throughput; });
+    if (best != result.points.end()) {
+        std::cout << "\n🏁 Best: depth " << best->depth << " at " << std::setprecision(1) << best->throughput
+                  << " texts/sec (" << std::setprecision(2) << best->throughput / result.blocking_throughput
+                  << "x blocking)\n";
+    }
+}
+
+json async_benchmark_report(const std::string& name, const Corpus& corpus, const AsyncBenchResult& result,
+                            const SystemInfo& system_info) {
+    json points = json::array();
+    for (const AsyncDepthPoint& point : result.points) {
+        points.push_back({
+            {"depth", point.depth},
+            {"seconds", point.seconds},
+            {"throughput_per_sec", point.throughput},
+            {"speedup_vs_blocking", point.throughput / result.blocking_throughput},
+            {"latency_ms", latency_summary(point.latency)}
+        });
+    }
+    return {
+        {"model", name},
+        {"mode", "async"},
+        {"corpus", {{"source", corpus.source}, {"texts", corpus.texts.size()}}},
+        {"requests_per_depth", result.requests},
+        {"intra_op_threads", result.intra_op_threads},
+        {"blocking", {{"throughput_per_sec", result.blocking_throughput},
+                      {"latency_ms", latency_summary(result.blocking_latency)}}},
+        {"points", points},
+        {"system", system_report(system_info)}
+    };
+}
+
+}  // namespace whitelightning
@@ -0,0 +1,473 @@
+#include "whitelightning/benchmark.hpp"
+
+#include <onnxruntime_cxx_api.h>
+#include <algorithm>
+#include <functional>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+#include "whitelightning/model_cache.hpp"
+#include "whitelightning/stream_io.hpp"
+#include "whitelightning/topology.hpp"
+#include "whitelightning/trace.hpp"
+#include "whitelightning/vocab_index.hpp"
+
+namespace whitelightning {
+
+json system_report(const SystemInfo& system_info) {
+    const CpuPlacement& placement = active_cpu_placement();
+    json pinning = {{"pinned", !placement.empty()}};
+    if (!placement.empty()) {
+        pinning["spec"] = placement.spec;
+        pinning["cpus"] = placement.cpus;
+        pinning["numa_nodes"] = placement.nodes;
+    }
+    return {
+        {"platform", system_info.platform},
+        {"cpu_cores", system_info.cpu_count_physical},
+        {"cpu_logical", system_info.cpu_count_logical},
+        {"cpu_packages", system_info.cpu_packages},
+        {"numa_nodes", system_info.numa_nodes},
+        {"memory_gb", system_info.total_memory_gb},
+        {"onnxruntime_version", OrtGetApiBase()->GetVersionString()},
+        {"placement", pinning}
+    };
+}
+
+Corpus load_corpus(const std::string& path, bool shuffle, uint64_t seed) {
+    TraceSpan span("corpus_load");
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open corpus file: " + path);
+    }
+    
+    Corpus corpus;
+    corpus.source = path;
+    corpus.shuffled = shuffle;
+    corpus.seed = seed;
+    std::string line;
+    StreamInput input;
+    while (std::getline(file, line)) {
+        if (parse_stream_line(line, input) && input.error.empty()) {
+            corpus.texts.push_back(std::move(input.text));
+        }
+    }
+    if (corpus.texts.empty()) {
+        throw std::runtime_error("Corpus has no texts: " + path);
+    }
+    if (shuffle) {
+        std::mt19937_64 rng(seed);
+        std::shuffle(corpus.texts.begin(), corpus.texts.end(), rng);
+    }
+    return corpus;
+}
+
+size_t length_bucket(size_t tokens) {
+    size_t bucket = 0;
+    while (tokens > kLengthBuckets[bucket].max_tokens) bucket++;
+    return bucket;
+}
+
+json latency_summary(const LatencyHistogram& histogram) {
+    return {
+        {"mean", histogram.mean_ms()},
+        {"stddev", histogram.stddev_ms()},
+        {"min", histogram.min_ms()},
+        {"p50", histogram.percentile_ms(50)},
+        {"p90", histogram.percentile_ms(90)},
+        {"p99", histogram.percentile_ms(99)},
+        {"p99_9", histogram.percentile_ms(99.9)},
+        {"max", histogram.max_ms()}
+    };
+}
+
+json result_cache_report(const ResultCacheStats& cache) {
+    return {
+        {"hits", cache.hits},
+        {"misses", cache.misses},
+        {"hit_rate", cache.hit_rate()},
+        {"entries", cache.entries},
+        {"bytes", cache.bytes},
+        {"evictions", cache.evictions}
+    };
+}
+
+json startup_report(const StartupTiming& startup) {
+    return {
+        {"env_init", startup.env_init_ms},
+        {"vocab_load", startup.vocab_load_ms},
+        {"session_load", startup.session_load_ms},
+        {"first_run", startup.first_run_ms},
+        {"total", startup.total_ms()}
+    };
+}
+
+json length_bucket_report(const std::vector<LengthBucketStats>& buckets) {
+    json report = json::array();
+    for (size_t b = 0; b < buckets.size(); b++) {
+        const LengthBucketStats& bucket = buckets[b];
+        if (bucket.texts == 0) continue;
+        report.push_back({
+            {"bucket", kLengthBuckets[b].name},
+            {"texts", bucket.texts},
+            {"mean_tokens", static_cast<double>(bucket.tokens) / bucket.texts},
+            {"oov_rate", bucket.tokens ? static_cast<double>(bucket.oov_tokens) / bucket.tokens : 0.0},
+            {"latency_ms", latency_summary(bucket.latency)},
+            {"preprocessing_ms", latency_summary(bucket.preprocessing)}
+        });
+    }
+    return report;
+}
+
+json benchmark_report(const std::string& name, const Corpus& corpus, int num_runs, double total_time_ms,
+                      const LatencyHistogram& latency, const LatencyHistogram& preprocessing,
+                      const LatencyHistogram& inference, const LatencyHistogram& postprocessing,
+                      const SystemInfo& system_info) {
+    json histogram = json::array();
+    latency.for_each_bucket([&](double lower_ms, double upper_ms, uint64_t count) {
+        histogram.push_back({{"lower_ms", lower_ms}, {"upper_ms", upper_ms}, {"count", count}});
+    });
+    
+    return {
+        {"benchmark", name},
+        {"corpus", {
+            {"source", corpus.source},
+            {"texts", corpus.texts.size()},
+            {"shuffled", corpus.shuffled},
+            {"seed", corpus.seed}
+        }},
+        {"runs", num_runs},
+        {"total_time_ms", total_time_ms},
+        {"throughput_per_sec", num_runs * 1000.0 / total_time_ms},
+        {"latency_ms", latency_summary(latency)},
+        {"phases_ms", {
+            {"preprocessing", latency_summary(preprocessing)},
+            {"inference", latency_summary(inference)},
+            {"postprocessing", latency_summary(postprocessing)}
+        }},
+        {"histogram", histogram},
+        {"system", system_report(system_info)}
+    };
+}
+
+void write_benchmark_report(const std::string& path, const json& report) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to open report file: " + path);
+    }
+    out << report.dump(2) << "\n";
+    std::cout << "📝 Report written to " << path << "\n";
+}
+
+double label_agreement(const VariantResult& baseline, const VariantResult& candidate) {
+    size_t count = std::min(baseline.labels.size(), candidate.labels.size());
+    if (count == 0) return 0.0;
+    size_t agree = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (baseline.labels[i] == candidate.labels[i]) agree++;
+    }
+    return static_cast<double>(agree) / count;
+}
+
+void print_variant_comparison(const VariantResult& baseline, const VariantResult& candidate, const Corpus& corpus,
+                              const std::vector<std::string>& label_names) {
+    auto label = [&](int id) {
+        return id >= 0 && static_cast<size_t>(id) < label_names.size() ? label_names[id] : std::to_string(id);
+    };
+    auto row = [](const char* metric, double a, double b, const char* unit, int precision) {
+        std::cout << "   " << std::left << std::setw(18) << metric << std::right << std::fixed 
+                  << std::setprecision(precision) << std::setw(11) << a << unit << std::setw(11) << b << unit 
+                  << std::setw(9) << std::setprecision(2) << (a > 0 ? b / a : 0.0) << "x\n";
+    };
+    
+    std::cout << "\n⚖️ VARIANT COMPARISON (" << baseline.name << " vs " << candidate.name << "):\n";
+    std::cout << "   " << std::left << std::setw(18) << "" << std::right << std::setw(13) << baseline.name 
+              << std::setw(13) << candidate.name << std::setw(10) << "ratio" << "\n";
+    row("Load", baseline.load_ms, candidate.load_ms, "ms", 2);
+    row("Mean latency", baseline.latency.mean_ms(), candidate.latency.mean_ms(), "ms", 3);
+    row("p50", baseline.latency.percentile_ms(50), candidate.latency.percentile_ms(50), "ms", 3);
+    row("p90", baseline.latency.percentile_ms(90), candidate.latency.percentile_ms(90), "ms", 3);
+    row("p99", baseline.latency.percentile_ms(99), candidate.latency.percentile_ms(99), "ms", 3);
+    row("p99.9", baseline.latency.percentile_ms(99.9), candidate.latency.percentile_ms(99.9), "ms", 3);
+    row("Throughput", baseline.latency.count() * 1000.0 / baseline.total_time_ms,
+        candidate.latency.count() * 1000.0 / candidate.total_time_ms, "/s", 1);
+    row("RSS after load", baseline.load_rss_mb, candidate.load_rss_mb, "MB", 2);
+    row("RSS after runs", baseline.run_rss_mb, candidate.run_rss_mb, "MB", 2);
+    
+    size_t compared = std::min(baseline.labels.size(), candidate.labels.size());
+    std::vector<size_t> disagreements;
+    for (size_t i = 0; i < compared; i++) {
+        if (baseline.labels[i] != candidate.labels[i]) disagreements.push_back(i);
+    }
+    std::cout << "\n🤝 LABEL AGREEMENT: " << std::setprecision(2) << label_agreement(baseline, candidate) * 100.0 
+              << "% (" << compared - disagreements.size() << "/" << compared << " texts)\n";
+    // A few of the texts the variants disagree on
+    for (size_t k = 0; k < std::min<size_t>(disagreements.size(), 5); k++) {
+        size_t i = disagreements[k];
+        std::cout << "   " << label(baseline.labels[i]) << " -> " << label(candidate.labels[i]) << ": \"" 
+                  << corpus.texts[i] << "\"\n";
+    }
+}
+
+json variant_comparison_report(const std::string& name, const Corpus& corpus, int num_runs,
+                               const VariantResult& baseline, const VariantResult& candidate,
+                               const SystemInfo& system_info) {
+    auto variant = [](const VariantResult& result) {
+        return json{
+            {"model", result.model_path},
+            {"load_ms", result.load_ms},
+            {"load_rss_mb", result.load_rss_mb},
+            {"run_rss_mb", result.run_rss_mb},
+            {"total_time_ms", result.total_time_ms},
+            {"throughput_per_sec", result.latency.count() * 1000.0 / result.total_time_ms},
+            {"latency_ms", latency_summary(result.latency)}
+        };
+    };
+    
+    return {
+        {"benchmark", name + "_variant_comparison"},
+        {"corpus", {
+            {"source", corpus.source},
+            {"texts", corpus.texts.size()},
+            {"shuffled", corpus.shuffled},
+            {"seed", corpus.seed}
+        }},
+        {"runs", num_runs},
+        {"variants", {{baseline.name, variant(baseline)}, {candidate.name, variant(candidate)}}},
+        {"label_agreement", label_agreement(baseline, candidate)},
+        {"system", system_report(system_info)}
+    };
+}
+
+void print_session_memory(const std::vector<SessionMemoryResult>& results) {
+    if (results.empty()) return;
+    const SessionMemoryResult& baseline = results[0];
+    std::cout << "   RSS per extra session (" << baseline.sessions << " per mode, first / each additional):\n";
+    for (const SessionMemoryResult& result : results) {
+        std::cout << "      " << std::left << std::setw(6) << result.mode + ":" << std::right << std::fixed
+                  << std::setprecision(2) << std::showpos << result.first_mb << " MB / " << result.additional_mb
+                  << " MB" << std::noshowpos;
+        if (&result != &baseline) {
+            std::cout << " (saves " << baseline.additional_mb - result.additional_mb << " MB per additional session)";
+        }
+        std::cout << "\n";
+    }
+}
+
+json session_memory_report(const std::vector<SessionMemoryResult>& results) {
+    json report = json::array();
+    for (const SessionMemoryResult& result : results) {
+        json entry = {
+            {"mode", result.mode},
+            {"sessions", result.sessions},
+            {"first_session_mb", result.first_mb},
+            {"additional_session_mb", result.additional_mb}
+        };
+        if (&result != &results[0]) {
+            entry["saved_per_additional_session_mb"] = results[0].additional_mb - result.additional_mb;
+        }
+        report.push_back(entry);
+    }
+    return report;
+}
+
+std::vector<ProviderSweepResult> sweep_providers(const ModelBundle& bundle, SessionConfig config, int num_runs,
+                                                 int max_batch, const std::vector<std::string>& texts) {
+    std::vector<int> batch_sizes;
+    for (int size = 1; size < max_batch; size *= 2) {
+        batch_sizes.push_back(size);
+    }
+    batch_sizes.push_back(max_batch);
+    
+    // Every request has to reach the model
+    config.result_cache_entries = 0;
+    config.result_cache_bytes = 0;
+    
+    std::vector<ProviderSweepResult> results;
+    for (ExecutionProvider requested : available_execution_providers()) {
+        config.provider = requested;
+        double load_start = get_time_ms();
+        std::unique_ptr<Classifier> classifier;
+        try {
+            classifier = Classifier::load(bundle, config);
+        } catch (const std::exception& e) {
+            std::cerr << "⚠️ " << execution_provider_name(requested) << " failed to load: " << e.what() << "\n";
+            ProviderSweepResult failed;
+            failed.requested = requested;
+            failed.error = e.what();
+            results.push_back(std::move(failed));
+            continue;
+        }
+        double load_ms = get_time_ms() - load_start;
+        ExecutionProvider provider = classifier->stats().provider;
+        if (provider != requested) {
+            ProviderSweepResult fallback;
+            fallback.requested = requested;
+            fallback.provider = provider;
+            results.push_back(std::move(fallback));
+            continue;
+        }
+        
+        for (int batch_size : batch_sizes) {
+            std::cout << "🔄 " << execution_provider_name(provider) << ", batch " << batch_size << "\n";
+            ProviderSweepResult result;
+            result.requested = requested;
+            result.provider = provider;
+            result.batch_size = batch_size;
+            result.load_ms = load_ms;
+            
+            // Consecutive corpus texts, wrapping around, built before timing
+            int num_batches = std::max(1, (num_runs + batch_size - 1) / batch_size);
+            std::vector<std::vector<std::string>> batches(num_batches);
+            for (int b = 0; b < num_batches; b++) {
+                for (int i = 0; i < batch_size; i++) {
+                    batches[b].push_back(texts[(static_cast<size_t>(b) * batch_size + i) % texts.size()]);
+                }
+            }
+            classifier->predict_batch(batches[0]);
+            
+            double overall_start = get_time_ms();
+            for (const std::vector<std::string>& batch : batches) {
+                double start = get_time_ms();
+                classifier->predict_batch(batch);
+                result.latency.record_ms(get_time_ms() - start);
+            }
+            result.total_time_ms = get_time_ms() - overall_start;
+            result.texts = static_cast<size_t>(num_batches) * batch_size;
+            results.push_back(std::move(result));
+        }
+    }
+    return results;
+}
+
+void print_provider_sweep(const std::vector<ProviderSweepResult>& results) {
+    if (results.empty()) return;
+    std::cout << "\n🖥️ EXECUTION PROVIDERS (latency per batch):\n";
+    std::cout << "   Provider   Batch    Load      Mean       p50       p99   Texts/sec\n";
+    const ProviderSweepResult* fastest = nullptr;
+    for (const ProviderSweepResult& result : results) {
+        std::cout << "   " << std::left << std::setw(9) << execution_provider_name(result.requested) << std::right;
+        if (!result.error.empty()) {
+            std::cout << "  failed to load (" << result.error << "), not timed\n";
+            continue;
+        }
+        if (result.batch_size == 0) {
+            std::cout << "  fell back to " << execution_provider_name(result.provider) << ", not timed\n";
+            continue;
+        }
+        double throughput = result.texts * 1000.0 / result.total_time_ms;
+        std::cout << std::setw(7) << result.batch_size << std::fixed << std::setprecision(1) << std::setw(8)
+                  << result.load_ms << "ms" << std::setprecision(3) << std::setw(8) << result.latency.mean_ms()
+                  << "ms" << std::setw(8) << result.latency.percentile_ms(50) << "ms" << std::setw(8)
+                  << result.latency.percentile_ms(99) << "ms" << std::setprecision(1) << std::setw(12)
+                  << throughput << "\n";
+        if (fastest == nullptr || throughput > fastest->texts * 1000.0 / fastest->total_time_ms) {
+            fastest = &result;
+        }
+    }
+    if (fastest != nullptr) {
+        std::cout << "   Highest throughput: " << execution_provider_name(fastest->provider) << " at batch "
+                  << fastest->batch_size << "\n";
+    }
+}
+
+json provider_sweep_report(const std::vector<ProviderSweepResult>& results) {
+    json report = json::array();
+    for (const ProviderSweepResult& result : results) {
+        json entry = {
+            {"requested", execution_provider_name(result.requested)},
+            {"provider", execution_provider_name(result.provider)}
+        };
+        if (result.batch_size == 0) {
+            entry["fell_back"] = true;
+            if (!result.error.empty()) entry["error"] = result.error;
+        } else {
+            entry["batch_size"] = result.batch_size;
+            entry["load_ms"] = result.load_ms;
+            entry["texts"] = result.texts;
+            entry["texts_per_second"] = result.texts * 1000.0 / result.total_time_ms;
+            entry["batch_latency_ms"] = latency_summary(result.latency);
+        }
+        report.push_back(entry);
+    }
+    return report;
+}
+
+int run_cold_start_benchmark(const std::string& model_path, int num_runs) {
+    std::cout << "\n❄️ COLD VS WARM SESSION CREATION (" << num_runs << " runs each)\n";
+    std::cout << "============================================================\n";
+    
+    try {
+        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "cold_start_benchmark");
+        OptimizedModelCache cache(model_path);
+        if (!cache.warm()) {
+            Ort::SessionOptions options;
+            std::string path = cache.configure(options);
+            Ort::Session session(env, path.c_str(), options);
+            cache.commit();
+        }
+        
+        auto measure = [&](const std::function<std::string(Ort::SessionOptions&)>& setup, double& min_ms) {
+            double total_ms = 0.0;
+            min_ms = 1e9;
+            for (int i = 0; i < num_runs; i++) {
+                Ort::SessionOptions options;
+                double start = get_time_ms();
+                std::string path = setup(options);
+                Ort::Session session(env, path.c_str(), options);
+                double elapsed = get_time_ms() - start;
+                total_ms += elapsed;
+                min_ms = std::min(min_ms, elapsed);
+            }
+            return total_ms / num_runs;
+        };
+        
+        double cold_min = 0.0, warm_min = 0.0;
+        double cold_avg = measure([&](Ort::SessionOptions& options) {
+            options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+            return model_path;
+        }, cold_min);
+        double warm_avg = measure([&](Ort::SessionOptions& options) {
+            return OptimizedModelCache(model_path).configure(options);
+        }, warm_min);
+        
+        std::cout << "   Cold (optimize " << model_path << "): avg " << std::fixed << std::setprecision(2) 
+                  << cold_avg << "ms, min " << cold_min << "ms\n";
+        std::cout << "   Warm (load " << cache.path() << "): avg " << warm_avg << "ms, min " << warm_min << "ms\n";
+        std::cout << "   Speedup: " << std::setprecision(1) << cold_avg / warm_avg << "x\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Benchmark error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+int compile_vocab(const std::string& vocab_path, const std::string& output_path, const std::string& scaler_path) {
+    std::cout << "📦 Compiling " << vocab_path << (scaler_path.empty() ? "" : " + " + scaler_path) << " -> " 
+              << output_path << "\n";
+    try {
+        double compile_start = get_time_ms();
+        auto image = VocabIndex::compile(vocab_path, scaler_path);
+        VocabIndex::write(output_path, image);
+        double compile_time = get_time_ms() - compile_start;
+        
+        double load_start = get_time_ms();
+        VocabIndex index;
+        index.open(output_path);
+        double load_time = get_time_ms() - load_start;
+        
+        std::cout << "✅ " << index.size() << " words, " << image.size() << " bytes in " 
+                  << std::fixed << std::setprecision(2) << compile_time << "ms (load: " 
+                  << std::setprecision(1) << load_time * 1000.0 << "us)\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+}  // namespace whitelightning
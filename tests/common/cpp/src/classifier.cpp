@@ -0,0 +1,172 @@
+#include "whitelightning/classifier.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "whitelightning/binary_classifier.hpp"
+#include "whitelightning/emotion_classifier.hpp"
+#include "whitelightning/labels.hpp"
+#include "whitelightning/metrics.hpp"
+#include "whitelightning/topic_classifier.hpp"
+#include "whitelightning/trace.hpp"
+
+namespace whitelightning {
+
+namespace {
+
+class BinaryModel : public Classifier {
+public:
+    BinaryModel(const ModelBundle& bundle, const SessionConfig& config)
+        : Classifier(ModelType::Binary, {"negative", "positive"}),
+          classifier_(bundle.model_path, bundle.vocab_path, bundle.scaler_path, config) {}
+    
+protected:
+    void score(const std::vector<std::string_view>& texts, std::vector<std::vector<float>>& scores) override {
+        const Span<const std::string_view> batch(texts.data(), texts.size());
+        std::vector<float> probabilities = classifier_.predict_batch(batch);
+        for (size_t i = 0; i < texts.size(); i++) {
+            scores[i] = {1.0f - probabilities[i], probabilities[i]};
+        }
+    }
+    
+    ResultCacheStats result_cache_stats() const override { return classifier_.result_cache_stats(); }
+    StartupTiming startup() const override { return classifier_.startup(); }
+    ExecutionProvider provider() const override { return classifier_.provider(); }
+    
+private:
+    BinaryClassifier classifier_;
+};
+
+class TopicModel : public Classifier {
+public:
+    TopicModel(std::unique_ptr<TopicClassifier> classifier, const ModelBundle& bundle)
+        : Classifier(ModelType::Multiclass, load_labels(bundle.scaler_path, classifier->num_classes())),
+          classifier_(std::move(classifier)) {}
+    
+protected:
+    void score(const std::vector<std::string_view>& texts, std::vector<std::vector<float>>& scores) override {
+        const Span<const std::string_view> batch(texts.data(), texts.size());
+        scores = classifier_->predict_batch(batch);
+    }
+    
+    ResultCacheStats result_cache_stats() const override { return classifier_->result_cache_stats(); }
+    StartupTiming startup() const override { return classifier_->startup(); }
+    ExecutionProvider provider() const override { return classifier_->provider(); }
+    
+private:
+    std::unique_ptr<TopicClassifier> classifier_;
+};
+
+std::vector<std::string> emotion_labels(const EmotionClassifier& classifier) {
+    std::vector<std::string> labels;
+    for (size_t i = 0; i < classifier.num_classes(); i++) {
+        labels.push_back(classifier.label(i));
+    }
+    return labels;
+}
+
+class EmotionModel : public Classifier {
+public:
+    explicit EmotionModel(std::unique_ptr<EmotionClassifier> classifier)
+        : Classifier(ModelType::MultiLabel, emotion_labels(*classifier)), classifier_(std::move(classifier)) {}
+    
+protected:
+    // The multi-label model has no batched path; one Run per text
+    void score(const std::vector<std::string_view>& texts, std::vector<std::vector<float>>& scores) override {
+        for (size_t i = 0; i < texts.size(); i++) {
+            scores[i] = classifier_->predict(texts[i]);
+        }
+    }
+    
+    StartupTiming startup() const override { return classifier_->startup(); }
+    ExecutionProvider provider() const override { return classifier_->provider(); }
+    
+private:
+    std::unique_ptr<EmotionClassifier> classifier_;
+};
+
+}  // namespace
+
+ModelBundle ModelBundle::from_directory(const std::string& directory, ModelType type, ModelVariant variant) {
+    std::string prefix = directory.empty() || directory.back() == '/' ? directory : directory + "/";
+    ModelBundle bundle;
+    bundle.type = type;
+    bundle.model_path = model_variant_path(prefix + "model.onnx", variant);
+    bundle.vocab_path = prefix + "vocab.json";
+    bundle.scaler_path = prefix + "scaler.json";
+    return bundle;
+}
+
+std::unique_ptr<Classifier> Classifier::load(const ModelBundle& bundle, const SessionConfig& config) {
+    switch (bundle.type) {
+        case ModelType::Binary:
+            return std::make_unique<BinaryModel>(bundle, config);
+        case ModelType::Multiclass:
+            return std::make_unique<TopicModel>(std::make_unique<TopicClassifier>(bundle.model_path, bundle.vocab_path, config),
+                                                bundle);
+        case ModelType::MultiLabel:
+            return std::make_unique<EmotionModel>(
+                std::make_unique<EmotionClassifier>(bundle.model_path, bundle.vocab_path, bundle.scaler_path, config));
+    }
+    throw std::runtime_error("Unknown model type");
+}
+
+Prediction Classifier::predict(std::string_view text) {
+    return run({text}).front();
+}
+
+std::vector<Prediction> Classifier::predict_batch(const std::vector<std::string>& texts) {
+    return run(std::vector<std::string_view>(texts.begin(), texts.end()));
+}
+
+std::vector<Prediction> Classifier::run(const std::vector<std::string_view>& texts) {
+    std::vector<Prediction> predictions(texts.size());
+    if (texts.empty()) return predictions;
+    
+    std::vector<std::vector<float>> scores(texts.size());
+    double start = get_time_ms();
+    score(texts, scores);
+    double elapsed_ms = get_time_ms() - start;
+    
+    TraceSpan span("postprocess");
+    for (size_t i = 0; i < texts.size(); i++) {
+        Prediction& prediction = predictions[i];
+        prediction.scores = std::move(scores[i]);
+        if (!prediction.scores.empty()) {
+            auto best = std::max_element(prediction.scores.begin(), prediction.scores.end());
+            prediction.label = static_cast<size_t>(best - prediction.scores.begin());
+            prediction.confidence = *best;
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    latency_.record_ms(elapsed_ms);
+    texts_ += texts.size();
+    total_ms_ += elapsed_ms;
+    return predictions;
+}
+
+ClassifierStats Classifier::stats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    ClassifierStats stats;
+    stats.calls = latency_.count();
+    stats.texts = texts_;
+    stats.total_ms = total_ms_;
+    stats.mean_ms = latency_.mean_ms();
+    stats.p50_ms = latency_.percentile_ms(50);
+    stats.p99_ms = latency_.percentile_ms(99);
+    stats.max_ms = latency_.max_ms();
+    stats.result_cache = result_cache_stats();
+    stats.startup = startup();
+    stats.provider = provider();
+    return stats;
+}
+
+void Classifier::reset_stats() {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    latency_ = LatencyHistogram();
+    texts_ = 0;
+    total_ms_ = 0.0;
+}
+
+}  // namespace whitelightning
@@ -0,0 +1,19 @@
+#include "whitelightning/emotion_classifier.hpp"
+
+#include <algorithm>
+
+namespace whitelightning {
+
+std::vector<size_t> detected_emotions(const float* probabilities, size_t num_classes, float threshold) {
+    std::vector<size_t> detected;
+    for (size_t i = 0; i < num_classes; i++) {
+        if (probabilities[i] >= threshold) {
+            detected.push_back(i);
+        }
+    }
+    std::sort(detected.begin(), detected.end(),
+              [&](size_t a, size_t b) { return probabilities[a] > probabilities[b]; });
+    return detected;
+}
+
+}  // namespace whitelightning
@@ -0,0 +1,106 @@
+#include "whitelightning/execution_provider.hpp"
+
+#include <onnxruntime_cxx_api.h>
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+#include "whitelightning/session_config.hpp"
+
+namespace whitelightning {
+
+namespace {
+
+// Name ORT reports in GetAvailableProviders()
+const char* ort_provider_name(ExecutionProvider provider) {
+    switch (provider) {
+        case ExecutionProvider::Xnnpack: return "XnnpackExecutionProvider";
+        case ExecutionProvider::Cuda: return "CUDAExecutionProvider";
+        case ExecutionProvider::CoreML: return "CoreMLExecutionProvider";
+        case ExecutionProvider::OpenVino: return "OpenVINOExecutionProvider";
+        default: return "CPUExecutionProvider";
+    }
+}
+
+bool built_with(const std::vector<std::string>& built, ExecutionProvider provider) {
+    return std::find(built.begin(), built.end(), ort_provider_name(provider)) != built.end();
+}
+
+}  // namespace
+
+std::vector<ExecutionProvider> available_execution_providers() {
+    std::vector<std::string> built = Ort::GetAvailableProviders();
+    std::vector<ExecutionProvider> available = {ExecutionProvider::Cpu};
+    for (ExecutionProvider provider : kExecutionProviders) {
+        if (provider != ExecutionProvider::Cpu && built_with(built, provider)) {
+            available.push_back(provider);
+        }
+    }
+    return available;
+}
+
+ExecutionProvider append_execution_provider(Ort::SessionOptions& options, const SessionConfig& config) {
+    ExecutionProvider provider = config.provider;
+    if (provider == ExecutionProvider::Cpu) return provider;
+    
+    const char* name = execution_provider_name(provider);
+    if (!built_with(Ort::GetAvailableProviders(), provider)) {
+        std::cerr << "⚠️ " << name << " execution provider is not in this ONNX Runtime build - falling back to cpu\n";
+        return ExecutionProvider::Cpu;
+    }
+    try {
+        switch (provider) {
+            case ExecutionProvider::Xnnpack: {
+                // XNNPACK runs its own thread pool; size it like the intra-op pool
+                std::unordered_map<std::string, std::string> xnnpack_options;
+                if (config.intra_op_threads > 0) {
+                    xnnpack_options["intra_op_num_threads"] = std::to_string(config.intra_op_threads);
+                }
+                options.AppendExecutionProvider("XNNPACK", xnnpack_options);
+                break;
+            }
+            case ExecutionProvider::Cuda: {
+                OrtCUDAProviderOptions cuda_options{};
+                options.AppendExecutionProvider_CUDA(cuda_options);
+                break;
+            }
+            case ExecutionProvider::CoreML:
+                options.AppendExecutionProvider("CoreML", {});
+                break;
+            case ExecutionProvider::OpenVino:
+                options.AppendExecutionProvider_OpenVINO_V2({});
+                break;
+            default:
+                break;
+        }
+    } catch (const Ort::Exception& e) {
+        std::cerr << "⚠️ " << name << " execution provider failed to initialize (" << e.what()
+                  << ") - falling back to cpu\n";
+        return ExecutionProvider::Cpu;
+    }
+    return provider;
+}
+
+Ort::Session create_session(const SessionConfig& config, Ort::SessionOptions& options, ExecutionProvider& provider,
+                            const std::function<void(Ort::SessionOptions&)>& configure,
+                            const std::function<Ort::Session(Ort::SessionOptions&, ExecutionProvider)>& open) {
+    options = Ort::SessionOptions();
+    configure(options);
+    provider = append_execution_provider(options, config);
+    if (provider == ExecutionProvider::Cpu) return open(options, provider);
+    try {
+        return open(options, provider);
+    } catch (const Ort::Exception& e) {
+        // CUDA and OpenVINO usually only find out there is no device here
+        std::cerr << "⚠️ " << execution_provider_name(provider) << " session failed to load (" << e.what()
+                  << ") - falling back to cpu\n";
+    }
+    options = Ort::SessionOptions();
+    configure(options);
+    provider = ExecutionProvider::Cpu;
+    return open(options, provider);
+}
+
+}  // namespace whitelightning
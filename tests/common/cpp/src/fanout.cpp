@@ -0,0 +1,85 @@
+#include "whitelightning/fanout.hpp"
+
+#include <stdexcept>
+
+#include "whitelightning/classifier.hpp"
+#include "whitelightning/labels.hpp"
+#include "whitelightning/metrics.hpp"
+#include "whitelightning/tokenizer.hpp"
+
+namespace whitelightning {
+
+FanOutClassifier::FanOutClassifier(const FanOutModels& models, const SessionConfig& config) {
+    if (!models.binary_dir.empty()) {
+        ModelBundle bundle = ModelBundle::from_directory(models.binary_dir, ModelType::Binary);
+        binary_ = std::make_unique<BinaryClassifier>(bundle.model_path, bundle.vocab_path, bundle.scaler_path, config);
+        binary_binding_ = std::make_unique<BinaryClassifier::Binding>(*binary_);
+        tasks_.push_back([this](FanOutResult& result) {
+            double start = get_time_ms();
+            binary_->preprocess_words_into(words_, binary_binding_->input(1));
+            binary_binding_->run();
+            result.sentiment = binary_binding_->probability(0);
+            result.has_sentiment = true;
+            result.binary_ms = get_time_ms() - start;
+        });
+    }
+    if (!models.topic_dir.empty()) {
+        ModelBundle bundle = ModelBundle::from_directory(models.topic_dir, ModelType::Multiclass);
+        topic_ = std::make_unique<TopicClassifier>(bundle.model_path, bundle.vocab_path, config);
+        topic_binding_ = std::make_unique<TopicClassifier::Binding>(*topic_);
+        topic_labels_ = load_labels(bundle.scaler_path, topic_->num_classes());
+        tasks_.push_back([this](FanOutResult& result) {
+            double start = get_time_ms();
+            topic_->preprocess_tokens_into(scratch_.tokens, *topic_binding_);
+            topic_binding_->run();
+            const float* probabilities = topic_binding_->probabilities(0);
+            result.topic.assign(probabilities, probabilities + topic_->num_classes());
+            result.topic_ms = get_time_ms() - start;
+        });
+    }
+    if (!models.emotion_dir.empty()) {
+        ModelBundle bundle = ModelBundle::from_directory(models.emotion_dir, ModelType::MultiLabel);
+        emotion_ = std::make_unique<EmotionClassifier>(bundle.model_path, bundle.vocab_path, bundle.scaler_path, config);
+        emotion_binding_ = std::make_unique<EmotionClassifier::Binding>(*emotion_);
+        for (size_t i = 0; i < emotion_->num_classes(); i++) {
+            emotion_labels_.push_back(emotion_->label(i));
+        }
+        tasks_.push_back([this](FanOutResult& result) {
+            double start = get_time_ms();
+            emotion_->preprocess_words_into(words_, emotion_binding_->input());
+            emotion_binding_->run();
+            const float* probabilities = emotion_binding_->probabilities();
+            result.emotions.assign(probabilities, probabilities + emotion_->num_classes());
+            result.emotion_ms = get_time_ms() - start;
+        });
+    }
+    if (tasks_.empty()) {
+        throw std::runtime_error("FanOutClassifier needs at least one model directory");
+    }
+    if (tasks_.size() > 1) {
+        pool_ = std::make_unique<WorkerPool>(tasks_.size(), active_cpu_placement().cpus);
+    }
+}
+
+FanOutResult FanOutClassifier::classify(std::string_view text) {
+    FanOutResult result;
+    double start = get_time_ms();
+    if (topic_) {
+        tokenize(text, scratch_);
+    } else {
+        lowercase(text, scratch_.lowered);
+    }
+    if (binary_ || emotion_) {
+        split_words(scratch_.lowered, words_);
+    }
+    result.tokenize_ms = get_time_ms() - start;
+    
+    if (pool_) {
+        pool_->run(tasks_.size(), [&](size_t task, size_t) { tasks_[task](result); });
+    } else {
+        tasks_[0](result);
+    }
+    return result;
+}
+
+}  // namespace whitelightning
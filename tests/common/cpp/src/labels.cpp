@@ -0,0 +1,46 @@
+#include "whitelightning/labels.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+#include <nlohmann/json.hpp>
+
+namespace whitelightning {
+
+using json = nlohmann::json;
+
+std::vector<std::string> load_labels(const std::string& scaler_path) {
+    std::ifstream file(scaler_path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open scaler file: " + scaler_path);
+    }
+    json scaler = json::parse(file);
+    
+    std::vector<std::string> labels;
+    if (scaler.contains("labels")) {
+        labels = scaler["labels"].get<std::vector<std::string>>();
+    } else {
+        labels.resize(scaler.size());
+        for (const auto& [key, value] : scaler.items()) {
+            size_t index = std::stoul(key);
+            if (index >= labels.size()) {
+                throw std::runtime_error("Label index out of range in " + scaler_path + ": " + key);
+            }
+            labels[index] = value.get<std::string>();
+        }
+    }
+    if (labels.empty()) {
+        throw std::runtime_error("No labels in " + scaler_path);
+    }
+    return labels;
+}
+
+std::vector<std::string> load_labels(const std::string& scaler_path, size_t num_classes) {
+    std::vector<std::string> labels = load_labels(scaler_path);
+    for (size_t i = labels.size(); i < num_classes; i++) {
+        labels.push_back(std::to_string(i));
+    }
+    return labels;
+}
+
+}  // namespace whitelightning
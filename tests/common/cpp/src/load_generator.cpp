@@ -0,0 +1,268 @@
+#include "whitelightning/load_generator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "whitelightning/metrics.hpp"
+#include "whitelightning/topology.hpp"
+#include "whitelightning/worker_pool.hpp"
+
+namespace whitelightning {
+
+namespace {
+
+struct Request {
+    size_t text;
+    double arrival_ms;
+};
+
+// Requests waiting for a worker. Closed loop refills it as requests
+// complete, open loop from the arrival thread.
+struct RequestQueue {
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<Request> pending;
+    size_t issued = 0;
+    size_t completed = 0;
+    size_t batches = 0;
+};
+
+LoadPoint run_point(WorkerPool& pool, const LoadSweepConfig& config, int batch_size, int load, size_t num_texts,
+                    const LoadHandler& handler) {
+    const size_t total = static_cast<size_t>(config.requests);
+    RequestQueue queue;
+    std::vector<std::vector<double>> latencies(pool.size());
+    double first_arrival = get_time_ms();
+    std::clock_t cpu_start = std::clock();
+    
+    std::thread arrivals;
+    if (config.open_loop()) {
+        // Exponential gaps at the target rate, scheduled from the start so a
+        // slow Run does not delay later arrivals
+        arrivals = std::thread([&, load]() {
+            std::mt19937_64 rng(config.seed);
+            std::exponential_distribution<double> gap_ms(load / 1000.0);
+            double scheduled = first_arrival;
+            for (size_t i = 0; i < total; i++) {
+                scheduled += gap_ms(rng);
+                double wait_ms = scheduled - get_time_ms();
+                if (wait_ms > 0) {
+                    std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(wait_ms));
+                }
+                {
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+                    queue.pending.push_back({i % num_texts, scheduled});
+                    queue.issued++;
+                }
+                queue.ready.notify_one();
+            }
+        });
+    } else {
+        for (; queue.issued < std::min(total, static_cast<size_t>(load)); queue.issued++) {
+            queue.pending.push_back({queue.issued % num_texts, first_arrival});
+        }
+    }
+    
+    pool.run(pool.size(), [&](size_t, size_t worker) {
+        std::vector<size_t> batch;
+        std::vector<double> arrival_ms;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(queue.mutex);
+                queue.ready.wait(lock, [&]() { return !queue.pending.empty() || queue.completed == total; });
+                if (queue.pending.empty()) return;
+                batch.clear();
+                arrival_ms.clear();
+                while (!queue.pending.empty() && batch.size() < static_cast<size_t>(batch_size)) {
+                    batch.push_back(queue.pending.front().text);
+                    arrival_ms.push_back(queue.pending.front().arrival_ms);
+                    queue.pending.pop_front();
+                }
+                queue.batches++;
+            }
+            
+            handler(worker, Span<const size_t>(batch.data(), batch.size()));
+            double now = get_time_ms();
+            for (double arrival : arrival_ms) {
+                latencies[worker].push_back(now - arrival);
+            }
+            
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.completed += batch.size();
+            if (!config.open_loop()) {
+                // Each client sends its next request as soon as the answer arrives
+                for (size_t i = 0; i < batch.size() && queue.issued < total; i++, queue.issued++) {
+                    queue.pending.push_back({queue.issued % num_texts, now});
+                }
+            }
+            if (queue.completed == total || !queue.pending.empty()) {
+                queue.ready.notify_all();
+            }
+        }
+    });
+    if (arrivals.joinable()) arrivals.join();
+    
+    LoadPoint point;
+    point.workers = static_cast<int>(pool.size());
+    point.batch_size = batch_size;
+    point.load = load;
+    point.requests = total;
+    double wall_ms = get_time_ms() - first_arrival;
+    point.seconds = wall_ms / 1000.0;
+    point.throughput = total * 1000.0 / wall_ms;
+    point.mean_batch = static_cast<double>(total) / std::max<size_t>(1, queue.batches);
+    // std::clock() is process CPU time at microsecond resolution; /proc ticks
+    // are too coarse for points that last a few milliseconds
+    double cpu_seconds = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    point.cpu_percent = cpu_seconds / point.seconds / get_usable_cpu_count() * 100.0;
+    for (const auto& worker_latencies : latencies) {
+        for (double ms : worker_latencies) point.latency.record_ms(ms);
+    }
+    return point;
+}
+
+// Points [begin, end) of one workers x batch series, in increasing load
+size_t saturation_point(const LoadSweepResult& result, size_t begin, size_t end) {
+    if (result.open_loop) {
+        size_t sustained = begin;
+        for (size_t i = begin; i < end; i++) {
+            if (result.points[i].throughput >= 0.95 * result.points[i].load) sustained = i;
+        }
+        return sustained;
+    }
+    double peak = 0;
+    for (size_t i = begin; i < end; i++) peak = std::max(peak, result.points[i].throughput);
+    for (size_t i = begin; i < end; i++) {
+        if (result.points[i].throughput >= 0.95 * peak) return i;
+    }
+    return begin;
+}
+
+}  // namespace
+
+std::vector<int> load_sweep_workers(const LoadSweepConfig& config) {
+    if (!config.workers.empty()) return config.workers;
+    int cpus = get_usable_cpu_count();
+    std::vector<int> workers;
+    for (int count = 1; count < cpus; count *= 2) {
+        workers.push_back(count);
+    }
+    workers.push_back(cpus);
+    return workers;
+}
+
+LoadSweepResult run_load_sweep(const LoadSweepConfig& config, size_t num_texts, const LoadHandler& handler) {
+    LoadSweepResult result;
+    result.open_loop = config.open_loop();
+    result.requests = config.requests;
+    std::vector<int> loads = result.open_loop ? config.qps : config.concurrency;
+    std::sort(loads.begin(), loads.end());
+    
+    for (int workers : load_sweep_workers(config)) {
+        WorkerPool pool(workers, active_cpu_placement().cpus);
+        for (int batch_size : config.batch_sizes) {
+            // Warm every worker's binding at this batch size
+            std::vector<size_t> warmup(batch_size);
+            for (size_t i = 0; i < warmup.size(); i++) warmup[i] = i % num_texts;
+            pool.run(pool.size(), [&](size_t, size_t worker) {
+                handler(worker, Span<const size_t>(warmup.data(), warmup.size()));
+            });
+            
+            size_t series_begin = result.points.size();
+            for (int load : loads) {
+                result.points.push_back(run_point(pool, config, batch_size, load, num_texts, handler));
+            }
+            result.saturation.push_back(saturation_point(result, series_begin, result.points.size()));
+        }
+    }
+    return result;
+}
+
+void print_load_sweep(const LoadSweepResult& result) {
+    std::cout << "\n📈 LOAD SWEEP (" << (result.open_loop ? "open loop, Poisson arrivals" : "closed loop") << ", "
+              << result.requests << " requests per point)\n";
+    std::cout << "============================================================\n";
+    std::cout << "   Workers  Batch  " << (result.open_loop ? "Target/s" : " Clients") << "    Texts/sec"
+              << "     p50 ms     p99 ms  Mean batch    CPU\n";
+    size_t series = 0;
+    for (size_t i = 0; i < result.points.size(); i++) {
+        const LoadPoint& point = result.points[i];
+        bool saturated = series < result.saturation.size() && result.saturation[series] == i;
+        std::cout << "   " << std::setw(7) << point.workers << std::setw(7) << point.batch_size << std::setw(10)
+                  << point.load << std::fixed << std::setprecision(1) << std::setw(13) << point.throughput
+                  << std::setprecision(3) << std::setw(11) << point.latency.percentile_ms(50) << std::setw(11)
+                  << point.latency.percentile_ms(99) << std::setprecision(1) << std::setw(12) << point.mean_batch
+                  << std::setw(6) << point.cpu_percent << "%" << (saturated ? "  ◀ saturation" : "") << "\n";
+        bool series_end = i + 1 == result.points.size() || result.points[i + 1].workers != point.workers ||
+                          result.points[i + 1].batch_size != point.batch_size;
+        if (series_end) series++;
+    }
+    
+    // The best series is the one whose saturation point has the highest throughput
+    size_t best = result.saturation.empty() ? 0 : result.saturation[0];
+    for (size_t index : result.saturation) {
+        if (result.points[index].throughput > result.points[best].throughput) best = index;
+    }
+    if (!result.points.empty()) {
+        const LoadPoint& point = result.points[best];
+        std::cout << "\n🏁 Saturation: " << std::setprecision(1) << point.throughput << " texts/sec with "
+                  << point.workers << (point.workers == 1 ? " worker" : " workers") << ", batch " << point.batch_size
+                  << " at " << point.load << (result.open_loop ? " QPS offered" : " clients") << " (p99 "
+                  << std::setprecision(3) << point.latency.percentile_ms(99) << "ms)\n";
+    }
+}
+
+json load_sweep_report(const std::string& name, const Corpus& corpus, const LoadSweepResult& result,
+                       const SystemInfo& system_info) {
+    json points = json::array();
+    for (const LoadPoint& point : result.points) {
+        points.push_back({
+            {"workers", point.workers},
+            {"batch_size", point.batch_size},
+            {result.open_loop ? "target_qps" : "concurrency", point.load},
+            {"requests", point.requests},
+            {"seconds", point.seconds},
+            {"throughput_per_sec", point.throughput},
+            {"mean_batch", point.mean_batch},
+            {"cpu_percent", point.cpu_percent},
+            {"latency_ms", latency_summary(point.latency)}
+        });
+    }
+    return {
+        {"model", name},
+        {"mode", result.open_loop ? "open_loop" : "closed_loop"},
+        {"corpus", {{"source", corpus.source}, {"texts", corpus.texts.size()}}},
+        {"requests_per_point", result.requests},
+        {"points", points},
+        {"saturation", result.saturation},
+        {"system", system_report(system_info)}
+    };
+}
+
+bool parse_count_list(std::string_view text, std::vector<int>& values) {
+    values.clear();
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = std::min(text.find(',', start), text.size());
+        std::string_view item = text.substr(start, end - start);
+        if (item.empty() || item.size() > 9 ||
+            !std::all_of(item.begin(), item.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            return false;
+        }
+        int value = std::stoi(std::string(item));
+        if (value < 1) return false;
+        values.push_back(value);
+        start = end + 1;
+    }
+    return !values.empty();
+}
+
+}  // namespace whitelightning
@@ -0,0 +1,329 @@
+#include "whitelightning/metrics.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include "whitelightning/topology.hpp"
+
+#ifdef __APPLE__
+#include <sys/sysctl.h>
+#include <mach/mach.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#elif __linux__
+#include <sys/sysinfo.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+namespace whitelightning {
+
+CPUMonitor g_cpu_monitor;
+
+double get_time_ms() {
+    auto now = std::chrono::high_resolution_clock::now();
+    auto duration = now.time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count() / 1000.0;
+}
+
+double get_memory_usage_mb() {
+#ifdef __APPLE__
+    struct mach_task_basic_info info;
+    mach_msg_type_number_t infoCount = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &infoCount) != KERN_SUCCESS) {
+        return 0.0;
+    }
+    return info.resident_size / (1024.0 * 1024.0);
+#elif __linux__
+    // /proc/self/statm is "size resident shared ..." in pages; one read, no line parsing
+    char buffer[128];
+    int fd = open("/proc/self/statm", O_RDONLY);
+    if (fd < 0) {
+        return 0.0;
+    }
+    ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (length <= 0) {
+        return 0.0;
+    }
+    buffer[length] = '\0';
+    unsigned long size_pages = 0, resident_pages = 0;
+    if (std::sscanf(buffer, "%lu %lu", &size_pages, &resident_pages) != 2) {
+        return 0.0;
+    }
+    return resident_pages * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+#endif
+    return 0.0;
+}
+
+double get_peak_memory_mb() {
+#if defined(__APPLE__) || defined(__linux__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0.0;
+    }
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0);  // bytes
+#else
+    return usage.ru_maxrss / 1024.0;  // KB
+#endif
+#endif
+    return 0.0;
+}
+
+double get_process_cpu_seconds() {
+#ifdef __linux__
+    // Fields after the parenthesised command name: state is field 3,
+    // utime and stime (in clock ticks) are fields 14 and 15
+    char buffer[1024];
+    int fd = open("/proc/self/stat", O_RDONLY);
+    if (fd < 0) {
+        return 0.0;
+    }
+    ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (length <= 0) {
+        return 0.0;
+    }
+    buffer[length] = '\0';
+    const char* fields = std::strrchr(buffer, ')');
+    if (fields == nullptr) {
+        return 0.0;
+    }
+    unsigned long long utime = 0, stime = 0;
+    if (std::sscanf(fields + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu", &utime, &stime) != 2) {
+        return 0.0;
+    }
+    return static_cast<double>(utime + stime) / sysconf(_SC_CLK_TCK);
+#elif defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0.0;
+    }
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+#endif
+    return 0.0;
+}
+
+int get_online_cpu_count() {
+#if defined(__APPLE__) || defined(__linux__)
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? static_cast<int>(count) : 1;
+#else
+    return 1;
+#endif
+}
+
+int get_usable_cpu_count() {
+    const CpuPlacement& placement = active_cpu_placement();
+    return placement.empty() ? get_online_cpu_count() : static_cast<int>(placement.cpus.size());
+}
+
+void get_system_info(SystemInfo& info) {
+#ifdef __APPLE__
+    info.platform = "macOS";
+    
+    size_t size = 256;
+    char processor[256];
+    if (sysctlbyname("machdep.cpu.brand_string", processor, &size, NULL, 0) == 0) {
+        info.processor = processor;
+    }
+    
+    size = sizeof(int);
+    sysctlbyname("hw.physicalcpu", &info.cpu_count_physical, &size, NULL, 0);
+    sysctlbyname("hw.logicalcpu", &info.cpu_count_logical, &size, NULL, 0);
+    info.cpu_packages = cpu_topology().packages;
+    
+    uint64_t memsize;
+    size = sizeof(memsize);
+    sysctlbyname("hw.memsize", &memsize, &size, NULL, 0);
+    info.total_memory_gb = memsize / (1024.0 * 1024.0 * 1024.0);
+    
+#elif __linux__
+    info.platform = "Linux";
+    const CpuTopology& topology = cpu_topology();
+    info.cpu_count_physical = topology.physical_cores;
+    info.cpu_count_logical = topology.logical_cpus();
+    info.cpu_packages = topology.packages;
+    info.numa_nodes = topology.numa_nodes;
+    
+    // Get memory info
+    std::ifstream meminfo("/proc/meminfo");
+    std::string line;
+    while (std::getline(meminfo, line)) {
+        if (line.substr(0, 9) == "MemTotal:") {
+            std::istringstream iss(line);
+            std::string label, unit;
+            long mem_kb;
+            iss >> label >> mem_kb >> unit;
+            info.total_memory_gb = mem_kb / (1024.0 * 1024.0);
+            break;
+        }
+    }
+    
+    // Get processor info
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    while (std::getline(cpuinfo, line)) {
+        if (line.substr(0, 10) == "model name") {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                info.processor = line.substr(colon + 2);
+            }
+            break;
+        }
+    }
+#else
+    info.platform = "Unknown";
+    info.processor = "Unknown";
+    info.cpu_count_physical = 1;
+    info.cpu_count_logical = 1;
+    info.total_memory_gb = 0.0;
+#endif
+}
+
+// Each sample is the process CPU time over the last interval as a percent of
+// the usable cores
+void cpu_monitor_thread() {
+    const double cores = get_usable_cpu_count();
+    double last_cpu = g_cpu_monitor.cpu_start_seconds;
+    double last_wall = g_cpu_monitor.wall_start_seconds;
+    std::unique_lock<std::mutex> lock(g_cpu_monitor.mutex);
+    while (g_cpu_monitor.monitoring.load()) {
+        g_cpu_monitor.wake.wait_for(lock, std::chrono::milliseconds(g_cpu_monitor.interval_ms),
+                                    []() { return !g_cpu_monitor.monitoring.load(); });
+        double cpu = get_process_cpu_seconds();
+        double wall = get_time_ms() / 1000.0;
+        if (wall > last_wall) {
+            g_cpu_monitor.cpu_readings.push_back((cpu - last_cpu) / (wall - last_wall) / cores * 100.0);
+        }
+        last_cpu = cpu;
+        last_wall = wall;
+    }
+}
+
+void start_cpu_monitoring() {
+    g_cpu_monitor.cpu_readings.clear();
+    g_cpu_monitor.cpu_start_seconds = get_process_cpu_seconds();
+    g_cpu_monitor.wall_start_seconds = get_time_ms() / 1000.0;
+    g_cpu_monitor.monitoring = true;
+    g_cpu_monitor.monitor_thread = std::thread(cpu_monitor_thread);
+}
+
+void stop_cpu_monitoring(ResourceMetrics& metrics) {
+    {
+        std::lock_guard<std::mutex> lock(g_cpu_monitor.mutex);
+        g_cpu_monitor.monitoring = false;
+    }
+    g_cpu_monitor.wake.notify_all();
+    if (g_cpu_monitor.monitor_thread.joinable()) {
+        g_cpu_monitor.monitor_thread.join();
+    }
+    
+    metrics.cpu_seconds = get_process_cpu_seconds() - g_cpu_monitor.cpu_start_seconds;
+    metrics.wall_seconds = get_time_ms() / 1000.0 - g_cpu_monitor.wall_start_seconds;
+    metrics.memory_peak_mb = get_peak_memory_mb();
+    
+    std::lock_guard<std::mutex> lock(g_cpu_monitor.mutex);
+    metrics.cpu_readings = g_cpu_monitor.cpu_readings;
+    metrics.cpu_readings_count = g_cpu_monitor.cpu_readings.size();
+    
+    // The average comes from the whole window so short runs still report it
+    if (metrics.wall_seconds > 0) {
+        metrics.cpu_avg_percent = metrics.cpu_seconds / metrics.wall_seconds / get_usable_cpu_count() * 100.0;
+    }
+    metrics.cpu_max_percent = metrics.cpu_avg_percent;
+    for (double reading : g_cpu_monitor.cpu_readings) {
+        metrics.cpu_max_percent = std::max(metrics.cpu_max_percent, reading);
+    }
+}
+
+void print_system_info(const SystemInfo& info) {
+    std::cout << "💻 SYSTEM INFORMATION:\n";
+    std::cout << "   Platform: " << info.platform << "\n";
+    std::cout << "   Processor: " << info.processor << "\n";
+    std::cout << "   CPU Cores: " << info.cpu_count_physical << " physical, " << info.cpu_count_logical << " logical";
+    if (info.cpu_packages > 1 || info.numa_nodes > 1) {
+        std::cout << " (" << info.cpu_packages << " sockets, " << info.numa_nodes << " NUMA nodes)";
+    }
+    std::cout << "\n";
+    const CpuPlacement& placement = active_cpu_placement();
+    if (!placement.empty()) {
+        std::cout << "   Pinned CPUs: " << format_cpu_list(placement.cpus) << " (--pin " << placement.spec << ")\n";
+    }
+    std::cout << "   Total Memory: " << std::fixed << std::setprecision(1) << info.total_memory_gb << " GB\n";
+    std::cout << "   Runtime: " << info.runtime << "\n\n";
+}
+
+void print_result_cache_stats(const ResultCacheStats& cache) {
+    std::cout << "🗃️ RESULT CACHE:\n";
+    std::cout << "   Hits: " << cache.hits << ", Misses: " << cache.misses << " (" << std::fixed
+              << std::setprecision(1) << cache.hit_rate() * 100.0 << "% hit rate)\n";
+    std::cout << "   Entries: " << cache.entries << " (" << std::setprecision(1) << cache.bytes / 1024.0 << " KB), Evictions: "
+              << cache.evictions << "\n\n";
+}
+
+void print_performance_summary(const TimingMetrics& timing, const ResourceMetrics& resources,
+                               const ResultCacheStats* cache) {
+    std::cout << "📈 PERFORMANCE SUMMARY:\n";
+    std::cout << "   Total Processing Time: " << std::fixed << std::setprecision(2) << timing.total_time_ms << "ms\n";
+    std::cout << "   ┣━ Preprocessing: " << timing.preprocessing_time_ms << "ms (" 
+              << std::setprecision(1) << (timing.preprocessing_time_ms / timing.total_time_ms) * 100.0 << "%)\n";
+    std::cout << "   ┣━ Model Inference: " << std::setprecision(2) << timing.inference_time_ms << "ms (" 
+              << std::setprecision(1) << (timing.inference_time_ms / timing.total_time_ms) * 100.0 << "%)\n";
+    std::cout << "   ┗━ Postprocessing: " << std::setprecision(2) << timing.postprocessing_time_ms << "ms (" 
+              << std::setprecision(1) << (timing.postprocessing_time_ms / timing.total_time_ms) * 100.0 << "%)\n\n";
+    
+    std::cout << "🚀 THROUGHPUT:\n";
+    std::cout << "   Texts per second: " << std::setprecision(1) << timing.throughput_per_sec << "\n\n";
+    
+    std::cout << "💾 RESOURCE USAGE:\n";
+    std::cout << "   Memory Start: " << std::setprecision(2) << resources.memory_start_mb << " MB\n";
+    std::cout << "   Memory End: " << resources.memory_end_mb << " MB\n";
+    std::cout << "   Memory Delta: " << std::showpos << resources.memory_delta_mb << " MB\n" << std::noshowpos;
+    std::cout << "   Peak RSS: " << resources.memory_peak_mb << " MB\n";
+    std::cout << "   CPU Time: " << std::setprecision(3) << resources.cpu_seconds * 1000.0 << "ms\n";
+    std::cout << "   CPU Usage: " << std::setprecision(1) << resources.cpu_avg_percent << "% avg, " 
+              << resources.cpu_max_percent << "% peak of " << get_usable_cpu_count() << " cores (" 
+              << resources.cpu_readings_count << " samples)\n";
+    std::cout << "\n";
+    
+    if (timing.startup.total_ms() > 0) print_startup_timing(timing.startup);
+    if (cache) print_result_cache_stats(*cache);
+    
+    // Performance classification
+    std::string performance_class, emoji;
+    if (timing.total_time_ms < 50) {
+        performance_class = "EXCELLENT";
+        emoji = "🚀";
+    } else if (timing.total_time_ms < 100) {
+        performance_class = "GOOD";
+        emoji = "✅";
+    } else if (timing.total_time_ms < 200) {
+        performance_class = "ACCEPTABLE";
+        emoji = "⚠️";
+    } else {
+        performance_class = "POOR";
+        emoji = "❌";
+    }
+    
+    std::cout << "🎯 PERFORMANCE RATING: " << emoji << " " << performance_class << "\n";
+    std::cout << "   (" << std::setprecision(1) << timing.total_time_ms << "ms steady-state total - Target: <100ms)\n\n";
+}
+
+void print_startup_timing(const StartupTiming& startup) {
+    std::cout << "🧊 STARTUP (once per process, not in the total above):\n";
+    std::cout << "   Total: " << std::fixed << std::setprecision(2) << startup.total_ms() << "ms\n";
+    std::cout << "   ┣━ Env Init: " << startup.env_init_ms << "ms\n";
+    std::cout << "   ┣━ Vocab Load: " << startup.vocab_load_ms << "ms\n";
+    std::cout << "   ┣━ Session Load: " << startup.session_load_ms << "ms\n";
+    std::cout << "   ┗━ First Run (warmup): " << startup.first_run_ms << "ms\n\n";
+}
+
+}  // namespace whitelightning
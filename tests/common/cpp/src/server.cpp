@@ -0,0 +1,558 @@
+#include "whitelightning/server.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "whitelightning/benchmark.hpp"
+#include "whitelightning/latency_histogram.hpp"
+#include "whitelightning/metrics.hpp"
+#include "whitelightning/stream_io.hpp"
+#include "whitelightning/trace.hpp"
+
+namespace whitelightning {
+
+#ifdef _WIN32
+
+int run_server(const ServerConfig&, const BatchHandler&) {
+    throw std::runtime_error("Server mode needs POSIX sockets");
+}
+
+#else
+
+namespace {
+
+constexpr uint32_t kMaxFrameBytes = 1 << 20;
+
+std::atomic<bool> g_stop{false};
+
+void handle_stop_signal(int) { g_stop = true; }
+
+bool read_exact(int fd, char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::recv(fd, data, size, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool write_exact(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::send(fd, data, size, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Replies waiting for a connection's writer thread, so the batching thread
+// never blocks on a socket. Owns the fd: the writer drains what is queued
+// after the connection closes and releases it last.
+struct Outbox {
+    explicit Outbox(int fd) : fd(fd) {}
+    ~Outbox() { ::close(fd); }
+    
+    // Under mutex: stop queueing and unblock the reader with a full shutdown
+    void drop() {
+        dropped = true;
+        frames.clear();
+        bytes = 0;
+        ::shutdown(fd, SHUT_RDWR);
+    }
+    
+    const int fd;
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<std::string> frames;
+    size_t bytes = 0;
+    bool closed = false;   // no more frames coming
+    bool dropped = false;  // client stopped reading
+};
+
+// One client socket. Its reader thread and the batching thread share it,
+// and a writer thread sends the replies both queue. A client that stops
+// reading is dropped once kMaxOutboxBytes are queued or a send blocks for
+// kSendTimeoutMs, instead of stalling every other connection.
+class Connection {
+public:
+    Connection(int fd, std::atomic<int>& active_writers) : outbox_(std::make_shared<Outbox>(fd)) {
+        timeval timeout{kSendTimeoutMs / 1000, (kSendTimeoutMs % 1000) * 1000};
+        ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        active_writers++;
+        std::thread([outbox = outbox_, &active_writers]() {
+            write_loop(*outbox);
+            active_writers--;
+        }).detach();
+    }
+    
+    ~Connection() {
+        {
+            std::lock_guard<std::mutex> lock(outbox_->mutex);
+            outbox_->closed = true;
+        }
+        outbox_->ready.notify_one();
+    }
+    
+    int fd() const { return outbox_->fd; }
+    
+    // Read one length-prefixed frame; false on EOF, error or oversized frame
+    bool read_frame(std::string& payload) {
+        unsigned char header[4];
+        if (!read_exact(fd(), reinterpret_cast<char*>(header), sizeof(header))) return false;
+        uint32_t length = (uint32_t{header[0]} << 24) | (uint32_t{header[1]} << 16) | (uint32_t{header[2]} << 8) | header[3];
+        if (length > kMaxFrameBytes) {
+            send_frame("{\"error\":\"frame larger than 1 MiB\"}");
+            return false;
+        }
+        payload.resize(length);
+        return read_exact(fd(), payload.data(), length);
+    }
+    
+    // Queue one reply; false once the client has been dropped
+    bool send_frame(const std::string& payload) {
+        uint32_t length = static_cast<uint32_t>(payload.size());
+        std::string frame = {static_cast<char>(length >> 24), static_cast<char>(length >> 16),
+                             static_cast<char>(length >> 8), static_cast<char>(length)};
+        frame += payload;
+        {
+            std::lock_guard<std::mutex> lock(outbox_->mutex);
+            if (outbox_->dropped) return false;
+            if (outbox_->bytes + frame.size() > kMaxOutboxBytes) {
+                outbox_->drop();
+                return false;
+            }
+            outbox_->bytes += frame.size();
+            outbox_->frames.push_back(std::move(frame));
+        }
+        outbox_->ready.notify_one();
+        return true;
+    }
+    
+private:
+    static constexpr size_t kMaxOutboxBytes = 16 << 20;
+    static constexpr int kSendTimeoutMs = 1000;
+    
+    static void write_loop(Outbox& outbox) {
+        std::unique_lock<std::mutex> lock(outbox.mutex);
+        while (true) {
+            outbox.ready.wait(lock, [&]() { return outbox.closed || outbox.dropped || !outbox.frames.empty(); });
+            if (outbox.dropped || outbox.frames.empty()) return;
+            std::string frame = std::move(outbox.frames.front());
+            outbox.frames.pop_front();
+            outbox.bytes -= frame.size();
+            lock.unlock();
+            bool sent = write_exact(outbox.fd, frame.data(), frame.size());
+            lock.lock();
+            if (!sent) {
+                // Timed out (SO_SNDTIMEO) or the client went away
+                outbox.drop();
+                return;
+            }
+        }
+    }
+    
+    std::shared_ptr<Outbox> outbox_;
+};
+
+struct Request {
+    std::shared_ptr<Connection> connection;
+    StreamInput input;
+    double enqueue_ms = 0;
+};
+
+// Coalesces queued requests into micro-batches on one thread. A batch closes
+// when it reaches batch_limit or its oldest request has waited window_ms.
+// The window adapts after every epoch (64 responses or 100ms): halved when
+// the epoch's p99 is over the SLO, grown by 5% of the SLO while p99 is under
+// 80% of it. The batch limit follows inference time instead: batches that
+// take over half the SLO to run shrink it, full batches under a quarter of
+// the SLO grow it, so a backlog drains in large batches.
+class Batcher {
+public:
+    Batcher(const ServerConfig& config, const BatchHandler& handler)
+        : config_(config), handler_(handler), window_ms_(config.slo_ms * 0.1),
+          batch_limit_(std::max<size_t>(1, config.max_batch)), batch_sizes_(batch_limit_ + 1, 0),
+          start_ms_(get_time_ms()), epoch_start_ms_(start_ms_) {}
+    
+    void submit(Request request) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            queue_.push_back(std::move(request));
+            max_queue_depth_ = std::max(max_queue_depth_, queue_.size());
+        }
+        queue_ready_.notify_one();
+    }
+    
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            stopping_ = true;
+        }
+        queue_ready_.notify_all();
+    }
+    
+    void run() {
+        std::vector<Request> batch;
+        std::vector<std::string_view> texts;
+        std::vector<std::string> results;
+        while (next_batch(batch)) {
+            texts.clear();
+            for (const Request& request : batch) {
+                if (request.input.error.empty()) texts.push_back(request.input.text);
+            }
+            results.assign(texts.size(), std::string());
+            std::string batch_error;
+            double run_start = get_time_ms();
+            if (!texts.empty()) {
+                try {
+                    TraceSpan span("batch");
+                    handler_(Span<const std::string_view>(texts.data(), texts.size()), results);
+                } catch (const std::exception& e) {
+                    batch_error = e.what();
+                }
+            }
+            TraceSpan span("respond");
+            respond(batch, results, batch_error, get_time_ms() - run_start);
+        }
+    }
+    
+    json stats() const {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        json batch_sizes = json::object();
+        for (size_t size = 1; size < batch_sizes_.size(); size++) {
+            if (batch_sizes_[size]) batch_sizes[std::to_string(size)] = batch_sizes_[size];
+        }
+        size_t queue_depth, max_queue_depth;
+        double window_ms;
+        size_t batch_limit;
+        {
+            std::lock_guard<std::mutex> queue_lock(queue_mutex_);
+            queue_depth = queue_.size();
+            max_queue_depth = max_queue_depth_;
+            window_ms = window_ms_;
+            batch_limit = batch_limit_;
+        }
+        return {
+            {"uptime_s", (get_time_ms() - start_ms_) / 1000.0},
+            {"requests", requests_},
+            {"errors", errors_},
+            {"batches", batches_},
+            {"throughput_per_sec", throughput_per_sec_},
+            {"queue_depth", queue_depth},
+            {"max_queue_depth", max_queue_depth},
+            {"slo_ms", config_.slo_ms},
+            {"window_ms", window_ms},
+            {"batch_limit", batch_limit},
+            {"slo_violations", slo_violations_},
+            {"latency_ms", latency_summary(latency_)},
+            {"batch_run_ms", latency_summary(batch_run_)},
+            {"batch_sizes", batch_sizes}
+        };
+    }
+    
+    void print_stats() const {
+        json s = stats();
+        std::cerr << "📡 " << s["requests"].get<uint64_t>() << " requests, " << std::fixed << std::setprecision(1)
+                  << s["throughput_per_sec"].get<double>() << "/s, queue " << s["queue_depth"].get<size_t>()
+                  << " (max " << s["max_queue_depth"].get<size_t>() << "), p99 " << std::setprecision(3)
+                  << s["latency_ms"]["p99"].get<double>() << "ms, window " << s["window_ms"].get<double>()
+                  << "ms, batch <= " << s["batch_limit"].get<size_t>() << ", sizes " << s["batch_sizes"].dump() << "\n";
+    }
+    
+private:
+    // Block for the next batch; false once stopped and drained
+    bool next_batch(std::vector<Request>& batch) {
+        batch.clear();
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        queue_ready_.wait(lock, [&]() { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) return false;
+        
+        double deadline = queue_.front().enqueue_ms + window_ms_;
+        while (!stopping_ && queue_.size() < batch_limit_) {
+            double now = get_time_ms();
+            if (now >= deadline) break;
+            queue_ready_.wait_for(lock, std::chrono::duration<double, std::milli>(deadline - now));
+        }
+        
+        size_t count = std::min(queue_.size(), batch_limit_);
+        double now = get_time_ms();
+        for (size_t i = 0; i < count; i++) {
+            // Time from arrival until the request joined this batch
+            record_trace_span("queue", queue_.front().enqueue_ms, now);
+            batch.push_back(std::move(queue_.front()));
+            queue_.pop_front();
+        }
+        return true;
+    }
+    
+    void respond(std::vector<Request>& batch, const std::vector<std::string>& results, const std::string& batch_error,
+                 double run_ms) {
+        double now = get_time_ms();
+        std::string response;
+        size_t result = 0;
+        uint64_t errors = 0;
+        for (Request& request : batch) {
+            std::string error = request.input.error;
+            if (error.empty() && !batch_error.empty()) error = batch_error;
+            
+            response = "{";
+            if (!request.input.id.empty()) response += "\"id\":" + request.input.id + ",";
+            if (error.empty()) {
+                response += results[result];
+                response += ",";
+            } else {
+                response += "\"error\":" + json(error).dump() + ",";
+                errors++;
+            }
+            if (request.input.error.empty()) result++;
+            response += "\"latency_ms\":" + std::to_string(now - request.enqueue_ms) + "}";
+            request.connection->send_frame(response);
+        }
+        
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        for (const Request& request : batch) {
+            latency_.record_ms(now - request.enqueue_ms);
+            epoch_latency_.record_ms(now - request.enqueue_ms);
+        }
+        requests_ += batch.size();
+        errors_ += errors;
+        batches_++;
+        batch_sizes_[std::min(batch.size(), batch_sizes_.size() - 1)]++;
+        batch_run_.record_ms(run_ms);
+        {
+            std::lock_guard<std::mutex> queue_lock(queue_mutex_);
+            if (run_ms > config_.slo_ms * 0.5 && batch.size() > 1) {
+                batch_limit_ = std::max<size_t>(1, batch.size() * 3 / 4);
+            } else if (batch.size() >= batch_limit_ && run_ms < config_.slo_ms * 0.25) {
+                batch_limit_ = std::min(std::max<size_t>(1, config_.max_batch), batch_limit_ + std::max<size_t>(1, batch_limit_ / 4));
+            }
+        }
+        
+        double epoch_ms = now - epoch_start_ms_;
+        if (epoch_latency_.count() >= 64 || epoch_ms >= 100.0) adapt(now, epoch_ms);
+    }
+    
+    // Epoch end, called with stats_mutex_ held
+    void adapt(double now, double epoch_ms) {
+        double p99 = epoch_latency_.percentile_ms(99);
+        throughput_per_sec_ = epoch_ms > 0 ? epoch_latency_.count() * 1000.0 / epoch_ms : 0.0;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            if (p99 > config_.slo_ms) {
+                slo_violations_++;
+                window_ms_ *= 0.5;
+            } else if (p99 < config_.slo_ms * 0.8) {
+                window_ms_ = std::min(config_.slo_ms * 0.5, window_ms_ + config_.slo_ms * 0.05);
+            }
+        }
+        epoch_latency_ = LatencyHistogram();
+        epoch_start_ms_ = now;
+    }
+    
+    const ServerConfig& config_;
+    const BatchHandler& handler_;
+    
+    mutable std::mutex queue_mutex_;
+    std::condition_variable queue_ready_;
+    std::deque<Request> queue_;
+    bool stopping_ = false;
+    size_t max_queue_depth_ = 0;
+    double window_ms_;
+    size_t batch_limit_;
+    
+    mutable std::mutex stats_mutex_;
+    LatencyHistogram latency_;
+    LatencyHistogram epoch_latency_;
+    LatencyHistogram batch_run_;
+    std::vector<uint64_t> batch_sizes_;
+    uint64_t requests_ = 0;
+    uint64_t errors_ = 0;
+    uint64_t batches_ = 0;
+    uint64_t slo_violations_ = 0;
+    double throughput_per_sec_ = 0.0;
+    double start_ms_;
+    double epoch_start_ms_;
+};
+
+int listen_unix(const std::string& path) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Unix socket path too long: " + path);
+    }
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) throw std::runtime_error("socket() failed: " + std::string(std::strerror(errno)));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    ::unlink(path.c_str());
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(fd, 128) < 0) {
+        std::string error = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error("Failed to listen on " + path + ": " + error);
+    }
+    return fd;
+}
+
+int listen_tcp(const std::string& host, int port) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if (::inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+        throw std::runtime_error("Invalid IPv4 listen address: " + host);
+    }
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) throw std::runtime_error("socket() failed: " + std::string(std::strerror(errno)));
+    int on = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(fd, 128) < 0) {
+        std::string error = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error("Failed to listen on " + host + ":" + std::to_string(port) + ": " + error);
+    }
+    return fd;
+}
+
+bool is_stats_request(const std::string& payload) {
+    if (payload.find("\"op\"") == std::string::npos) return false;
+    try {
+        json request = json::parse(payload);
+        return request.value("op", "") == "stats";
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+}  // namespace
+
+int run_server(const ServerConfig& config, const BatchHandler& handler) {
+    if (config.unix_path.empty() && config.tcp_port == 0) {
+        throw std::runtime_error("--serve needs --listen-unix PATH and/or --listen-tcp [HOST:]PORT");
+    }
+    
+    std::vector<pollfd> listeners;
+    int tcp_listener = -1;
+    if (!config.unix_path.empty()) {
+        listeners.push_back({listen_unix(config.unix_path), POLLIN, 0});
+        std::cout << "🔌 Listening on unix:" << config.unix_path << "\n";
+    }
+    if (config.tcp_port != 0) {
+        tcp_listener = listen_tcp(config.tcp_host, config.tcp_port);
+        listeners.push_back({tcp_listener, POLLIN, 0});
+        std::cout << "🔌 Listening on tcp:" << config.tcp_host << ":" << config.tcp_port << "\n";
+    }
+    std::cout << "🎯 p99 target " << config.slo_ms << "ms, batches of up to " << config.max_batch << " (Ctrl-C to stop)\n";
+    std::cout.flush();
+    
+    g_stop = false;
+    std::signal(SIGINT, handle_stop_signal);
+    std::signal(SIGTERM, handle_stop_signal);
+    std::signal(SIGPIPE, SIG_IGN);
+    
+    Batcher batcher(config, handler);
+    std::thread batching([&]() { batcher.run(); });
+    
+    std::mutex connections_mutex;
+    std::vector<std::weak_ptr<Connection>> connections;
+    std::atomic<int> active_readers{0};
+    std::atomic<int> active_writers{0};
+    
+    double last_stats_ms = get_time_ms();
+    while (!g_stop) {
+        int ready = ::poll(listeners.data(), listeners.size(), 200);
+        if (ready < 0 && errno != EINTR) break;
+        for (pollfd& listener : listeners) {
+            if (ready <= 0 || !(listener.revents & POLLIN)) continue;
+            int fd = ::accept(listener.fd, nullptr, nullptr);
+            if (fd < 0) continue;
+            if (listener.fd == tcp_listener) {
+                int on = 1;
+                ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            }
+            auto connection = std::make_shared<Connection>(fd, active_writers);
+            {
+                std::lock_guard<std::mutex> lock(connections_mutex);
+                connections.erase(std::remove_if(connections.begin(), connections.end(),
+                                                 [](const std::weak_ptr<Connection>& c) { return c.expired(); }),
+                                  connections.end());
+                connections.push_back(connection);
+            }
+            
+            active_readers++;
+            std::thread([connection, &batcher, &active_readers]() {
+                std::string payload;
+                while (!g_stop && connection->read_frame(payload)) {
+                    if (is_stats_request(payload)) {
+                        connection->send_frame(batcher.stats().dump());
+                        continue;
+                    }
+                    Request request;
+                    request.connection = connection;
+                    if (!parse_stream_line(payload, request.input)) request.input.error = "empty request";
+                    request.enqueue_ms = get_time_ms();
+                    batcher.submit(std::move(request));
+                }
+                active_readers--;
+            }).detach();
+        }
+        
+        if (config.stats_interval_s > 0 && get_time_ms() - last_stats_ms >= config.stats_interval_s * 1000.0) {
+            batcher.print_stats();
+            last_stats_ms = get_time_ms();
+        }
+    }
+    
+    // Stop accepting, unblock the readers, then drain the queue
+    std::cout << "\n🛑 Shutting down...\n";
+    for (pollfd& listener : listeners) {
+        ::close(listener.fd);
+    }
+    if (!config.unix_path.empty()) ::unlink(config.unix_path.c_str());
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        for (auto& weak : connections) {
+            if (auto connection = weak.lock()) ::shutdown(connection->fd(), SHUT_RD);
+        }
+    }
+    while (active_readers > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    batcher.stop();
+    batching.join();
+    // Every connection is gone now; let the writers flush the last replies
+    while (active_writers > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    batcher.print_stats();
+    return 0;
+}
+
+#endif
+
+}  // namespace whitelightning
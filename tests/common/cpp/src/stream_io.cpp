@@ -0,0 +1,31 @@
+#include "whitelightning/stream_io.hpp"
+
+#include <exception>
+#include <nlohmann/json.hpp>
+
+namespace whitelightning {
+
+using json = nlohmann::json;
+
+bool parse_stream_line(const std::string& line, StreamInput& input) {
+    input.id.clear();
+    input.error.clear();
+    size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos) return false;
+    if (line[first] != '{') {
+        size_t last = line.find_last_not_of("\r");
+        input.text.assign(line, 0, last + 1);
+        return true;
+    }
+    try {
+        json record = json::parse(line);
+        input.text = record.at("text").get<std::string>();
+        if (record.contains("id")) input.id = record["id"].dump();
+    } catch (const std::exception& e) {
+        input.text.clear();
+        input.error = e.what();
+    }
+    return true;
+}
+
+}  // namespace whitelightning
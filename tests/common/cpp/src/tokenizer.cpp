@@ -0,0 +1,548 @@
+#include "whitelightning/tokenizer.hpp"
+
+#include <cctype>
+#include <cstring>
+#include <iterator>
+
+#include "whitelightning/trace.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define WHITELIGHTNING_X86 1
+#if defined(__GNUC__) || defined(__clang__)
+#define WHITELIGHTNING_AVX2_DISPATCH 1
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define WHITELIGHTNING_NEON 1
+#endif
+
+namespace whitelightning {
+
+namespace {
+
+struct CodepointRange {
+    uint32_t first;
+    uint32_t last;
+};
+
+struct LowerRun {
+    uint32_t first;
+    uint32_t last;
+    int32_t delta;
+    uint32_t stride;
+};
+
+#include "unicode_tables.inc"
+
+constexpr uint32_t kInvalid = 0xFFFFFFFF;
+
+// Decode the code point at s[i]; a malformed byte decodes as kInvalid, length 1
+size_t decode_utf8(const char* s, size_t n, size_t i, uint32_t& cp) {
+    unsigned char c = static_cast<unsigned char>(s[i]);
+    if (c < 0x80) {
+        cp = c;
+        return 1;
+    }
+    size_t length = c >= 0xF5 ? 0 : c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC2 ? 2 : 0;
+    if (length == 0 || i + length > n) {
+        cp = kInvalid;
+        return 1;
+    }
+    cp = c & (0x7F >> length);
+    for (size_t k = 1; k < length; k++) {
+        unsigned char next = static_cast<unsigned char>(s[i + k]);
+        if ((next & 0xC0) != 0x80) {
+            cp = kInvalid;
+            return 1;
+        }
+        cp = (cp << 6) | (next & 0x3F);
+    }
+    // Overlong forms and surrogates are malformed too
+    static constexpr uint32_t kMinimum[] = {0, 0, 0x80, 0x800, 0x10000};
+    if (cp < kMinimum[length] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+        cp = kInvalid;
+        return 1;
+    }
+    return length;
+}
+
+size_t encode_utf8(uint32_t cp, char* out) {
+    if (cp < 0x80) {
+        out[0] = static_cast<char>(cp);
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (cp >> 6));
+        out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (cp >> 12));
+        out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (cp >> 18));
+    out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+bool is_ascii_word(unsigned char c) {
+    return std::isalnum(c) || c == '_';
+}
+
+template <size_t N>
+bool in_ranges(const CodepointRange (&ranges)[N], uint32_t cp) {
+    const CodepointRange* it = std::upper_bound(std::begin(ranges), std::end(ranges), cp,
+                                                [](uint32_t value, const CodepointRange& r) { return value < r.first; });
+    return it != std::begin(ranges) && cp <= (it - 1)->last;
+}
+
+// Python's \w; malformed bytes count as word characters so they stay inside
+// the surrounding word
+bool is_word_codepoint(uint32_t cp) {
+    if (cp < 0x80) return is_ascii_word(static_cast<unsigned char>(cp));
+    return cp == kInvalid || in_ranges(kWordRanges, cp);
+}
+
+bool is_cased(uint32_t cp) {
+    return cp != kInvalid && in_ranges(kCasedRanges, cp);
+}
+
+bool is_case_ignorable(uint32_t cp) {
+    return cp != kInvalid && in_ranges(kCaseIgnorableRanges, cp);
+}
+
+// Decode the code point ending just before s[i]; returns its start
+size_t decode_utf8_before(const char* s, size_t n, size_t i, uint32_t& cp) {
+    size_t start = i - 1;
+    while (start > 0 && i - start < 4 && (static_cast<unsigned char>(s[start]) & 0xC0) == 0x80) start--;
+    if (start + decode_utf8(s, n, start, cp) != i) {
+        cp = kInvalid;
+        start = i - 1;
+    }
+    return start;
+}
+
+// str.lower()'s Final_Sigma context for the U+03A3 at s[i..i+length): a cased
+// letter before it and none after it, skipping case-ignorable code points
+bool is_final_sigma(const char* s, size_t n, size_t i, size_t length) {
+    uint32_t cp = kInvalid;
+    size_t j = i;
+    do {
+        if (j == 0) return false;
+        j = decode_utf8_before(s, n, j, cp);
+    } while (is_case_ignorable(cp));
+    if (!is_cased(cp)) return false;
+    for (j = i + length; j < n;) {
+        j += decode_utf8(s, n, j, cp);
+        if (!is_case_ignorable(cp)) return !is_cased(cp);
+    }
+    return true;
+}
+
+uint32_t lower_codepoint(uint32_t cp) {
+    const LowerRun* it = std::upper_bound(std::begin(kLowerRuns), std::end(kLowerRuns), cp,
+                                          [](uint32_t value, const LowerRun& r) { return value < r.first; });
+    if (it == std::begin(kLowerRuns)) return cp;
+    const LowerRun& run = *(it - 1);
+    if (cp > run.last || (cp - run.first) % run.stride != 0) return cp;
+    return static_cast<uint32_t>(static_cast<int64_t>(cp) + run.delta);
+}
+
+// Lowercase the code point at s[i] into out as str.lower() does; returns the
+// bytes consumed and adds the bytes written to written
+size_t lower_at(const char* s, size_t n, size_t i, char* out, size_t& written) {
+    unsigned char c = static_cast<unsigned char>(s[i]);
+    if (c < 0x80) {
+        out[0] = static_cast<char>(c >= 'A' && c <= 'Z' ? c | 0x20 : c);
+        written += 1;
+        return 1;
+    }
+    uint32_t cp;
+    size_t length = decode_utf8(s, n, i, cp);
+    if (cp == kInvalid) {
+        out[0] = s[i];
+        written += 1;
+        return 1;
+    }
+    if (cp == 0x130) {
+        // U+0130 lowers to "i" + U+0307 COMBINING DOT ABOVE
+        std::memcpy(out, "i\xCC\x87", 3);
+        written += 3;
+        return length;
+    }
+    if (cp == 0x3A3) {
+        // A capital sigma ending a word lowers to final sigma U+03C2
+        bool final = is_final_sigma(s, n, i, length);
+        written += encode_utf8(final ? 0x3C2 : 0x3C3, out);
+        return length;
+    }
+    written += encode_utf8(lower_codepoint(cp), out);
+    return length;
+}
+
+// 32-byte kernels. lower32 lowercases an all-ASCII chunk into out and
+// returns false, writing nothing, if the chunk has a byte >= 0x80.
+// classify32 sets bit i of each mask for byte i: part of a Keras token,
+// ASCII \w, and >= 0x80.
+struct Masks {
+    uint32_t token;
+    uint32_t word;
+    uint32_t high;
+};
+
+struct Kernels {
+    const char* name;
+    bool (*lower32)(const char* in, char* out);
+    Masks (*classify32)(const char* in);
+};
+
+#if !defined(WHITELIGHTNING_X86) && !defined(WHITELIGHTNING_NEON)
+// Keras Tokenizer's default filters plus its split character: every other
+// byte, including all of UTF-8, is part of a token
+bool is_keras_separator(unsigned char c) {
+    return c == '\t' || c == '\n' || (c >= 0x20 && c <= 0x26) || (c >= 0x28 && c <= 0x2F) ||
+           (c >= 0x3A && c <= 0x40) || (c >= 0x5B && c <= 0x60) || (c >= 0x7B && c <= 0x7E);
+}
+
+bool lower32_scalar(const char* in, char* out) {
+    for (int i = 0; i < 32; i++) {
+        if (static_cast<unsigned char>(in[i]) >= 0x80) return false;
+    }
+    for (int i = 0; i < 32; i++) {
+        unsigned char c = static_cast<unsigned char>(in[i]);
+        out[i] = static_cast<char>(c >= 'A' && c <= 'Z' ? c | 0x20 : c);
+    }
+    return true;
+}
+
+Masks classify32_scalar(const char* in) {
+    Masks masks{0, 0, 0};
+    for (int i = 0; i < 32; i++) {
+        unsigned char c = static_cast<unsigned char>(in[i]);
+        masks.token |= static_cast<uint32_t>(!is_keras_separator(c)) << i;
+        masks.word |= static_cast<uint32_t>(c < 0x80 && is_ascii_word(c)) << i;
+        masks.high |= static_cast<uint32_t>(c >= 0x80) << i;
+    }
+    return masks;
+}
+#endif
+
+#if defined(WHITELIGHTNING_X86)
+// Unsigned lo <= v <= hi per byte: (v - lo) == min(v - lo, hi - lo)
+inline __m128i in_range_sse2(__m128i v, char lo, char hi) {
+    __m128i x = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(x, _mm_set1_epi8(static_cast<char>(hi - lo))), x);
+}
+
+bool lower32_sse2(const char* in, char* out) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16));
+    if (_mm_movemask_epi8(_mm_or_si128(a, b)) != 0) return false;
+    __m128i bit = _mm_set1_epi8(0x20);
+    a = _mm_or_si128(a, _mm_and_si128(in_range_sse2(a, 'A', 'Z'), bit));
+    b = _mm_or_si128(b, _mm_and_si128(in_range_sse2(b, 'A', 'Z'), bit));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), a);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), b);
+    return true;
+}
+
+Masks classify16_sse2(__m128i v) {
+    __m128i separator = _mm_or_si128(
+        _mm_or_si128(_mm_or_si128(in_range_sse2(v, 0x09, 0x0A), in_range_sse2(v, 0x20, 0x26)),
+                     _mm_or_si128(in_range_sse2(v, 0x28, 0x2F), in_range_sse2(v, 0x3A, 0x40))),
+        _mm_or_si128(in_range_sse2(v, 0x5B, 0x60), in_range_sse2(v, 0x7B, 0x7E)));
+    __m128i word = _mm_or_si128(_mm_or_si128(in_range_sse2(v, '0', '9'), in_range_sse2(v, 'a', 'z')),
+                                _mm_or_si128(in_range_sse2(v, 'A', 'Z'), _mm_cmpeq_epi8(v, _mm_set1_epi8('_'))));
+    return {static_cast<uint32_t>(~_mm_movemask_epi8(separator) & 0xFFFF),
+            static_cast<uint32_t>(_mm_movemask_epi8(word)), static_cast<uint32_t>(_mm_movemask_epi8(v))};
+}
+
+Masks classify32_sse2(const char* in) {
+    Masks lo = classify16_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)));
+    Masks hi = classify16_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16)));
+    return {lo.token | hi.token << 16, lo.word | hi.word << 16, lo.high | hi.high << 16};
+}
+
+#if defined(WHITELIGHTNING_AVX2_DISPATCH)
+__attribute__((target("avx2"))) inline __m256i in_range_avx2(__m256i v, char lo, char hi) {
+    __m256i x = _mm256_sub_epi8(v, _mm256_set1_epi8(lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(x, _mm256_set1_epi8(static_cast<char>(hi - lo))), x);
+}
+
+__attribute__((target("avx2"))) bool lower32_avx2(const char* in, char* out) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+    if (_mm256_movemask_epi8(v) != 0) return false;
+    v = _mm256_or_si256(v, _mm256_and_si256(in_range_avx2(v, 'A', 'Z'), _mm256_set1_epi8(0x20)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v);
+    return true;
+}
+
+__attribute__((target("avx2"))) Masks classify32_avx2(const char* in) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+    __m256i separator = _mm256_or_si256(
+        _mm256_or_si256(_mm256_or_si256(in_range_avx2(v, 0x09, 0x0A), in_range_avx2(v, 0x20, 0x26)),
+                        _mm256_or_si256(in_range_avx2(v, 0x28, 0x2F), in_range_avx2(v, 0x3A, 0x40))),
+        _mm256_or_si256(in_range_avx2(v, 0x5B, 0x60), in_range_avx2(v, 0x7B, 0x7E)));
+    __m256i word = _mm256_or_si256(_mm256_or_si256(in_range_avx2(v, '0', '9'), in_range_avx2(v, 'a', 'z')),
+                                   _mm256_or_si256(in_range_avx2(v, 'A', 'Z'),
+                                                   _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'))));
+    return {~static_cast<uint32_t>(_mm256_movemask_epi8(separator)), static_cast<uint32_t>(_mm256_movemask_epi8(word)),
+            static_cast<uint32_t>(_mm256_movemask_epi8(v))};
+}
+#endif
+#endif
+
+#if defined(WHITELIGHTNING_NEON)
+inline uint8x16_t in_range_neon(uint8x16_t v, uint8_t lo, uint8_t hi) {
+    return vcleq_u8(vsubq_u8(v, vdupq_n_u8(lo)), vdupq_n_u8(static_cast<uint8_t>(hi - lo)));
+}
+
+// One bit per 0x00/0xFF lane, like _mm_movemask_epi8
+inline uint32_t movemask_neon(uint8x16_t m) {
+    static const uint8_t kBits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16_t t = vandq_u8(m, vld1q_u8(kBits));
+    return vaddv_u8(vget_low_u8(t)) | static_cast<uint32_t>(vaddv_u8(vget_high_u8(t))) << 8;
+}
+
+bool lower32_neon(const char* in, char* out) {
+    uint8x16_t a = vld1q_u8(reinterpret_cast<const uint8_t*>(in));
+    uint8x16_t b = vld1q_u8(reinterpret_cast<const uint8_t*>(in + 16));
+    if (vmaxvq_u8(vorrq_u8(a, b)) >= 0x80) return false;
+    uint8x16_t bit = vdupq_n_u8(0x20);
+    vst1q_u8(reinterpret_cast<uint8_t*>(out), vorrq_u8(a, vandq_u8(in_range_neon(a, 'A', 'Z'), bit)));
+    vst1q_u8(reinterpret_cast<uint8_t*>(out + 16), vorrq_u8(b, vandq_u8(in_range_neon(b, 'A', 'Z'), bit)));
+    return true;
+}
+
+Masks classify16_neon(uint8x16_t v) {
+    uint8x16_t separator = vorrq_u8(
+        vorrq_u8(vorrq_u8(in_range_neon(v, 0x09, 0x0A), in_range_neon(v, 0x20, 0x26)),
+                 vorrq_u8(in_range_neon(v, 0x28, 0x2F), in_range_neon(v, 0x3A, 0x40))),
+        vorrq_u8(in_range_neon(v, 0x5B, 0x60), in_range_neon(v, 0x7B, 0x7E)));
+    uint8x16_t word = vorrq_u8(vorrq_u8(in_range_neon(v, '0', '9'), in_range_neon(v, 'a', 'z')),
+                               vorrq_u8(in_range_neon(v, 'A', 'Z'), vceqq_u8(v, vdupq_n_u8('_'))));
+    return {~movemask_neon(separator) & 0xFFFF, movemask_neon(word), movemask_neon(vcgeq_u8(v, vdupq_n_u8(0x80)))};
+}
+
+Masks classify32_neon(const char* in) {
+    Masks lo = classify16_neon(vld1q_u8(reinterpret_cast<const uint8_t*>(in)));
+    Masks hi = classify16_neon(vld1q_u8(reinterpret_cast<const uint8_t*>(in + 16)));
+    return {lo.token | hi.token << 16, lo.word | hi.word << 16, lo.high | hi.high << 16};
+}
+#endif
+
+const Kernels& kernels() {
+    static const Kernels selected = [] {
+#if defined(WHITELIGHTNING_AVX2_DISPATCH)
+        if (__builtin_cpu_supports("avx2")) return Kernels{"avx2", lower32_avx2, classify32_avx2};
+#endif
+#if defined(WHITELIGHTNING_X86)
+        return Kernels{"sse2", lower32_sse2, classify32_sse2};
+#elif defined(WHITELIGHTNING_NEON)
+        return Kernels{"neon", lower32_neon, classify32_neon};
+#else
+        return Kernels{"scalar", lower32_scalar, classify32_scalar};
+#endif
+    }();
+    return selected;
+}
+
+// Bits of chunk [base, base + 32) of s that belong to \w code points, for
+// the bytes >= 0x80 in high (ASCII bytes are already in the word mask)
+uint32_t unicode_word_bits(const char* s, size_t n, size_t base, uint32_t high) {
+    uint32_t bits = 0;
+    size_t end = std::min(n, base + 32);
+    size_t i = base;
+    // Start at the lead byte of a code point the chunk begins inside of
+    while (i > 0 && i > base - 3 && (static_cast<unsigned char>(s[i]) & 0xC0) == 0x80) i--;
+    while (i < end) {
+        if (static_cast<unsigned char>(s[i]) < 0x80) {
+            i++;
+            continue;
+        }
+        uint32_t cp;
+        size_t length = decode_utf8(s, n, i, cp);
+        if (is_word_codepoint(cp)) {
+            for (size_t k = std::max(i, base); k < std::min(i + length, end); k++) {
+                bits |= 1u << (k - base);
+            }
+        }
+        i += length;
+    }
+    return bits & high;
+}
+
+// At least two code points, as \w\w+ requires
+bool has_two_codepoints(const char* s, size_t n, size_t start, size_t length) {
+    if (length < 2) return false;
+    if (static_cast<unsigned char>(s[start]) < 0x80 || length > 4) return true;
+    uint32_t cp;
+    return decode_utf8(s, n, start, cp) < length;
+}
+
+inline unsigned count_trailing_zeros(uint32_t x) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, x);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(x));
+#endif
+}
+
+// Split lowered into the maximal runs of bytes whose mask bit is set, 32
+// bytes at a time: each run starts at a 0->1 and ends at a 1->0 transition
+// of the mask
+template <bool Words, typename Emit>
+void split_runs(std::string_view lowered, Emit emit) {
+    const Kernels& k = kernels();
+    const char* s = lowered.data();
+    size_t n = lowered.size();
+    bool in_run = false;
+    size_t start = 0;
+    char tail[32];
+    for (size_t base = 0; base < n; base += 32) {
+        size_t valid = std::min<size_t>(32, n - base);
+        const char* chunk = s + base;
+        if (valid < 32) {
+            std::memset(tail, ' ', sizeof(tail));
+            std::memcpy(tail, chunk, valid);
+            chunk = tail;
+        }
+        Masks masks = k.classify32(chunk);
+        uint32_t mask;
+        if constexpr (Words) {
+            mask = masks.word | (masks.high ? unicode_word_bits(s, n, base, masks.high) : 0);
+        } else {
+            mask = masks.token;
+        }
+        if (valid < 32) mask &= (1u << valid) - 1;
+        
+        uint32_t shifted = (mask << 1) | (in_run ? 1u : 0u);
+        uint32_t edges = (mask & ~shifted) | (~mask & shifted);
+        while (edges) {
+            size_t at = base + count_trailing_zeros(edges);
+            if (!in_run) {
+                start = at;
+            } else {
+                emit(start, at - start);
+            }
+            in_run = !in_run;
+            edges &= edges - 1;
+        }
+    }
+    if (in_run) {
+        emit(start, n - start);
+    }
+}
+
+}  // namespace
+
+TokenizerScratch& tokenizer_scratch() {
+    thread_local TokenizerScratch scratch;
+    return scratch;
+}
+
+const char* tokenizer_kernel() {
+    return kernels().name;
+}
+
+void lowercase(std::string_view text, std::string& out) {
+    const Kernels& k = kernels();
+    const char* s = text.data();
+    size_t n = text.size();
+    // Lowering grows a code point by at most 1.5x; 32 bytes of headroom for
+    // the last vector store
+    out.resize(n + n / 2 + 32);
+    char* dst = &out[0];
+    size_t i = 0, o = 0;
+    while (i + 32 <= n) {
+        if (k.lower32(s + i, dst + o)) {
+            i += 32;
+            o += 32;
+            continue;
+        }
+        // Non-ASCII chunk: scalar to its end, finishing a straddling code point
+        size_t end = i + 32;
+        while (i < end) {
+            i += lower_at(s, n, i, dst + o, o);
+        }
+    }
+    while (i < n) {
+        i += lower_at(s, n, i, dst + o, o);
+    }
+    out.resize(o);
+}
+
+const std::vector<std::string_view>& tokenize(std::string_view text, TokenizerScratch& scratch) {
+    TraceSpan span("tokenize");
+    lowercase(text, scratch.lowered);
+    std::string_view lowered(scratch.lowered);
+    scratch.tokens.clear();
+    split_runs<false>(lowered, [&](size_t start, size_t length) {
+        scratch.tokens.push_back(lowered.substr(start, length));
+    });
+    return scratch.tokens;
+}
+
+const std::vector<std::string_view>& tokenize_words(std::string_view text, TokenizerScratch& scratch) {
+    TraceSpan span("tokenize");
+    lowercase(text, scratch.lowered);
+    split_words(scratch.lowered, scratch.tokens);
+    return scratch.tokens;
+}
+
+void split_words(std::string_view lowered, std::vector<std::string_view>& words) {
+    words.clear();
+    split_runs<true>(lowered, [&](size_t start, size_t length) {
+        if (has_two_codepoints(lowered.data(), lowered.size(), start, length)) {
+            words.push_back(lowered.substr(start, length));
+        }
+    });
+}
+
+uint64_t normalized_text_hash(std::string_view text) {
+    // Hash "tok1 tok2 ...": lowercased bytes packed into 8-byte words, each
+    // word folded in with a multiply-xorshift, then a final avalanche
+    uint64_t h = 0x9E3779B97F4A7C15ULL;
+    uint64_t word = 0;
+    size_t filled = 0;
+    size_t length = 0;
+    auto push = [&](unsigned char c) {
+        word |= static_cast<uint64_t>(c) << (8 * filled);
+        length++;
+        if (++filled == 8) {
+            h = (h ^ word) * 0xBF58476D1CE4E5B9ULL;
+            h ^= h >> 31;
+            word = 0;
+            filled = 0;
+        }
+    };
+    
+    bool in_token = false;
+    for (char c : text) {
+        if (c == ' ' || c == '\t' || c == '\n') {
+            in_token = false;
+            continue;
+        }
+        if (!in_token && length > 0) push(' ');
+        in_token = true;
+        push(static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(c))));
+    }
+    h = (h ^ word ^ (static_cast<uint64_t>(length) << 56)) * 0x94D049BB133111EBULL;
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 32;
+    return h;
+}
+
+}  // namespace whitelightning
@@ -0,0 +1,317 @@
+#include "whitelightning/topology.hpp"
+
+#include <onnxruntime_cxx_api.h>
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+#include "whitelightning/session_config.hpp"
+
+#ifdef __APPLE__
+#include <sys/sysctl.h>
+#include <unistd.h>
+#elif __linux__
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+namespace whitelightning {
+
+namespace {
+
+// Kernel cpulist syntax: "0-3,8,10-11"; false on anything else
+bool parse_cpu_list(const std::string& text, std::vector<int>& cpus) {
+    size_t pos = 0;
+    auto read_int = [&](int& value) {
+        size_t start = pos;
+        while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))) pos++;
+        if (pos == start || pos - start > 6) return false;
+        value = std::stoi(text.substr(start, pos - start));
+        return true;
+    };
+    
+    while (pos < text.size()) {
+        int first, last;
+        if (!read_int(first)) return false;
+        last = first;
+        if (pos < text.size() && text[pos] == '-') {
+            pos++;
+            if (!read_int(last) || last < first) return false;
+        }
+        for (int cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+        if (pos < text.size()) {
+            if (text[pos] != ',') return false;
+            pos++;
+            if (pos == text.size()) return false;
+        }
+    }
+    return !cpus.empty();
+}
+
+#ifdef __linux__
+bool read_sysfs_line(const std::string& path, std::string& line) {
+    std::ifstream file(path);
+    if (!std::getline(file, line)) return false;
+    while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) line.pop_back();
+    return true;
+}
+
+int read_sysfs_int(const std::string& path, int fallback) {
+    std::string line;
+    if (!read_sysfs_line(path, line)) return fallback;
+    try {
+        return std::stoi(line);
+    } catch (const std::exception&) {
+        return fallback;
+    }
+}
+
+// node id for every CPU listed under /sys/devices/system/node/nodeK/cpulist
+std::map<int, int> read_cpu_nodes() {
+    std::map<int, int> nodes;
+    const std::string root = "/sys/devices/system/node";
+    DIR* dir = opendir(root.c_str());
+    if (dir == nullptr) return nodes;
+    while (dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.size() < 5 || name.compare(0, 4, "node") != 0 ||
+            !std::all_of(name.begin() + 4, name.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); })) {
+            continue;
+        }
+        int node = std::stoi(name.substr(4));
+        std::string line;
+        std::vector<int> cpus;
+        if (read_sysfs_line(root + "/" + name + "/cpulist", line) && parse_cpu_list(line, cpus)) {
+            for (int cpu : cpus) nodes[cpu] = node;
+        }
+    }
+    closedir(dir);
+    return nodes;
+}
+
+CpuTopology detect_topology() {
+    CpuTopology topology;
+    const std::string root = "/sys/devices/system/cpu";
+    std::string line;
+    std::vector<int> online;
+    if (!read_sysfs_line(root + "/online", line) || !parse_cpu_list(line, online)) {
+        long count = sysconf(_SC_NPROCESSORS_ONLN);
+        for (int cpu = 0; cpu < std::max(1L, count); cpu++) online.push_back(cpu);
+    }
+    
+    std::map<int, int> nodes = read_cpu_nodes();
+    std::map<std::pair<int, int>, int> cores;  // (package, core_id) -> core index
+    std::set<int> packages, numa_nodes;
+    for (int id : online) {
+        std::string topology_dir = root + "/cpu" + std::to_string(id) + "/topology/";
+        LogicalCpu cpu;
+        cpu.id = id;
+        cpu.package = read_sysfs_int(topology_dir + "physical_package_id", 0);
+        // core_id repeats across sockets, so number cores per (package, core_id)
+        auto key = std::make_pair(cpu.package, read_sysfs_int(topology_dir + "core_id", id));
+        auto core = cores.emplace(key, static_cast<int>(cores.size())).first;
+        cpu.core = core->second;
+        auto node = nodes.find(id);
+        cpu.node = node != nodes.end() ? node->second : 0;
+        packages.insert(cpu.package);
+        numa_nodes.insert(cpu.node);
+        topology.cpus.push_back(cpu);
+    }
+    topology.physical_cores = static_cast<int>(cores.size());
+    topology.packages = static_cast<int>(packages.size());
+    topology.numa_nodes = static_cast<int>(numa_nodes.size());
+    return topology;
+}
+
+// CPUs this process may run on (cgroup cpusets, taskset)
+std::set<int> allowed_cpus() {
+    std::set<int> allowed;
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &mask)) allowed.insert(cpu);
+        }
+    }
+    return allowed;
+}
+#else
+CpuTopology detect_topology() {
+    CpuTopology topology;
+    int logical = 1, physical = 1, packages = 1;
+#ifdef __APPLE__
+    size_t size = sizeof(int);
+    sysctlbyname("hw.logicalcpu", &logical, &size, NULL, 0);
+    sysctlbyname("hw.physicalcpu", &physical, &size, NULL, 0);
+    sysctlbyname("hw.packages", &packages, &size, NULL, 0);
+#endif
+    logical = std::max(1, logical);
+    physical = std::min(std::max(1, physical), logical);
+    for (int id = 0; id < logical; id++) {
+        LogicalCpu cpu;
+        cpu.id = id;
+        cpu.core = id * physical / logical;
+        topology.cpus.push_back(cpu);
+    }
+    topology.physical_cores = physical;
+    topology.packages = std::max(1, packages);
+    return topology;
+}
+
+std::set<int> allowed_cpus() {
+    std::set<int> allowed;
+    for (const LogicalCpu& cpu : cpu_topology().cpus) allowed.insert(cpu.id);
+    return allowed;
+}
+#endif
+
+CpuPlacement current_placement;
+
+}  // namespace
+
+const LogicalCpu* CpuTopology::find(int id) const {
+    auto it = std::lower_bound(cpus.begin(), cpus.end(), id,
+                               [](const LogicalCpu& cpu, int value) { return cpu.id < value; });
+    return it != cpus.end() && it->id == id ? &*it : nullptr;
+}
+
+const CpuTopology& cpu_topology() {
+    static const CpuTopology topology = detect_topology();
+    return topology;
+}
+
+CpuPlacement resolve_cpu_placement(const std::string& spec) {
+    const CpuTopology& topology = cpu_topology();
+    std::set<int> allowed = allowed_cpus();
+    // cores and node:N skip CPUs outside the affinity mask; a CPU list must be usable as given
+    std::vector<int> cpus;
+    if (spec == "cores") {
+        std::set<int> seen_cores;
+        for (const LogicalCpu& cpu : topology.cpus) {
+            if (allowed.count(cpu.id) && seen_cores.insert(cpu.core).second) cpus.push_back(cpu.id);
+        }
+    } else if (spec.rfind("node:", 0) == 0) {
+        std::vector<int> nodes;
+        if (!parse_cpu_list(spec.substr(5), nodes)) {
+            throw std::runtime_error("expected node:N[,M], got '" + spec + "'");
+        }
+        for (int node : nodes) {
+            size_t before = cpus.size();
+            for (const LogicalCpu& cpu : topology.cpus) {
+                if (cpu.node == node && allowed.count(cpu.id)) cpus.push_back(cpu.id);
+            }
+            if (cpus.size() == before) {
+                throw std::runtime_error("NUMA node " + std::to_string(node) + " has no usable CPUs (" +
+                                         std::to_string(topology.numa_nodes) + " node(s) detected)");
+            }
+        }
+    } else if (!parse_cpu_list(spec, cpus)) {
+        throw std::runtime_error("expected a CPU list (0-3,8), node:N or cores, got '" + spec + "'");
+    }
+    
+    CpuPlacement placement;
+    placement.spec = spec;
+    std::set<int> nodes;
+    for (int id : cpus) {
+        const LogicalCpu* cpu = topology.find(id);
+        if (cpu == nullptr) {
+            throw std::runtime_error("CPU " + std::to_string(id) + " is not online");
+        }
+        if (!allowed.count(id)) {
+            throw std::runtime_error("CPU " + std::to_string(id) + " is outside this process's affinity mask");
+        }
+        if (std::find(placement.cpus.begin(), placement.cpus.end(), id) == placement.cpus.end()) {
+            placement.cpus.push_back(id);
+            nodes.insert(cpu->node);
+        }
+    }
+    if (placement.cpus.empty()) {
+        throw std::runtime_error("'" + spec + "' selects no CPUs this process may use");
+    }
+    placement.nodes.assign(nodes.begin(), nodes.end());
+    return placement;
+}
+
+std::string format_cpu_list(const std::vector<int>& cpus) {
+    std::vector<int> sorted = cpus;
+    std::sort(sorted.begin(), sorted.end());
+    std::string text;
+    for (size_t i = 0; i < sorted.size();) {
+        size_t j = i;
+        while (j + 1 < sorted.size() && sorted[j + 1] == sorted[j] + 1) j++;
+        if (!text.empty()) text += ",";
+        text += std::to_string(sorted[i]);
+        if (j > i) text += "-" + std::to_string(sorted[j]);
+        i = j + 1;
+    }
+    return text;
+}
+
+bool pin_current_thread(const std::vector<int>& cpus) {
+#ifdef __linux__
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (int cpu : cpus) CPU_SET(cpu, &mask);
+    int error = pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask);
+    if (error != 0) {
+        std::cerr << "⚠️ Could not pin thread to CPUs " << format_cpu_list(cpus) << " (error " << error << ")\n";
+        return false;
+    }
+    return true;
+#else
+    // macOS only takes affinity tags as scheduling hints
+    static bool warned = false;
+    if (!warned) {
+        std::cerr << "⚠️ Thread pinning is not supported on this platform - threads stay unpinned\n";
+        warned = true;
+    }
+    (void)cpus;
+    return false;
+#endif
+}
+
+bool apply_cpu_placement(const CpuPlacement& placement) {
+    if (placement.empty() || !pin_current_thread(placement.cpus)) return false;
+    current_placement = placement;
+    std::cout << "📌 Pinned to CPU" << (placement.cpus.size() == 1 ? " " : "s ") << format_cpu_list(placement.cpus)
+              << " on NUMA node" << (placement.nodes.size() == 1 ? " " : "s ") << format_cpu_list(placement.nodes) << "\n";
+    return true;
+}
+
+const CpuPlacement& active_cpu_placement() {
+    return current_placement;
+}
+
+int configure_intra_op_threads(Ort::SessionOptions& options, const SessionConfig& config) {
+    int threads = config.intra_op_threads;
+    if (threads <= 0 && !config.pinned_cpus.empty()) threads = static_cast<int>(config.pinned_cpus.size());
+    if (config.async) {
+        // RunAsync runs on the intra-op pool and ORT rejects it with one thread
+        threads = std::max(2, threads > 0 ? threads : cpu_topology().physical_cores);
+    }
+    if (threads > 0) {
+        options.SetIntraOpNumThreads(threads);
+    } else {
+        threads = cpu_topology().physical_cores;  // ORT's default
+    }
+    
+    // One entry per pool thread ORT creates (threads - 1), 1-based processor ids
+    std::string affinities;
+    for (int t = 1; t < threads && !config.pinned_cpus.empty(); t++) {
+        if (!affinities.empty()) affinities += ";";
+        affinities += std::to_string(config.pinned_cpus[t % config.pinned_cpus.size()] + 1);
+    }
+    if (!affinities.empty()) {
+        options.AddConfigEntry("session.intra_op_thread_affinities", affinities.c_str());
+    }
+    return threads;
+}
+
+}  // namespace whitelightning
@@ -0,0 +1,172 @@
+#include "whitelightning/trace.hpp"
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace whitelightning {
+
+using json = nlohmann::json;
+
+std::atomic<bool> g_tracing{false};
+
+namespace {
+
+// Rings of every thread that recorded a span. They are never freed, so a
+// thread_local pointer stays valid and worker threads can exit before export.
+struct TraceRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TraceRing>> rings;
+    double start_ms = 0;
+};
+
+TraceRegistry& trace_registry() {
+    static TraceRegistry registry;
+    return registry;
+}
+
+size_t round_up_pow2(size_t n) {
+    size_t capacity = 1;
+    while (capacity < n) capacity <<= 1;
+    return capacity;
+}
+
+json thread_name_event(int pid, uint32_t tid, const std::string& name) {
+    return {{"name", "thread_name"}, {"ph", "M"}, {"pid", pid}, {"tid", tid}, {"args", {{"name", name}}}};
+}
+
+json process_name_event(int pid, const std::string& name) {
+    return {{"name", "process_name"}, {"ph", "M"}, {"pid", pid}, {"args", {{"name", name}}}};
+}
+
+}  // namespace
+
+TraceRing::TraceRing(size_t capacity, uint32_t thread_id)
+    : events_(round_up_pow2(std::max<size_t>(capacity, 1))), mask_(events_.size() - 1), thread_id_(thread_id) {}
+
+void start_tracing() {
+    TraceRegistry& registry = trace_registry();
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (auto& ring : registry.rings) ring->clear();
+        registry.start_ms = get_time_ms();
+    }
+    g_tracing.store(true, std::memory_order_relaxed);
+}
+
+void stop_tracing() {
+    g_tracing.store(false, std::memory_order_relaxed);
+}
+
+TraceRing& thread_trace_ring() {
+    thread_local TraceRing* ring = nullptr;
+    if (ring == nullptr) {
+        TraceRegistry& registry = trace_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.rings.push_back(std::make_unique<TraceRing>(kTraceEventsPerThread,
+                                                             static_cast<uint32_t>(registry.rings.size())));
+        ring = registry.rings.back().get();
+    }
+    return *ring;
+}
+
+void write_chrome_trace(const std::string& path, const std::vector<OrtProfile>& ort_profiles) {
+    TraceRegistry& registry = trace_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    double epoch_us = registry.start_ms * 1000.0;
+    
+    json events = json::array();
+    events.push_back(process_name_event(1, "whitelightning"));
+    size_t spans = 0;
+    uint64_t overwritten = 0;
+    for (const auto& ring : registry.rings) {
+        uint64_t head = ring->head();
+        uint64_t first = head > ring->capacity() ? head - ring->capacity() : 0;
+        if (first == head) continue;
+        overwritten += first;
+        events.push_back(thread_name_event(1, ring->thread_id(), "thread " + std::to_string(ring->thread_id())));
+        for (uint64_t i = first; i < head; i++) {
+            const TraceEvent& event = ring->at(i);
+            events.push_back({
+                {"name", event.name},
+                {"cat", "whitelightning"},
+                {"ph", "X"},
+                {"ts", event.start_ms * 1000.0 - epoch_us},
+                {"dur", event.duration_ms * 1000.0},
+                {"pid", 1},
+                {"tid", ring->thread_id()}
+            });
+            spans++;
+        }
+    }
+    
+    // ORT timestamps are microseconds since its profiler started
+    size_t operator_events = 0;
+    for (size_t p = 0; p < ort_profiles.size(); p++) {
+        const OrtProfile& profile = ort_profiles[p];
+        if (profile.path.empty()) continue;
+        std::ifstream file(profile.path);
+        json ort_events = json::parse(file, nullptr, false);
+        if (!file.is_open() || !ort_events.is_array()) {
+            std::cerr << "⚠️ Could not read ORT profile " << profile.path << "\n";
+            continue;
+        }
+        int pid = static_cast<int>(p) + 2;
+        double offset_us = profile.start_ns / 1000.0 - epoch_us;
+        events.push_back(process_name_event(pid, "onnxruntime (" + profile.label + ")"));
+        for (json& event : ort_events) {
+            if (!event.is_object() || !event.contains("ts")) continue;
+            event["ts"] = event["ts"].get<double>() + offset_us;
+            event["pid"] = pid;
+            events.push_back(std::move(event));
+            operator_events++;
+        }
+    }
+    
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        throw std::runtime_error("Failed to open trace file: " + path);
+    }
+    out << json{{"traceEvents", events}, {"displayTimeUnit", "ms"}}.dump() << "\n";
+    std::cout << "🧵 Trace written to " << path << ": " << spans << " spans on " << registry.rings.size()
+              << (registry.rings.size() == 1 ? " thread" : " threads");
+    if (overwritten) std::cout << " (" << overwritten << " oldest overwritten)";
+    if (operator_events) std::cout << ", " << operator_events << " ORT profile events";
+    std::cout << "\n";
+}
+
+std::string ort_profile_prefix(const std::string& trace_path) {
+    std::string prefix = trace_path;
+    if (prefix.size() > 5 && prefix.compare(prefix.size() - 5, 5, ".json") == 0) {
+        prefix.resize(prefix.size() - 5);
+    }
+    return prefix + "_ort";
+}
+
+TraceRecorder::TraceRecorder(std::string path) : path_(std::move(path)) {
+    if (enabled()) start_tracing();
+}
+
+TraceRecorder::~TraceRecorder() {
+    if (!enabled()) return;
+    stop_tracing();
+    try {
+        std::vector<OrtProfile> profiles;
+        for (auto& end_profiling : profiles_) {
+            profiles.push_back(end_profiling());
+        }
+        write_chrome_trace(path_, profiles);
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Trace error: " << e.what() << std::endl;
+    }
+}
+
+void TraceRecorder::add_ort_profile(std::function<OrtProfile()> end_profiling) {
+    profiles_.push_back(std::move(end_profiling));
+}
+
+}  // namespace whitelightning
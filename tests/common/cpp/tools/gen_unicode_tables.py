@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""Generate src/unicode_tables.inc for the UTF-8 tokenizer fallback.
+
+The tables are taken from the Python that exports the models, so that the
+C++ tokenizers match the reference exactly. They cover re's \\w (the
+sklearn token_pattern) and str.lower() (sklearn and Keras lowercasing,
+including its final sigma rule).
+
+    python3 tools/gen_unicode_tables.py > src/unicode_tables.inc
+"""
+
+import re
+import sys
+import unicodedata
+
+WORD = re.compile(r"\w")
+
+
+def code_points():
+    for cp in range(0x80, 0x110000):
+        if not 0xD800 <= cp <= 0xDFFF:
+            yield cp
+
+
+def word_ranges():
+    ranges = []
+    for cp in code_points():
+        if WORD.match(chr(cp)):
+            if ranges and ranges[-1][1] == cp - 1:
+                ranges[-1][1] = cp
+            else:
+                ranges.append([cp, cp])
+    return ranges
+
+
+def is_cased(c):
+    return c.islower() or c.isupper() or c.istitle()
+
+
+def property_ranges(predicate, start):
+    ranges = []
+    for cp in range(start, 0x110000):
+        if 0xD800 <= cp <= 0xDFFF or not predicate(chr(cp)):
+            continue
+        if ranges and ranges[-1][1] == cp - 1:
+            ranges[-1][1] = cp
+        else:
+            ranges.append([cp, cp])
+    return ranges
+
+
+def is_case_ignorable(c):
+    # Not exposed by unicodedata: probe str.lower()'s final sigma rule,
+    # which skips case-ignorable characters around U+03A3
+    if is_cased(c):
+        return ("a\u03a3" + c).lower()[1] == "\u03c2"
+    return ("a" + c + "\u03a3").lower()[-1] == "\u03c2"
+
+
+def lower_runs():
+    # [first, last, delta, stride]: cp in [first, last] with
+    # (cp - first) % stride == 0 lowers to cp + delta
+    runs = []
+    for cp in code_points():
+        lowered = chr(cp).lower()
+        if lowered == chr(cp) or len(lowered) != 1:
+            continue
+        delta = ord(lowered) - cp
+        if runs:
+            first, last, run_delta, stride = runs[-1]
+            gap = cp - last
+            if run_delta == delta and gap in (1, 2) and stride in (0, gap):
+                runs[-1] = [first, cp, delta, gap]
+                continue
+        runs.append([cp, cp, delta, 0])
+    for run in runs:
+        run[3] = run[3] or 1
+    return runs
+
+
+def check(runs):
+    for cp in code_points():
+        lowered = chr(cp).lower()
+        if len(lowered) != 1:
+            continue
+        expected = ord(lowered) - cp
+        delta = 0
+        for first, last, run_delta, stride in runs:
+            if first <= cp <= last and (cp - first) % stride == 0:
+                delta = run_delta
+                break
+        assert delta == expected, hex(cp)
+
+
+def write_ranges(out, name, comment, ranges):
+    out.write("\n// %s\n" % comment)
+    out.write("constexpr CodepointRange %s[] = {\n" % name)
+    for i in range(0, len(ranges), 4):
+        out.write("    " + " ".join("{0x%04X, 0x%04X}," % tuple(r) for r in ranges[i:i + 4]) + "\n")
+    out.write("};\n")
+
+
+def main():
+    ranges = word_ranges()
+    runs = lower_runs()
+    check(runs)
+    multi = [cp for cp in code_points() if len(chr(cp).lower()) != 1]
+    assert multi == [0x130], multi  # U+0130 is special-cased in tokenizer.cpp
+
+    cased = property_ranges(is_cased, 0)
+    ignorable = property_ranges(is_case_ignorable, 0)
+
+    out = sys.stdout
+    out.write("// Generated by tools/gen_unicode_tables.py from Python %d.%d (Unicode %s); do not edit.\n"
+              % (sys.version_info.major, sys.version_info.minor, unicodedata.unidata_version))
+    write_ranges(out, "kWordRanges", "Code points >= 0x80 that re matches as \\w", ranges)
+    write_ranges(out, "kCasedRanges", "Cased code points (final sigma rule of str.lower())", cased)
+    write_ranges(out, "kCaseIgnorableRanges", "Case-ignorable code points (final sigma rule of str.lower())", ignorable)
+    out.write("\n// str.lower() of code points >= 0x80 with a one-code-point result\n")
+    out.write("constexpr LowerRun kLowerRuns[] = {\n")
+    for i in range(0, len(runs), 3):
+        out.write("    " + " ".join("{0x%04X, 0x%04X, %d, %d}," % tuple(r) for r in runs[i:i + 3]) + "\n")
+    out.write("};\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,318 @@
+#!/usr/bin/env python3
+"""Benchmark every language runner of a model on the same corpus.
+
+Builds and runs the C, C++, Rust, Python and Node.js test_onnx_model
+runners with the same --benchmark iteration count, measures each process
+from the outside (peak RSS and CPU time from wait4, cold start as the wall
+time of a one-text run) and normalizes what the runner reports into one
+schema, so the languages can be compared side by side and against an
+earlier run:
+
+    python3 compare_runners.py --model binary_classifier --runs 1000
+    python3 compare_runners.py --model all --corpus texts.txt --json runners.json
+    python3 compare_runners.py --model all --baseline runners.json --tolerance 0.1
+
+Runners that take --corpus and --report (C++) are fed the corpus and read
+back through their JSON report. The others run their built-in text and
+have their console summary parsed; corpus_used says which one applied.
+With --baseline the script exits 1 when a runner's p50 latency, peak RSS
+or cold start grew, or its throughput fell, by more than --tolerance.
+"""
+
+import argparse
+import json
+import os
+import platform
+import re
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+SCHEMA = "whitelightning-runners/1"
+TESTS_DIR = os.path.dirname(os.path.abspath(__file__))
+MODELS = ["binary_classifier", "multiclass_classifier", "multiclass_sigmoid"]
+MODEL_FILES = ["model.onnx", "vocab.json", "scaler.json"]
+COLD_START_TEXT = "Cold start probe."
+
+
+class Runner:
+    def __init__(self, language, source, build, command, reports=False):
+        self.language = language
+        self.source = source      # entry point that must exist
+        self.build = build        # list of commands, run in order
+        self.command = command    # argv prefix of the runner
+        self.reports = reports    # takes --corpus and --report
+
+
+RUNNERS = {
+    "c": Runner("c", "test_onnx_model.c", [["make"]], ["./test_onnx_model"]),
+    "cpp": Runner("cpp", "test_onnx_model.cpp", [["make"]], ["./test_onnx_model"], reports=True),
+    "rust": Runner("rust", "src/main.rs", [["cargo", "build", "--release"]],
+                   ["./target/release/test_onnx_model"]),
+    "python": Runner("python", "test_onnx_model.py", [], [sys.executable, "test_onnx_model.py"]),
+    "nodejs": Runner("nodejs", "test_onnx_model.js", [["npm", "install"]], ["node", "test_onnx_model.js"]),
+}
+
+# Console summaries of runners without a JSON report
+STDOUT_LATENCY = re.compile(r"^\s*(Mean|Min|Max|p50|p90|p99|p99\.9):\s*([\d.]+)\s*ms", re.MULTILINE)
+STDOUT_THROUGHPUT = re.compile(r"(?:Overall throughput|Throughput):\s*([\d.]+)\s*texts/sec")
+
+
+def run_measured(argv, cwd, timeout):
+    """Run argv to completion; returns (exit code, stdout, wall ms, rusage)"""
+    with tempfile.TemporaryFile() as out:
+        start = time.perf_counter()
+        proc = subprocess.Popen(argv, cwd=cwd, stdout=out, stderr=subprocess.STDOUT)
+        timer = threading.Timer(timeout, proc.kill)
+        timer.start()
+        try:
+            if hasattr(os, "wait4"):
+                _, status, usage = os.wait4(proc.pid, 0)
+                proc.returncode = os.waitstatus_to_exitcode(status)
+            else:
+                proc.wait()
+                usage = None
+        finally:
+            timer.cancel()
+        wall_ms = (time.perf_counter() - start) * 1000.0
+        out.seek(0)
+        return proc.returncode, out.read().decode("utf-8", "replace"), wall_ms, usage
+
+
+def peak_rss_mb(usage):
+    if usage is None:
+        return None
+    # ru_maxrss is in kilobytes on Linux and bytes on macOS
+    scale = 1024.0 * 1024.0 if sys.platform == "darwin" else 1024.0
+    return usage.ru_maxrss / scale
+
+
+def cpu_seconds(usage):
+    return None if usage is None else usage.ru_utime + usage.ru_stime
+
+
+def missing_model_files(directory):
+    return [name for name in MODEL_FILES if not os.path.exists(os.path.join(directory, name))]
+
+
+def build_runner(runner, directory, timeout):
+    for argv in runner.build:
+        if argv[0] == "npm" and os.path.isdir(os.path.join(directory, "node_modules")):
+            continue
+        try:
+            code, output, _, _ = run_measured(argv, directory, timeout)
+        except FileNotFoundError:
+            return f"{argv[0]} not found"
+        if code != 0:
+            tail = output.strip().splitlines()[-1:] or [""]
+            return f"'{' '.join(argv)}' exited {code}: {tail[0]}"
+    return None
+
+
+def parse_stdout(output):
+    latency = {}
+    for name, value in STDOUT_LATENCY.findall(output):
+        latency[name.lower()] = float(value)
+    throughput = STDOUT_THROUGHPUT.search(output)
+    return latency, float(throughput.group(1)) if throughput else None
+
+
+def result(runner, model, status, detail=None):
+    return {
+        "language": runner.language,
+        "model": model,
+        "status": status,
+        "detail": detail,
+        "runs": None,
+        "corpus_used": False,
+        "source": None,
+        "latency_ms": {},
+        "throughput_per_sec": None,
+        "peak_rss_mb": None,
+        "cpu_seconds": None,
+        "cpu_seconds_per_1k_texts": None,
+        "cold_start_ms": None,
+        "runner_startup_ms": None,
+    }
+
+
+def benchmark_runner(runner, model, args):
+    directory = os.path.join(TESTS_DIR, model, runner.language)
+    if not os.path.exists(os.path.join(directory, runner.source)):
+        return result(runner, model, "missing", f"no {runner.language}/{runner.source}")
+    missing = missing_model_files(directory)
+    if missing:
+        return result(runner, model, "no_model_files", "missing " + ", ".join(missing))
+    if not args.no_build:
+        error = build_runner(runner, directory, args.timeout)
+        if error:
+            return result(runner, model, "build_failed", error)
+
+    entry = result(runner, model, "ok")
+    entry["runs"] = args.runs
+    argv = runner.command + ["--benchmark", str(args.runs)]
+    report_path = None
+    if runner.reports:
+        report_path = os.path.join(tempfile.mkdtemp(), "report.json")
+        argv += ["--report", report_path]
+        if args.corpus:
+            argv += ["--corpus", os.path.abspath(args.corpus)]
+            entry["corpus_used"] = True
+    try:
+        code, output, _, usage = run_measured(argv, directory, args.timeout)
+    except FileNotFoundError:
+        entry.update(status="run_failed", detail=f"{runner.command[0]} not found")
+        return entry
+    if code != 0:
+        tail = output.strip().splitlines()[-1:] or [""]
+        entry.update(status="run_failed", detail=f"exited {code}: {tail[0]}")
+        return entry
+    entry["peak_rss_mb"] = peak_rss_mb(usage)
+    entry["cpu_seconds"] = cpu_seconds(usage)
+    if entry["cpu_seconds"] is not None:
+        entry["cpu_seconds_per_1k_texts"] = entry["cpu_seconds"] * 1000.0 / args.runs
+
+    if report_path and os.path.exists(report_path):
+        with open(report_path) as f:
+            report = json.load(f)
+        entry["source"] = "report"
+        entry["latency_ms"] = report.get("latency_ms", {})
+        entry["throughput_per_sec"] = report.get("throughput_per_sec")
+        entry["runner_startup_ms"] = report.get("startup_ms", {}).get("total")
+    else:
+        entry["source"] = "stdout"
+        entry["latency_ms"], entry["throughput_per_sec"] = parse_stdout(output)
+        if not entry["latency_ms"]:
+            entry.update(status="unparsed", detail="no latency summary in the runner output")
+    if report_path:
+        shutil.rmtree(os.path.dirname(report_path), ignore_errors=True)
+
+    cold = []
+    for _ in range(args.cold_runs):
+        code, _, wall_ms, _ = run_measured(runner.command + [COLD_START_TEXT], directory, args.timeout)
+        if code == 0:
+            cold.append(wall_ms)
+    if cold:
+        entry["cold_start_ms"] = statistics.median(cold)
+    return entry
+
+
+def system_info():
+    return {
+        "platform": platform.platform(),
+        "machine": platform.machine(),
+        "cpus": os.cpu_count(),
+        "python": platform.python_version(),
+    }
+
+
+def fmt(value, spec):
+    width = int(spec.split(".")[0])
+    return "-".rjust(width) if value is None else format(value, spec)
+
+
+def print_table(results):
+    print("\n📊 RUNNER COMPARISON")
+    print("=" * 104)
+    header = f"{'Model':<22} {'Language':<8} {'Status':<14} {'p50 ms':>8} {'p99 ms':>8} {'Mean ms':>8} " \
+             f"{'Texts/s':>10} {'RSS MB':>8} {'CPU s':>7} {'Cold ms':>8}"
+    print(header)
+    print("-" * 104)
+    for r in results:
+        latency = r["latency_ms"]
+        status = r["status"] if r["status"] != "ok" or r["corpus_used"] else "ok (built-in)"
+        print(f"{r['model']:<22} {r['language']:<8} {status:<14} {fmt(latency.get('p50'), '8.3f')} "
+              f"{fmt(latency.get('p99'), '8.3f')} {fmt(latency.get('mean'), '8.3f')} "
+              f"{fmt(r['throughput_per_sec'], '10.1f')} {fmt(r['peak_rss_mb'], '8.1f')} "
+              f"{fmt(r['cpu_seconds'], '7.2f')} {fmt(r['cold_start_ms'], '8.1f')}")
+    for r in results:
+        if r["detail"]:
+            print(f"   {r['model']}/{r['language']}: {r['detail']}")
+
+
+def compare_baseline(results, baseline, tolerance):
+    """Regressions against a previous --json output, as printable lines"""
+    previous = {(r["model"], r["language"]): r for r in baseline.get("runners", []) if r["status"] == "ok"}
+    regressions = []
+    for r in results:
+        before = previous.get((r["model"], r["language"]))
+        if r["status"] != "ok" or before is None:
+            continue
+        # (name, before, after, higher is worse)
+        checks = [
+            ("p50 latency", before["latency_ms"].get("p50", before["latency_ms"].get("mean")),
+             r["latency_ms"].get("p50", r["latency_ms"].get("mean")), True),
+            ("throughput", before["throughput_per_sec"], r["throughput_per_sec"], False),
+            ("peak RSS", before["peak_rss_mb"], r["peak_rss_mb"], True),
+            ("cold start", before["cold_start_ms"], r["cold_start_ms"], True),
+        ]
+        for name, old, new, higher_is_worse in checks:
+            if not old or new is None:
+                continue
+            change = (new - old) / old
+            if (change if higher_is_worse else -change) > tolerance:
+                regressions.append(f"{r['model']}/{r['language']}: {name} {old:.3f} -> {new:.3f} ({change:+.1%})")
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--model", default="all", choices=MODELS + ["all"])
+    parser.add_argument("--languages", default=",".join(RUNNERS),
+                        help="comma-separated subset of " + ",".join(RUNNERS))
+    parser.add_argument("--runs", type=int, default=1000, help="--benchmark iterations per runner")
+    parser.add_argument("--corpus", help="one text per line, for runners that take --corpus")
+    parser.add_argument("--cold-runs", type=int, default=3, help="one-text runs for the cold start median")
+    parser.add_argument("--no-build", action="store_true", help="run the runners as already built")
+    parser.add_argument("--timeout", type=float, default=600, help="seconds per build or run")
+    parser.add_argument("--json", help="write the results to this file")
+    parser.add_argument("--baseline", help="earlier --json output to check for regressions")
+    parser.add_argument("--tolerance", type=float, default=0.1, help="allowed relative regression")
+    args = parser.parse_args()
+
+    languages = [name.strip() for name in args.languages.split(",") if name.strip()]
+    unknown = [name for name in languages if name not in RUNNERS]
+    if unknown:
+        parser.error("unknown language: " + ", ".join(unknown))
+    if args.runs < 1:
+        parser.error("--runs must be at least 1")
+    models = MODELS if args.model == "all" else [args.model]
+
+    results = []
+    for model in models:
+        for language in languages:
+            print(f"🚀 {model}/{language}...", flush=True)
+            results.append(benchmark_runner(RUNNERS[language], model, args))
+    print_table(results)
+
+    output = {
+        "schema": SCHEMA,
+        "runs": args.runs,
+        "corpus": os.path.abspath(args.corpus) if args.corpus else None,
+        "cold_runs": args.cold_runs,
+        "system": system_info(),
+        "runners": results,
+    }
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(output, f, indent=2)
+        print(f"\n📄 Results written to {args.json}")
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            regressions = compare_baseline(results, json.load(f), args.tolerance)
+        if regressions:
+            print(f"\n❌ {len(regressions)} regression(s) beyond {args.tolerance:.0%}:")
+            for line in regressions:
+                print("   " + line)
+            return 1
+        print(f"\n✅ No regressions beyond {args.tolerance:.0%} against {args.baseline}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,486 @@
+#include <onnxruntime_cxx_api.h>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <exception>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+
+#include "whitelightning/core.hpp"
+
+using namespace whitelightning;
+
+// Highest-scoring index of scores
+size_t argmax(const std::vector<float>& scores) {
+    return static_cast<size_t>(std::max_element(scores.begin(), scores.end()) - scores.begin());
+}
+
+void print_merged_result(const std::string& text, FanOutClassifier& classifier, const FanOutResult& result,
+                         float threshold) {
+    std::cout << "📊 MERGED RESULTS:\n";
+    if (result.has_sentiment) {
+        std::cout << "   😊 Sentiment: " << (result.sentiment > 0.5f ? "Positive" : "Negative") << " (" << std::fixed
+                  << std::setprecision(1) << result.sentiment * 100.0 << "% positive)\n";
+    }
+    if (!result.topic.empty()) {
+        size_t best = argmax(result.topic);
+        std::cout << "   🏷️ Topic: " << classifier.topic_labels()[best] << " (" << std::fixed << std::setprecision(1)
+                  << result.topic[best] * 100.0 << "%)\n";
+    }
+    if (!result.emotions.empty()) {
+        auto detected = detected_emotions(result.emotions.data(), result.emotions.size(), threshold);
+        std::cout << "   🎭 Emotions (threshold " << std::fixed << std::setprecision(2) << threshold << "): ";
+        if (detected.empty()) {
+            std::cout << "none";
+        }
+        for (size_t i = 0; i < detected.size(); i++) {
+            std::cout << (i ? ", " : "") << classifier.emotion_labels()[detected[i]] << " (" << std::setprecision(1)
+                      << result.emotions[detected[i]] * 100.0 << "%)";
+        }
+        std::cout << "\n";
+    }
+    std::cout << "   📝 Input Text: \"" << text << "\"\n\n";
+}
+
+// The merged result as one JSON object
+json merged_result_json(FanOutClassifier& classifier, const FanOutResult& result, float threshold) {
+    json out = json::object();
+    if (result.has_sentiment) {
+        out["sentiment"] = {{"label", result.sentiment > 0.5f ? "positive" : "negative"},
+                            {"probability", result.sentiment}};
+    }
+    if (!result.topic.empty()) {
+        size_t best = argmax(result.topic);
+        out["topic"] = {{"label", classifier.topic_labels()[best]}, {"confidence", result.topic[best]}};
+    }
+    if (!result.emotions.empty()) {
+        json emotions = json::object();
+        for (size_t i : detected_emotions(result.emotions.data(), result.emotions.size(), threshold)) {
+            emotions[classifier.emotion_labels()[i]] = result.emotions[i];
+        }
+        out["emotions"] = emotions;
+    }
+    return out;
+}
+
+int test_single_text(const std::string& text, FanOutClassifier& classifier, float threshold) {
+    std::cout << "🔄 Processing: " << text << "\n";
+    
+    SystemInfo system_info;
+    get_system_info(system_info);
+    print_system_info(system_info);
+    
+    TimingMetrics timing;
+    ResourceMetrics resources;
+    
+    double total_start = get_time_ms();
+    resources.memory_start_mb = get_memory_usage_mb();
+    start_cpu_monitoring();
+    
+    try {
+        FanOutResult result = classifier.classify(text);
+        double models_end = get_time_ms();
+        
+        // Post-processing: one merged result
+        json merged = merged_result_json(classifier, result, threshold);
+        timing.postprocessing_time_ms = get_time_ms() - models_end;
+        
+        timing.total_time_ms = get_time_ms() - total_start;
+        timing.preprocessing_time_ms = result.tokenize_ms;
+        timing.inference_time_ms = timing.total_time_ms - timing.preprocessing_time_ms - timing.postprocessing_time_ms;
+        timing.throughput_per_sec = 1000.0 / timing.total_time_ms;
+        resources.memory_end_mb = get_memory_usage_mb();
+        resources.memory_delta_mb = resources.memory_end_mb - resources.memory_start_mb;
+        stop_cpu_monitoring(resources);
+        
+        print_merged_result(text, classifier, result, threshold);
+        std::cout << "⏱️ MODELS (vectorize + Run, concurrent):\n";
+        if (classifier.binary()) std::cout << "   Binary: " << std::fixed << std::setprecision(3) << result.binary_ms << "ms\n";
+        if (classifier.topic()) std::cout << "   Topic: " << std::fixed << std::setprecision(3) << result.topic_ms << "ms\n";
+        if (classifier.emotion()) std::cout << "   Emotion: " << std::fixed << std::setprecision(3) << result.emotion_ms << "ms\n";
+        std::cout << "   Shared tokenization: " << std::fixed << std::setprecision(3) << result.tokenize_ms << "ms\n\n";
+        
+        print_performance_summary(timing, resources);
+        return 0;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error: " << e.what() << std::endl;
+        stop_cpu_monitoring(resources);
+        return 1;
+    }
+}
+
+// What three separate processes do today: each model tokenizes the text
+// itself and the sessions run one after the other
+void classify_separately(FanOutClassifier& classifier, const std::string& text) {
+    if (BinaryClassifier* binary = classifier.binary()) {
+        auto& binding = binary->binding();
+        binary->preprocess_into(text, binding.input(1));
+        binding.run();
+    }
+    if (TopicClassifier* topic = classifier.topic()) {
+        auto& binding = topic->binding();
+        topic->preprocess_into(text, binding);
+        binding.run();
+    }
+    if (EmotionClassifier* emotion = classifier.emotion()) {
+        auto& binding = emotion->binding();
+        emotion->preprocess_into(text, binding.input());
+        binding.run();
+    }
+}
+
+int run_performance_benchmark(FanOutClassifier& classifier, int num_runs, double budget_ms, float threshold,
+                              const std::string& report_path = "", const Corpus* corpus = nullptr) {
+    std::cout << "\n🚀 PERFORMANCE BENCHMARKING (" << num_runs << " runs, " << classifier.model_count() << " models)\n";
+    std::cout << "============================================================\n";
+    
+    SystemInfo system_info;
+    get_system_info(system_info);
+    std::cout << "💻 System: " << system_info.cpu_count_physical << " cores, "
+              << std::fixed << std::setprecision(1) << system_info.total_memory_gb << "GB RAM\n";
+    
+    Corpus builtin;
+    if (corpus == nullptr) {
+        builtin.source = "built-in";
+        builtin.texts = {"Great match tonight, I'm so happy our team won the championship!"};
+        corpus = &builtin;
+        std::cout << "📝 Test Text: '" << builtin.texts[0] << "'\n\n";
+    } else {
+        std::cout << "📚 Corpus: " << corpus->source << " (" << corpus->texts.size() << " texts"
+                  << (corpus->shuffled ? ", shuffled with seed " + std::to_string(corpus->seed) : "") << ")\n\n";
+    }
+    const std::vector<std::string>& texts = corpus->texts;
+    
+    try {
+        std::cout << "🔥 Warming up models (5 runs)...\n";
+        for (int i = 0; i < 5; i++) {
+            classifier.classify(texts[i % texts.size()]);
+            classify_separately(classifier, texts[i % texts.size()]);
+        }
+        
+        // Fan-out: shared tokenization, then every model concurrently
+        LatencyHistogram latency;
+        LatencyHistogram tokenize;
+        LatencyHistogram models;
+        LatencyHistogram merge;
+        LatencyHistogram binary, topic, emotion;
+        size_t within_budget = 0;
+        
+        std::cout << "📊 Running " << num_runs << " fan-out requests...\n";
+        ResourceMetrics resources;
+        start_cpu_monitoring();
+        double overall_start = get_time_ms();
+        for (int i = 0; i < num_runs; i++) {
+            const std::string& text = texts[static_cast<size_t>(i) % texts.size()];
+            double start_time = get_time_ms();
+            FanOutResult result = classifier.classify(text);
+            double merge_start = get_time_ms();
+            json merged = merged_result_json(classifier, result, threshold);
+            double end_time = get_time_ms();
+            
+            latency.record_ms(end_time - start_time);
+            tokenize.record_ms(result.tokenize_ms);
+            models.record_ms(merge_start - start_time - result.tokenize_ms);
+            merge.record_ms(end_time - merge_start);
+            if (classifier.binary()) binary.record_ms(result.binary_ms);
+            if (classifier.topic()) topic.record_ms(result.topic_ms);
+            if (classifier.emotion()) emotion.record_ms(result.emotion_ms);
+            within_budget += budget_ms > 0 && end_time - start_time <= budget_ms;
+        }
+        double overall_time = get_time_ms() - overall_start;
+        stop_cpu_monitoring(resources);
+        double cpu_seconds_per_1k = resources.cpu_seconds * 1000.0 / num_runs;
+        
+        // Baseline: every model on its own, one after the other
+        std::cout << "📊 Running " << num_runs << " separate-model requests...\n";
+        LatencyHistogram separate;
+        ResourceMetrics separate_resources;
+        start_cpu_monitoring();
+        for (int i = 0; i < num_runs; i++) {
+            double start_time = get_time_ms();
+            classify_separately(classifier, texts[static_cast<size_t>(i) % texts.size()]);
+            separate.record_ms(get_time_ms() - start_time);
+        }
+        stop_cpu_monitoring(separate_resources);
+        double separate_cpu_seconds_per_1k = separate_resources.cpu_seconds * 1000.0 / num_runs;
+        
+        std::cout << "\n📈 DETAILED PERFORMANCE RESULTS:\n";
+        std::cout << "--------------------------------------------------\n";
+        std::cout << "⏱️  END-TO-END LATENCY (fan-out: tokenize once + concurrent models + merge):\n";
+        std::cout << "   Mean: " << std::fixed << std::setprecision(3) << latency.mean_ms() << "ms\n";
+        std::cout << "   p50: " << latency.percentile_ms(50) << "ms\n";
+        std::cout << "   p90: " << latency.percentile_ms(90) << "ms\n";
+        std::cout << "   p99: " << latency.percentile_ms(99) << "ms\n";
+        std::cout << "   p99.9: " << latency.percentile_ms(99.9) << "ms\n";
+        std::cout << "   Max: " << latency.max_ms() << "ms\n";
+        std::cout << "\n🔬 PHASES (mean / p99):\n";
+        std::cout << "   Shared tokenization: " << tokenize.mean_ms() << "ms / " << tokenize.percentile_ms(99) << "ms\n";
+        std::cout << "   Models (concurrent): " << models.mean_ms() << "ms / " << models.percentile_ms(99) << "ms\n";
+        if (classifier.binary()) std::cout << "   ┣━ Binary: " << binary.mean_ms() << "ms / " << binary.percentile_ms(99) << "ms\n";
+        if (classifier.topic()) std::cout << "   ┣━ Topic: " << topic.mean_ms() << "ms / " << topic.percentile_ms(99) << "ms\n";
+        if (classifier.emotion()) std::cout << "   ┣━ Emotion: " << emotion.mean_ms() << "ms / " << emotion.percentile_ms(99) << "ms\n";
+        std::cout << "   Merge: " << merge.mean_ms() << "ms / " << merge.percentile_ms(99) << "ms\n";
+        std::cout << "\n⚖️ SEPARATE MODELS (each tokenizes, run in sequence):\n";
+        std::cout << "   Mean: " << separate.mean_ms() << "ms, p50: " << separate.percentile_ms(50) << "ms, p99: "
+                  << separate.percentile_ms(99) << "ms\n";
+        std::cout << "   Fan-out speedup (mean): " << std::setprecision(2) << separate.mean_ms() / latency.mean_ms() << "x\n";
+        if (budget_ms > 0) {
+            std::cout << "\n🎯 LATENCY BUDGET (" << std::setprecision(2) << budget_ms << "ms end to end):\n";
+            std::cout << "   Within budget: " << std::setprecision(1) << 100.0 * within_budget / num_runs << "% ("
+                      << within_budget << "/" << num_runs << "), p99 " << std::setprecision(3)
+                      << latency.percentile_ms(99) << "ms\n";
+        }
+        std::cout << "\n🚀 THROUGHPUT:\n";
+        std::cout << "   Texts per second: " << std::setprecision(1) << 1000.0 / latency.mean_ms() << "\n";
+        std::cout << "   Total benchmark time: " << std::setprecision(2) << overall_time / 1000.0 << "s\n";
+        std::cout << "\n💾 RESOURCE USAGE:\n";
+        std::cout << "   CPU Time: " << std::setprecision(3) << resources.cpu_seconds << "s ("
+                  << cpu_seconds_per_1k << " CPU-s per 1k texts; separate models: " << separate_cpu_seconds_per_1k
+                  << ")\n";
+        std::cout << "   CPU Usage: " << std::setprecision(1) << resources.cpu_avg_percent << "% avg, "
+                  << resources.cpu_max_percent << "% peak of " << get_usable_cpu_count() << " cores ("
+                  << resources.cpu_readings_count << " samples every " << g_cpu_monitor.interval_ms << "ms)\n";
+        std::cout << "   Peak RSS: " << std::setprecision(2) << resources.memory_peak_mb << " MB\n";
+        
+        if (!report_path.empty()) {
+            json report = benchmark_report("multi_model", *corpus, num_runs, overall_time, latency,
+                                           tokenize, models, merge, system_info);
+            json per_model = json::object();
+            if (classifier.binary()) per_model["binary"] = latency_summary(binary);
+            if (classifier.topic()) per_model["topic"] = latency_summary(topic);
+            if (classifier.emotion()) per_model["emotion"] = latency_summary(emotion);
+            report["models_ms"] = per_model;
+            report["separate_models"] = {
+                {"latency_ms", latency_summary(separate)},
+                {"cpu_seconds_per_1k_texts", separate_cpu_seconds_per_1k}
+            };
+            report["resources"] = {
+                {"cpu_seconds", resources.cpu_seconds},
+                {"cpu_seconds_per_1k_texts", cpu_seconds_per_1k},
+                {"cpu_avg_percent", resources.cpu_avg_percent},
+                {"cpu_max_percent", resources.cpu_max_percent},
+                {"cpu_sample_interval_ms", g_cpu_monitor.interval_ms},
+                {"cpu_cores", get_usable_cpu_count()},
+                {"peak_rss_mb", resources.memory_peak_mb}
+            };
+            if (budget_ms > 0) {
+                report["budget"] = {{"ms", budget_ms}, {"within", within_budget},
+                                    {"within_ratio", static_cast<double>(within_budget) / num_runs}};
+            }
+            write_benchmark_report(report_path, report);
+        }
+        
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Benchmark error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// Command line: [text] [--benchmark [N]] [--budget-ms MS] [--threshold P] [--report out.json]
+//               [--corpus file [--seed N]] [--binary-dir DIR] [--topic-dir DIR] [--emotion-dir DIR]
+//               [--models binary,topic,emotion] [--intra-op-threads N] [--inter-op-threads N]
+//               [--mmap-model] [--cpu-interval MS] [--provider cpu|xnnpack|cuda|coreml|openvino]
+//               [--pin CPUS|node:N|cores]
+struct CliOptions {
+    std::string mode = "test";
+    std::string text;
+    std::string report_path;
+    std::string corpus_path;
+    bool shuffle = false;
+    uint64_t seed = 0;
+    int num_runs = 0;
+    double budget_ms = 0.0;
+    float threshold = 0.5f;
+    std::string binary_dir = "../../binary_classifier/cpp";
+    std::string topic_dir = "../../multiclass_classifier/cpp";
+    std::string emotion_dir = "../../multiclass_sigmoid/cpp";
+    std::string models = "binary,topic,emotion";
+    SessionConfig session;
+    CpuPlacement placement;
+};
+
+bool parse_cli_options(int argc, char* argv[], CliOptions& options) {
+    auto is_number = [](const char* s) {
+        return *s != '\0' && std::all_of(s, s + std::strlen(s), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); });
+    };
+    auto read_count = [&](int& i, const std::string& name, int& value) {
+        if (i + 1 >= argc || !is_number(argv[i + 1]) || std::atoi(argv[i + 1]) < 1) {
+            std::cerr << "❌ " << name << " requires a positive integer\n";
+            return false;
+        }
+        value = std::atoi(argv[++i]);
+        return true;
+    };
+    auto read_path = [&](int& i, const std::string& name, std::string& value) {
+        if (i + 1 >= argc) {
+            std::cerr << "❌ " << name << " requires a path\n";
+            return false;
+        }
+        value = argv[++i];
+        return true;
+    };
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--benchmark") {
+            options.mode = "benchmark";
+            options.num_runs = 100;
+            if (i + 1 < argc && is_number(argv[i + 1])) {
+                options.num_runs = std::max(1, std::atoi(argv[++i]));
+            }
+        } else if (arg == "--budget-ms" || arg == "--threshold") {
+            char* end = nullptr;
+            double value = i + 1 < argc ? std::strtod(argv[i + 1], &end) : -1.0;
+            bool valid = end != nullptr && *end == '\0' && (arg == "--budget-ms" ? value > 0.0 : value >= 0.0 && value <= 1.0);
+            if (!valid) {
+                std::cerr << "❌ " << arg << (arg == "--budget-ms" ? " requires a positive number of milliseconds\n"
+                                                                   : " requires a probability between 0 and 1\n");
+                return false;
+            }
+            if (arg == "--budget-ms") {
+                options.budget_ms = value;
+            } else {
+                options.threshold = static_cast<float>(value);
+            }
+            i++;
+        } else if (arg == "--report") {
+            if (!read_path(i, arg, options.report_path)) return false;
+        } else if (arg == "--corpus") {
+            if (!read_path(i, arg, options.corpus_path)) return false;
+        } else if (arg == "--pin") {
+            if (i + 1 >= argc) {
+                std::cerr << "❌ --pin requires a CPU list (0-3,8), node:N or cores\n";
+                return false;
+            }
+            try {
+                options.placement = resolve_cpu_placement(argv[++i]);
+            } catch (const std::exception& e) {
+                std::cerr << "❌ --pin: " << e.what() << "\n";
+                return false;
+            }
+            options.session.pinned_cpus = options.placement.cpus;
+        } else if (arg == "--seed") {
+            if (i + 1 >= argc || !is_number(argv[i + 1])) {
+                std::cerr << "❌ --seed requires a non-negative integer\n";
+                return false;
+            }
+            options.seed = std::stoull(argv[++i]);
+            options.shuffle = true;
+        } else if (arg == "--binary-dir") {
+            if (!read_path(i, arg, options.binary_dir)) return false;
+        } else if (arg == "--topic-dir") {
+            if (!read_path(i, arg, options.topic_dir)) return false;
+        } else if (arg == "--emotion-dir") {
+            if (!read_path(i, arg, options.emotion_dir)) return false;
+        } else if (arg == "--models") {
+            if (!read_path(i, arg, options.models)) return false;
+        } else if (arg == "--mmap-model") {
+            options.session.mmap_model = true;
+        } else if (arg == "--provider") {
+            if (i + 1 >= argc || !parse_execution_provider(argv[i + 1], options.session.provider)) {
+                std::cerr << "❌ --provider requires cpu, xnnpack, cuda, coreml or openvino\n";
+                return false;
+            }
+            i++;
+        } else if (arg == "--cpu-interval") {
+            if (!read_count(i, arg, g_cpu_monitor.interval_ms)) return false;
+        } else if (arg == "--intra-op-threads") {
+            if (!read_count(i, arg, options.session.intra_op_threads)) return false;
+        } else if (arg == "--inter-op-threads") {
+            if (!read_count(i, arg, options.session.inter_op_threads)) return false;
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return false;
+        } else {
+            options.text = arg;
+        }
+    }
+    return true;
+}
+
+// dir when --models names the model and its three files exist, else ""
+std::string usable_model_dir(const CliOptions& options, const std::string& name, const std::string& dir) {
+    std::string list = "," + options.models + ",";
+    if (list.find("," + name + ",") == std::string::npos) return "";
+    std::string prefix = dir.empty() || dir.back() == '/' ? dir : dir + "/";
+    for (const char* file : {"model.onnx", "vocab.json", "scaler.json"}) {
+        if (!std::ifstream(prefix + file).good()) {
+            std::cout << "⚠️ Skipping " << name << ": " << prefix + file << " not found\n";
+            return "";
+        }
+    }
+    return dir;
+}
+
+int main(int argc, char* argv[]) {
+    CliOptions options;
+    if (!parse_cli_options(argc, argv, options)) {
+        return 1;
+    }
+    
+    std::cout << "🤖 ONNX MULTI-MODEL FAN-OUT - C++ IMPLEMENTATION\n";
+    std::cout << "================================================\n";
+    
+    FanOutModels models;
+    models.binary_dir = usable_model_dir(options, "binary", options.binary_dir);
+    models.topic_dir = usable_model_dir(options, "topic", options.topic_dir);
+    models.emotion_dir = usable_model_dir(options, "emotion", options.emotion_dir);
+    if (models.binary_dir.empty() && models.topic_dir.empty() && models.emotion_dir.empty()) {
+        std::cout << "⚠️ Model files not found - exiting safely\n";
+        std::cout << "🔧 This is expected in CI environments without model files\n";
+        std::cout << "✅ C++ implementation compiled successfully\n";
+        std::cout << "🏗️ Build verification completed\n";
+        return 0;
+    }
+    
+    // --pin: before the models load, so their sessions and buffers are
+    // allocated on the placement's node
+    apply_cpu_placement(options.placement);
+    
+    // Load every model once; they share one tokenizer pass and one pool
+    std::unique_ptr<FanOutClassifier> classifier;
+    try {
+        double load_start = get_time_ms();
+        classifier = std::make_unique<FanOutClassifier>(models, options.session);
+        std::cout << "🔧 " << classifier->model_count() << " models loaded in " << std::fixed << std::setprecision(2)
+                  << get_time_ms() - load_start << "ms";
+        std::cout << " (" << (classifier->binary() ? "binary " : "") << (classifier->topic() ? "topic " : "")
+                  << (classifier->emotion() ? "emotion" : "") << ")\n";
+        if (options.session.provider != ExecutionProvider::Cpu) {
+            std::cout << "🖥️ Provider:";
+            if (classifier->binary()) std::cout << " binary " << execution_provider_name(classifier->binary()->provider());
+            if (classifier->topic()) std::cout << " topic " << execution_provider_name(classifier->topic()->provider());
+            if (classifier->emotion()) std::cout << " emotion " << execution_provider_name(classifier->emotion()->provider());
+            std::cout << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error loading model: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    if (options.mode == "benchmark") {
+        std::unique_ptr<Corpus> corpus;
+        if (!options.corpus_path.empty()) {
+            try {
+                corpus = std::make_unique<Corpus>(load_corpus(options.corpus_path, options.shuffle, options.seed));
+            } catch (const std::exception& e) {
+                std::cerr << "❌ Error: " << e.what() << std::endl;
+                return 1;
+            }
+        }
+        return run_performance_benchmark(*classifier, options.num_runs, options.budget_ms, options.threshold,
+                                         options.report_path, corpus.get());
+    }
+    
+    const std::string default_text = "Great match tonight, I'm so happy our team won the championship!";
+    return test_single_text(options.text.empty() ? default_text : options.text, *classifier, options.threshold);
+}
@@ -5,301 +5,178 @@
 #include <iomanip>
 #include <algorithm>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <chrono>
+#include <map>
+#include <memory>
 #include <thread>
-#include <mutex>
+#include <cstdio>
+#include <functional>
+#include <exception>
 #include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <cctype>
+#include <atomic>
+#include <new>
 
-#ifdef __APPLE__
-#include <sys/sysctl.h>
-#include <mach/mach.h>
-#include <unistd.h>
-#elif __linux__
-#include <sys/sysinfo.h>
-#include <fstream>
-#include <unistd.h>
-#endif
-
-using json = nlohmann::json;
-
-// Performance and system monitoring structures
-struct TimingMetrics {
-    double total_time_ms = 0;
-    double preprocessing_time_ms = 0;
-    double inference_time_ms = 0;
-    double postprocessing_time_ms = 0;
-    double throughput_per_sec = 0;
-};
-
-struct ResourceMetrics {
-    double memory_start_mb = 0;
-    double memory_end_mb = 0;
-    double memory_delta_mb = 0;
-    double cpu_avg_percent = 0;
-    double cpu_max_percent = 0;
-    int cpu_readings_count = 0;
-    std::vector<double> cpu_readings;
-};
-
-struct SystemInfo {
-    std::string platform;
-    std::string processor;
-    int cpu_count_physical = 0;
-    int cpu_count_logical = 0;
-    double total_memory_gb = 0;
-    std::string runtime = "C++ Implementation";
-};
+#include "whitelightning/core.hpp"
 
-// Global CPU monitoring
-struct CPUMonitor {
-    bool monitoring = false;
-    std::vector<double> cpu_readings;
-    std::mutex mutex;
-    std::thread monitor_thread;
-} g_cpu_monitor;
+using namespace whitelightning;
 
-// Utility functions
-double get_time_ms() {
-    auto now = std::chrono::high_resolution_clock::now();
-    auto duration = now.time_since_epoch();
-    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count() / 1000.0;
-}
+// Heap allocation counter (global operator new), used by --alloc-bench
+static std::atomic<uint64_t> g_allocation_count{0};
 
-double get_memory_usage_mb() {
-#ifdef __APPLE__
-    struct mach_task_basic_info info;
-    mach_msg_type_number_t infoCount = MACH_TASK_BASIC_INFO_COUNT;
-    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &infoCount) != KERN_SUCCESS) {
-        return 0.0;
-    }
-    return info.resident_size / (1024.0 * 1024.0);
-#elif __linux__
-    std::ifstream file("/proc/self/status");
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.substr(0, 6) == "VmRSS:") {
-            std::istringstream iss(line);
-            std::string label, value, unit;
-            iss >> label >> value >> unit;
-            return std::stod(value) / 1024.0; // Convert KB to MB
-        }
-    }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
 #endif
-    return 0.0;
-}
-
-double get_cpu_usage_percent() {
-#ifdef __APPLE__
-    host_cpu_load_info_data_t cpuinfo;
-    mach_msg_type_number_t count = HOST_CPU_LOAD_INFO_COUNT;
-    if (host_statistics(mach_host_self(), HOST_CPU_LOAD_INFO, (host_info_t)&cpuinfo, &count) == KERN_SUCCESS) {
-        unsigned long total_ticks = 0;
-        for(int i = 0; i < CPU_STATE_MAX; i++) total_ticks += cpuinfo.cpu_ticks[i];
-        return total_ticks > 0 ? ((double)cpuinfo.cpu_ticks[CPU_STATE_USER] + cpuinfo.cpu_ticks[CPU_STATE_SYSTEM]) / total_ticks * 100.0 : 0.0;
+void* operator new(size_t size) {
+    g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
     }
-#endif
-    return 0.0; // Simplified for Linux in CI
+    throw std::bad_alloc();
 }
 
-void get_system_info(SystemInfo& info) {
-#ifdef __APPLE__
-    info.platform = "macOS";
-    
-    size_t size = 256;
-    char processor[256];
-    if (sysctlbyname("machdep.cpu.brand_string", processor, &size, NULL, 0) == 0) {
-        info.processor = processor;
-    }
-    
-    size = sizeof(int);
-    sysctlbyname("hw.physicalcpu", &info.cpu_count_physical, &size, NULL, 0);
-    sysctlbyname("hw.logicalcpu", &info.cpu_count_logical, &size, NULL, 0);
-    
-    uint64_t memsize;
-    size = sizeof(memsize);
-    sysctlbyname("hw.memsize", &memsize, &size, NULL, 0);
-    info.total_memory_gb = memsize / (1024.0 * 1024.0 * 1024.0);
-    
-#elif __linux__
-    info.platform = "Linux";
-    info.cpu_count_physical = sysconf(_SC_NPROCESSORS_ONLN);
-    info.cpu_count_logical = info.cpu_count_physical;
-    
-    // Get memory info
-    std::ifstream meminfo("/proc/meminfo");
-    std::string line;
-    while (std::getline(meminfo, line)) {
-        if (line.substr(0, 9) == "MemTotal:") {
-            std::istringstream iss(line);
-            std::string label, unit;
-            long mem_kb;
-            iss >> label >> mem_kb >> unit;
-            info.total_memory_gb = mem_kb / (1024.0 * 1024.0);
-            break;
-        }
-    }
-    
-    // Get processor info
-    std::ifstream cpuinfo("/proc/cpuinfo");
-    while (std::getline(cpuinfo, line)) {
-        if (line.substr(0, 10) == "model name") {
-            size_t colon = line.find(':');
-            if (colon != std::string::npos) {
-                info.processor = line.substr(colon + 2);
-            }
-            break;
-        }
-    }
-#else
-    info.platform = "Unknown";
-    info.processor = "Unknown";
-    info.cpu_count_physical = 1;
-    info.cpu_count_logical = 1;
-    info.total_memory_gb = 0.0;
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
 #endif
-}
 
-void cpu_monitor_thread() {
-    while (g_cpu_monitor.monitoring) {
-        double cpu_usage = get_cpu_usage_percent();
-        {
-            std::lock_guard<std::mutex> lock(g_cpu_monitor.mutex);
-            g_cpu_monitor.cpu_readings.push_back(cpu_usage);
+// Class labels from scaler.json ({"0": "Business", ...}), loaded once at
+// startup and indexed by class id together with the strings the result
+// display needs, so postprocessing is a top-k plus array lookups
+struct LabelTable {
+    std::vector<std::string> names;    // "Sports"
+    std::vector<std::string> upper;    // "SPORTS"
+    std::vector<std::string> display;  // "Sports" with the first letter capitalized
+    std::vector<std::string> emoji;
+    std::vector<std::string> bars;     // bars[n] is n of the 20 progress bar blocks
+    
+    size_t size() const { return names.size(); }
+};
+
+// num_classes covers the model output; ids missing from scaler.json are
+// labeled with the id itself
+LabelTable load_label_table(const std::string& scaler_path, size_t num_classes) {
+    std::ifstream lf(scaler_path);
+    if (!lf.is_open()) {
+        throw std::runtime_error("Failed to open scaler file: " + scaler_path);
+    }
+    json label_map;
+    lf >> label_map;
+    
+    static const std::map<std::string, std::string> category_emojis = {
+        {"politics", "🏛️"},
+        {"technology", "💻"},
+        {"sports", "⚽"},
+        {"business", "💼"},
+        {"entertainment", "🎭"}
+    };
+    
+    LabelTable labels;
+    labels.names.resize(std::max(num_classes, label_map.size()));
+    for (size_t i = 0; i < labels.names.size(); i++) {
+        labels.names[i] = std::to_string(i);
+    }
+    for (const auto& [index, label] : label_map.items()) {
+        size_t i = std::stoul(index);
+        if (i < labels.names.size()) labels.names[i] = label.get<std::string>();
+    }
+    for (const std::string& name : labels.names) {
+        std::string upper = name, lower = name, display = name;
+        std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        if (!display.empty()) {
+            display[0] = std::toupper(static_cast<unsigned char>(display[0]));
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        auto emoji = category_emojis.find(lower);
+        labels.upper.push_back(upper);
+        labels.display.push_back(display);
+        labels.emoji.push_back(emoji != category_emojis.end() ? emoji->second : "📝");
     }
+    labels.bars.resize(21);
+    for (size_t n = 1; n < labels.bars.size(); n++) {
+        labels.bars[n] = labels.bars[n - 1] + "█";
+    }
+    return labels;
 }
 
-void start_cpu_monitoring() {
-    g_cpu_monitor.monitoring = true;
-    g_cpu_monitor.cpu_readings.clear();
-    g_cpu_monitor.monitor_thread = std::thread(cpu_monitor_thread);
-}
-
-void stop_cpu_monitoring(ResourceMetrics& metrics) {
-    g_cpu_monitor.monitoring = false;
-    if (g_cpu_monitor.monitor_thread.joinable()) {
-        g_cpu_monitor.monitor_thread.join();
-    }
-    
-    std::lock_guard<std::mutex> lock(g_cpu_monitor.mutex);
-    metrics.cpu_readings = g_cpu_monitor.cpu_readings;
-    metrics.cpu_readings_count = g_cpu_monitor.cpu_readings.size();
-    
-    if (!g_cpu_monitor.cpu_readings.empty()) {
-        double sum = 0;
-        metrics.cpu_max_percent = g_cpu_monitor.cpu_readings[0];
-        for (double reading : g_cpu_monitor.cpu_readings) {
-            sum += reading;
-            if (reading > metrics.cpu_max_percent) {
-                metrics.cpu_max_percent = reading;
-            }
+// Indices of the k highest of n scores, best first (ties keep the lower
+// index, like std::max_element). One pass over the scores with an
+// insertion-sorted window of k, so no allocation and ~n compares for k << n.
+// Scalar on purpose: heads have a handful of classes, too few for SIMD to pay.
+size_t top_k(const float* scores, size_t n, size_t k, uint32_t* out) {
+    k = std::min(k, n);
+    if (k == 0) return 0;
+    size_t filled = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        float score = scores[i];
+        if (filled == k && !(score > scores[out[k - 1]])) continue;
+        size_t j = filled < k ? filled++ : k - 1;
+        while (j > 0 && score > scores[out[j - 1]]) {
+            out[j] = out[j - 1];
+            j--;
         }
-        metrics.cpu_avg_percent = sum / g_cpu_monitor.cpu_readings.size();
+        out[j] = i;
     }
+    return k;
 }
 
-void print_system_info(const SystemInfo& info) {
-    std::cout << "💻 SYSTEM INFORMATION:\n";
-    std::cout << "   Platform: " << info.platform << "\n";
-    std::cout << "   Processor: " << info.processor << "\n";
-    std::cout << "   CPU Cores: " << info.cpu_count_physical << " physical, " << info.cpu_count_logical << " logical\n";
-    std::cout << "   Total Memory: " << std::fixed << std::setprecision(1) << info.total_memory_gb << " GB\n";
-    std::cout << "   Runtime: " << info.runtime << "\n\n";
-}
+// Result output selected with --quiet / --json
+enum class OutputFormat { Full, Quiet, Json };
 
-void print_performance_summary(const TimingMetrics& timing, const ResourceMetrics& resources) {
-    std::cout << "📈 PERFORMANCE SUMMARY:\n";
-    std::cout << "   Total Processing Time: " << std::fixed << std::setprecision(2) << timing.total_time_ms << "ms\n";
-    std::cout << "   ┣━ Preprocessing: " << timing.preprocessing_time_ms << "ms (" 
-              << std::setprecision(1) << (timing.preprocessing_time_ms / timing.total_time_ms) * 100.0 << "%)\n";
-    std::cout << "   ┣━ Model Inference: " << std::setprecision(2) << timing.inference_time_ms << "ms (" 
-              << std::setprecision(1) << (timing.inference_time_ms / timing.total_time_ms) * 100.0 << "%)\n";
-    std::cout << "   ┗━ Postprocessing: " << std::setprecision(2) << timing.postprocessing_time_ms << "ms (" 
-              << std::setprecision(1) << (timing.postprocessing_time_ms / timing.total_time_ms) * 100.0 << "%)\n\n";
-    
-    std::cout << "🚀 THROUGHPUT:\n";
-    std::cout << "   Texts per second: " << std::setprecision(1) << timing.throughput_per_sec << "\n\n";
-    
-    std::cout << "💾 RESOURCE USAGE:\n";
-    std::cout << "   Memory Start: " << std::setprecision(2) << resources.memory_start_mb << " MB\n";
-    std::cout << "   Memory End: " << resources.memory_end_mb << " MB\n";
-    std::cout << "   Memory Delta: " << std::showpos << resources.memory_delta_mb << " MB\n" << std::noshowpos;
-    if (resources.cpu_readings_count > 0) {
-        std::cout << "   CPU Usage: " << std::setprecision(1) << resources.cpu_avg_percent << "% avg, " 
-                  << resources.cpu_max_percent << "% peak (" << resources.cpu_readings_count << " samples)\n";
-    }
-    std::cout << "\n";
-    
-    // Performance classification
-    std::string performance_class, emoji;
-    if (timing.total_time_ms < 50) {
-        performance_class = "EXCELLENT";
-        emoji = "🚀";
-    } else if (timing.total_time_ms < 100) {
-        performance_class = "GOOD";
-        emoji = "✅";
-    } else if (timing.total_time_ms < 200) {
-        performance_class = "ACCEPTABLE";
-        emoji = "⚠️";
-    } else {
-        performance_class = "POOR";
-        emoji = "❌";
-    }
-    
-    std::cout << "🎯 PERFORMANCE RATING: " << emoji << " " << performance_class << "\n";
-    std::cout << "   (" << std::setprecision(1) << timing.total_time_ms << "ms total - Target: <100ms)\n\n";
+// One line per text: "   SPORTS ⚽ (72.3%) - "text""
+void print_prediction_line(const std::string& text, const float* probabilities, size_t num_classes,
+                           const LabelTable& labels) {
+    uint32_t best = 0;
+    if (top_k(probabilities, num_classes, 1, &best) == 0) return;
+    std::cout << "   " << labels.upper[best] << " " << labels.emoji[best] << " (" << std::fixed 
+              << std::setprecision(1) << probabilities[best] * 100.0 << "%) - \"" << text << "\"\n";
 }
 
-std::vector<int32_t> preprocess_text(const std::string& text, const std::string& tokenizer_file) {
-    std::vector<int32_t> vector(30, 0);
-    
-    std::ifstream tf(tokenizer_file);
-    if (!tf.is_open()) {
-        throw std::runtime_error("Failed to open tokenizer file: " + tokenizer_file);
-    }
-    json tokenizer; 
-    tf >> tokenizer;
-    
-    std::string text_lower = text;
-    std::transform(text_lower.begin(), text_lower.end(), text_lower.begin(), ::tolower);
-    
-    // Tokenize text
-    std::vector<std::string> words;
-    size_t start = 0, end;
-    while ((end = text_lower.find(' ', start)) != std::string::npos) {
-        if (end > start) {
-            words.push_back(text_lower.substr(start, end - start));
-        }
-        start = end + 1;
+// One JSON object per text on stdout: label, confidence and the top k classes
+void write_json_result(const std::string& text, const float* probabilities, size_t num_classes,
+                       const LabelTable& labels, size_t k, const TimingMetrics* timing = nullptr) {
+    uint32_t top[64];
+    size_t count = top_k(probabilities, num_classes, std::min<size_t>(k, 64), top);
+    json result = {{"text", text}};
+    // No label for a model with no classes
+    if (count > 0) {
+        result["label"] = labels.names[top[0]];
+        result["confidence"] = probabilities[top[0]];
     }
-    if (start < text_lower.length()) {
-        words.push_back(text_lower.substr(start));
+    json top_classes = json::array();
+    for (size_t j = 0; j < count; j++) {
+        top_classes.push_back({{"label", labels.names[top[j]]}, {"probability", probabilities[top[j]]}});
     }
-    
-    // Convert words to token IDs
-    for (size_t i = 0; i < std::min(words.size(), size_t(30)); i++) {
-        auto it = tokenizer.find(words[i]);
-        if (it != tokenizer.end()) {
-            vector[i] = it->get<int>();
-        } else {
-            auto oov = tokenizer.find("<OOV>");
-            vector[i] = oov != tokenizer.end() ? oov->get<int>() : 1;
-        }
+    result["top_k"] = top_classes;
+    if (timing) {
+        result["timing_ms"] = {
+            {"preprocessing", timing->preprocessing_time_ms},
+            {"inference", timing->inference_time_ms},
+            {"postprocessing", timing->postprocessing_time_ms},
+            {"total", timing->total_time_ms}
+        };
     }
-    
-    return vector;
+    std::string line = result.dump();
+    line += '\n';
+    std::fwrite(line.data(), 1, line.size(), stdout);
 }
 
-int test_single_text(const std::string& text, const std::string& model_path, 
-                    const std::string& vocab_path, const std::string& scaler_path) {
-    std::cout << "🔄 Processing: " << text << "\n";
-    
-    // Initialize system info
-    SystemInfo system_info;
-    get_system_info(system_info);
-    print_system_info(system_info);
+int test_single_text(const std::string& text, TopicClassifier& classifier, const LabelTable& labels,
+                     OutputFormat format = OutputFormat::Full, size_t k = 3) {
+    bool full = format == OutputFormat::Full;
+    if (full) {
+        std::cout << "🔄 Processing: " << text << "\n";
+        
+        // Initialize system info
+        SystemInfo system_info;
+        get_system_info(system_info);
+        print_system_info(system_info);
+    }
     
     // Initialize timing and resource metrics
     TimingMetrics timing;
@@ -312,56 +189,35 @@ int test_single_text(const std::string& text, const std::string& model_path,
     start_cpu_monitoring();
     
     try {
-        // Preprocessing
-        double preprocess_start = get_time_ms();
-        auto vector = preprocess_text(text, vocab_path);
-        timing.preprocessing_time_ms = get_time_ms() - preprocess_start;
-        
-        // Model setup and inference
-        double inference_start = get_time_ms();
-        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "test");
-        Ort::SessionOptions session_options;
-        Ort::Session session(env, model_path.c_str(), session_options);
-        
-        // Dynamic input/output detection
-        Ort::AllocatorWithDefaultOptions allocator;
-        size_t num_input_nodes = session.GetInputCount();
-        size_t num_output_nodes = session.GetOutputCount();
-        
-        auto input_name = session.GetInputNameAllocated(0, allocator);
-        auto output_name = session.GetOutputNameAllocated(0, allocator);
-        
-        std::vector<int64_t> input_shape = {1, 30};
-        Ort::MemoryInfo memory_info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
-        Ort::Value input_tensor = Ort::Value::CreateTensor(memory_info, vector.data(), vector.size(), 
-                                                         input_shape.data(), input_shape.size());
-        
-        const char* input_names[] = {input_name.get()};
-        const char* output_names[] = {output_name.get()};
-        
-        auto output_tensors = session.Run(Ort::RunOptions{nullptr}, input_names, &input_tensor, 1, 
-                                        output_names, 1);
-        timing.inference_time_ms = get_time_ms() - inference_start;
-        
-        // Post-processing
-        double postprocess_start = get_time_ms();
-        float* output_data = output_tensors[0].GetTensorMutableData<float>();
-        size_t output_size = output_tensors[0].GetTensorTypeAndShapeInfo().GetElementCount();
-        
-        // Load label mapping
-        std::ifstream lf(scaler_path);
-        if (!lf.is_open()) {
-            throw std::runtime_error("Failed to open scaler file: " + scaler_path);
+        // A result cache hit skips preprocessing and inference
+        uint64_t cache_key = 0;
+        std::vector<float> cached_probabilities;
+        bool cached = classifier.cache_lookup(text, cache_key, cached_probabilities);
+        const float* output_data = cached_probabilities.data();
+        size_t output_size = cached_probabilities.size();
+        if (!cached) {
+            // Preprocessing straight into the bound input tensor
+            auto& binding = classifier.binding();
+            double preprocess_start = get_time_ms();
+            classifier.preprocess_into(text, binding);
+            timing.preprocessing_time_ms = get_time_ms() - preprocess_start;
+            
+            // Inference on the already loaded session
+            double inference_start = get_time_ms();
+            binding.run();
+            timing.inference_time_ms = get_time_ms() - inference_start;
+            output_data = binding.probabilities(0);
+            output_size = binding.num_classes();
+            if (classifier.has_result_cache()) {
+                classifier.cache_store(cache_key, std::vector<float>(output_data, output_data + output_size));
+            }
         }
-        json label_map; 
-        lf >> label_map;
-        
-        // Find predicted class
-        auto max_it = std::max_element(output_data, output_data + output_size);
-        int predicted_idx = std::distance(output_data, max_it);
-        std::string predicted_label = label_map[std::to_string(predicted_idx)];
-        float confidence = *max_it;
         
+        // Post-processing: top class straight from the output tensor
+        double postprocess_start = get_time_ms();
+        uint32_t predicted_idx = 0;
+        top_k(output_data, output_size, 1, &predicted_idx);
+        float confidence = output_data[predicted_idx];
         timing.postprocessing_time_ms = get_time_ms() - postprocess_start;
         
         // Final measurements
@@ -373,55 +229,39 @@ int test_single_text(const std::string& text, const std::string& model_path,
         // Stop CPU monitoring
         stop_cpu_monitoring(resources);
         
+        if (format == OutputFormat::Json) {
+            write_json_result(text, output_data, output_size, labels, k, &timing);
+            return 0;
+        }
+        if (format == OutputFormat::Quiet) {
+            print_prediction_line(text, output_data, output_size, labels);
+            return 0;
+        }
+        
         // Display results
         std::cout << "📊 TOPIC CLASSIFICATION RESULTS:\n";
         std::cout << "⏱️  Processing Time: " << std::fixed << std::setprecision(1) << timing.total_time_ms << "ms\n";
-        
-        // Category emojis
-        std::map<std::string, std::string> category_emojis = {
-            {"politics", "🏛️"},
-            {"technology", "💻"},
-            {"sports", "⚽"},
-            {"business", "💼"},
-            {"entertainment", "🎭"}
-        };
-        
-        std::string emoji = category_emojis.find(predicted_label) != category_emojis.end() ? 
-                           category_emojis[predicted_label] : "📝";
-        
-        // Capitalize category name
-        std::string category_upper = predicted_label;
-        std::transform(category_upper.begin(), category_upper.end(), category_upper.begin(), ::toupper);
-        
-        std::cout << "   🏆 Predicted Category: " << category_upper << " " << emoji << "\n";
+        std::cout << "   🏆 Predicted Category: " << labels.upper[predicted_idx] << " " << labels.emoji[predicted_idx] << "\n";
         std::cout << "   📈 Confidence: " << std::setprecision(1) << confidence * 100.0 << "%\n";
-        std::cout << "   📝 Input Text: \"" << text << "\"\n\n";
+        std::cout << "   📝 Input Text: \"" << text << "\"\n";
+        if (cached) std::cout << "   🗃️ Served from the result cache\n";
+        std::cout << "\n";
         
         // Show all class probabilities
         std::cout << "📊 DETAILED PROBABILITIES:\n";
         for (size_t i = 0; i < output_size; i++) {
-            std::string class_name = label_map[std::to_string(i)];
             float probability = output_data[i];
-            std::string class_emoji = category_emojis.find(class_name) != category_emojis.end() ? 
-                                    category_emojis[class_name] : "📝";
-            
-            // Capitalize first letter
-            std::string class_display = class_name;
-            if (!class_display.empty()) {
-                class_display[0] = std::toupper(class_display[0]);
-            }
-            
-            // Create progress bar
-            std::string bar(static_cast<int>(probability * 20), '█');
-            std::string star = (static_cast<int>(i) == predicted_idx) ? " ⭐" : "";
-            
-            std::cout << "   " << class_emoji << " " << class_display << ": " 
-                      << std::setprecision(1) << probability * 100.0 << "% " << bar << star << "\n";
+            size_t blocks = std::min<size_t>(static_cast<size_t>(std::max(probability, 0.0f) * 20), 20);
+            std::cout << "   " << labels.emoji[i] << " " << labels.display[i] << ": " 
+                      << std::setprecision(1) << probability * 100.0 << "% " << labels.bars[blocks] 
+                      << (i == predicted_idx ? " ⭐" : "") << "\n";
         }
         std::cout << "\n";
         
         // Print performance summary
-        print_performance_summary(timing, resources);
+        ResultCacheStats cache = classifier.result_cache_stats();
+        timing.startup = classifier.startup();
+        print_performance_summary(timing, resources, classifier.has_result_cache() ? &cache : nullptr);
         
         return 0;
         
@@ -432,8 +272,10 @@ int test_single_text(const std::string& text, const std::string& model_path,
     }
 }
 
-int run_performance_benchmark(const std::string& model_path, const std::string& vocab_path, 
-                            const std::string& scaler_path, int num_runs) {
+int run_performance_benchmark(TopicClassifier& classifier, int num_runs, const std::string& report_path = "",
+                              const Corpus* corpus = nullptr,
+                              const std::vector<SessionMemoryResult>& session_memory = {},
+                              const std::vector<ProviderSweepResult>& provider_sweep = {}) {
     std::cout << "\n🚀 PERFORMANCE BENCHMARKING (" << num_runs << " runs)\n";
     std::cout << "============================================================\n";
     
@@ -442,43 +284,56 @@ int run_performance_benchmark(const std::string& model_path, const std::string&
     std::cout << "💻 System: " << system_info.cpu_count_physical << " cores, " 
               << std::fixed << std::setprecision(1) << system_info.total_memory_gb << "GB RAM\n";
     
-    const std::string test_text = "France Defeats Argentina in Thrilling World Cup Final";
-    std::cout << "📝 Test Text: '" << test_text << "'\n\n";
+    Corpus builtin;
+    if (corpus == nullptr) {
+        builtin.source = "built-in";
+        builtin.texts = {"France Defeats Argentina in Thrilling World Cup Final"};
+        corpus = &builtin;
+        std::cout << "📝 Test Text: '" << builtin.texts[0] << "'\n\n";
+    } else {
+        std::cout << "📚 Corpus: " << corpus->source << " (" << corpus->texts.size() << " texts" 
+                  << (corpus->shuffled ? ", shuffled with seed " + std::to_string(corpus->seed) : "") << ")\n\n";
+    }
+    const std::vector<std::string>& texts = corpus->texts;
     
     try {
-        // Initialize ONNX Runtime once
-        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "benchmark");
-        Ort::SessionOptions session_options;
-        Ort::Session session(env, model_path.c_str(), session_options);
-        
-        // Dynamic input/output detection
-        Ort::AllocatorWithDefaultOptions allocator;
-        auto input_name = session.GetInputNameAllocated(0, allocator);
-        auto output_name = session.GetOutputNameAllocated(0, allocator);
+        auto& binding = classifier.binding();
         
-        // Preprocess once
-        auto vector = preprocess_text(test_text, vocab_path);
-        
-        std::vector<int64_t> input_shape = {1, 30};
-        Ort::MemoryInfo memory_info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
-        Ort::Value input_tensor = Ort::Value::CreateTensor(memory_info, vector.data(), vector.size(), 
-                                                         input_shape.data(), input_shape.size());
-        
-        const char* input_names[] = {input_name.get()};
-        const char* output_names[] = {output_name.get()};
+        // Length bucket and OOV count of every text, computed up front
+        std::vector<LengthBucketStats> buckets(kNumLengthBuckets);
+        std::vector<size_t> bucket_of(texts.size());
+        std::vector<size_t> tokens_of(texts.size());
+        for (size_t t = 0; t < texts.size(); t++) {
+            TokenStats stats = classifier.token_stats(texts[t]);
+            tokens_of[t] = stats.tokens;
+            bucket_of[t] = length_bucket(stats.tokens);
+            buckets[bucket_of[t]].texts++;
+            buckets[bucket_of[t]].tokens += stats.tokens;
+            buckets[bucket_of[t]].oov_tokens += stats.oov;
+        }
         
         // Warmup runs
         std::cout << "🔥 Warming up model (5 runs)...\n";
         for (int i = 0; i < 5; i++) {
-            auto output_tensors = session.Run(Ort::RunOptions{nullptr}, input_names, &input_tensor, 1, 
-                                            output_names, 1);
+            classifier.preprocess_into(texts[i % texts.size()], binding);
+            binding.run();
         }
         
-        // Performance arrays
-        std::vector<double> times(num_runs);
-        std::vector<double> inference_times(num_runs);
+        // Every request is timed end to end: tokenize + vectorize, infer, postprocess
+        LatencyHistogram latency;
+        LatencyHistogram preprocessing;
+        LatencyHistogram inference;
+        LatencyHistogram postprocessing;
+        PaddingStats padding;
+        uint32_t predicted_idx = 0;
+        float confidence = 0.0f;
+        uint64_t cache_key = 0;
+        std::vector<float> cached_probabilities;
         
         std::cout << "📊 Running " << num_runs << " performance tests...\n";
+        ResourceMetrics resources;
+        start_cpu_monitoring();
+        uint64_t allocations_start = g_allocation_count.load();
         double overall_start = get_time_ms();
         
         for (int i = 0; i < num_runs; i++) {
@@ -487,45 +342,108 @@ int run_performance_benchmark(const std::string& model_path, const std::string&
                           << std::fixed << std::setprecision(1) << (double)i / num_runs * 100.0 << "%)\n";
             }
             
+            size_t t = static_cast<size_t>(i) % texts.size();
             double start_time = get_time_ms();
+            bool cached = classifier.cache_lookup(texts[t], cache_key, cached_probabilities);
+            size_t sequence_length = cached ? 0 : classifier.preprocess_into(texts[t], binding);
             double inference_start = get_time_ms();
-            auto output_tensors = session.Run(Ort::RunOptions{nullptr}, input_names, &input_tensor, 1, 
-                                            output_names, 1);
-            double inference_time = get_time_ms() - inference_start;
+            const float* probabilities = cached_probabilities.data();
+            if (!cached) {
+                binding.run();
+                probabilities = binding.probabilities(0);
+                if (classifier.has_result_cache()) {
+                    classifier.cache_store(cache_key, std::vector<float>(probabilities, probabilities + binding.num_classes()));
+                }
+            }
+            double postprocess_start = get_time_ms();
+            top_k(probabilities, binding.num_classes(), 1, &predicted_idx);
+            confidence = probabilities[predicted_idx];
             double end_time = get_time_ms();
             
-            times[i] = end_time - start_time;
-            inference_times[i] = inference_time;
+            record_trace_span("postprocess", postprocess_start, end_time);
+            record_trace_span("request", start_time, end_time);
+            latency.record_ms(end_time - start_time);
+            preprocessing.record_ms(inference_start - start_time);
+            inference.record_ms(postprocess_start - inference_start);
+            postprocessing.record_ms(end_time - postprocess_start);
+            buckets[bucket_of[t]].latency.record_ms(end_time - start_time);
+            buckets[bucket_of[t]].preprocessing.record_ms(inference_start - start_time);
+            if (!cached) padding.add(tokens_of[t], sequence_length);
         }
         
         double overall_time = get_time_ms() - overall_start;
+        double bound_allocations = static_cast<double>(g_allocation_count.load() - allocations_start) / num_runs;
+        stop_cpu_monitoring(resources);
+        double cpu_seconds_per_1k = resources.cpu_seconds * 1000.0 / num_runs;
         
-        // Calculate statistics
-        double sum = 0, inf_sum = 0;
-        double min_time = times[0], max_time = times[0];
-        
+        // Same count for the unbound path (fresh input and output tensors per Run)
+        auto vector = classifier.preprocess(texts[0]);
+        allocations_start = g_allocation_count.load();
         for (int i = 0; i < num_runs; i++) {
-            sum += times[i];
-            inf_sum += inference_times[i];
-            if (times[i] < min_time) min_time = times[i];
-            if (times[i] > max_time) max_time = times[i];
+            classifier.infer(vector);
         }
+        double unbound_allocations = static_cast<double>(g_allocation_count.load() - allocations_start) / num_runs;
         
-        double avg_time = sum / num_runs;
-        double avg_inf = inf_sum / num_runs;
+        double avg_time = latency.mean_ms();
         
         // Display results
         std::cout << "\n📈 DETAILED PERFORMANCE RESULTS:\n";
         std::cout << "--------------------------------------------------\n";
-        std::cout << "⏱️  TIMING ANALYSIS:\n";
-        std::cout << "   Mean: " << std::fixed << std::setprecision(2) << avg_time << "ms\n";
-        std::cout << "   Min: " << min_time << "ms\n";
-        std::cout << "   Max: " << max_time << "ms\n";
-        std::cout << "   Model Inference: " << avg_inf << "ms\n";
+        if (texts.size() == 1) std::cout << "🏆 Prediction: class " << predicted_idx << " (" << std::fixed << std::setprecision(1) 
+                  << confidence * 100.0 << "%)\n";
+        std::cout << "⏱️  END-TO-END LATENCY (tokenize + vectorize + infer + postprocess):\n";
+        std::cout << "   Mean: " << std::fixed << std::setprecision(3) << avg_time << "ms\n";
+        std::cout << "   Stddev: " << latency.stddev_ms() << "ms\n";
+        std::cout << "   Min: " << latency.min_ms() << "ms\n";
+        std::cout << "   p50: " << latency.percentile_ms(50) << "ms\n";
+        std::cout << "   p90: " << latency.percentile_ms(90) << "ms\n";
+        std::cout << "   p99: " << latency.percentile_ms(99) << "ms\n";
+        std::cout << "   p99.9: " << latency.percentile_ms(99.9) << "ms\n";
+        std::cout << "   Max: " << latency.max_ms() << "ms\n";
+        std::cout << "\n🔬 PHASES (mean / p99):\n";
+        std::cout << "   Preprocessing: " << preprocessing.mean_ms() << "ms / " << preprocessing.percentile_ms(99) << "ms\n";
+        std::cout << "   Model Inference: " << inference.mean_ms() << "ms / " << inference.percentile_ms(99) << "ms\n";
+        std::cout << "   Postprocessing: " << postprocessing.mean_ms() << "ms / " << postprocessing.percentile_ms(99) << "ms\n";
+        std::cout << "\n📏 BY TEXT LENGTH (Keras tokens; texts over 30 are truncated to the first 30):\n";
+        std::cout << "   Tokens   Texts  Mean tok   OOV%  Preproc mean      p50      p99\n";
+        for (size_t b = 0; b < kNumLengthBuckets; b++) {
+            const LengthBucketStats& bucket = buckets[b];
+            if (bucket.texts == 0) continue;
+            std::cout << "   " << std::left << std::setw(6) << kLengthBuckets[b].name << std::right 
+                      << std::setw(8) << bucket.texts << std::setw(10) << std::setprecision(1) 
+                      << static_cast<double>(bucket.tokens) / bucket.texts << std::setw(7) 
+                      << (bucket.tokens ? 100.0 * bucket.oov_tokens / bucket.tokens : 0.0) << std::setprecision(3) 
+                      << std::setw(12) << bucket.preprocessing.mean_ms() << "ms" << std::setw(7) 
+                      << bucket.latency.percentile_ms(50) << "ms" << std::setw(7) 
+                      << bucket.latency.percentile_ms(99) << "ms\n";
+        }
+        std::cout << "\n🧩 PADDING:\n";
+        std::cout << "   Sequence: " << (classifier.supports_dynamic_sequence() ? "dynamic, padded to 8/16/30" : "fixed at 30") 
+                  << " (" << std::setprecision(1) << static_cast<double>(padding.positions) / num_runs << " positions/text)\n";
+        std::cout << "   Padding ratio: " << padding.ratio() * 100.0 << "% of " << padding.positions << " positions\n";
         std::cout << "\n🚀 THROUGHPUT:\n";
         std::cout << "   Texts per second: " << std::setprecision(1) << 1000.0 / avg_time << "\n";
         std::cout << "   Total benchmark time: " << std::setprecision(2) << overall_time / 1000.0 << "s\n";
         std::cout << "   Overall throughput: " << std::setprecision(1) << num_runs / (overall_time / 1000.0) << " texts/sec\n";
+        std::cout << "\n💾 RESOURCE USAGE:\n";
+        std::cout << "   CPU Time: " << std::setprecision(3) << resources.cpu_seconds << "s (" 
+                  << cpu_seconds_per_1k << " CPU-s per 1k texts)\n";
+        std::cout << "   CPU Usage: " << std::setprecision(1) << resources.cpu_avg_percent << "% avg, " 
+                  << resources.cpu_max_percent << "% peak of " << get_usable_cpu_count() << " cores (" 
+                  << resources.cpu_readings_count << " samples every " << g_cpu_monitor.interval_ms << "ms)\n";
+        std::cout << "   Peak RSS: " << std::setprecision(2) << resources.memory_peak_mb << " MB\n";
+        print_session_memory(session_memory);
+        print_provider_sweep(provider_sweep);
+        std::cout << "\n🧮 HEAP ALLOCATIONS PER INFERENCE:\n";
+        std::cout << "   End-to-end (IoBinding): " << std::setprecision(2) << bound_allocations << "\n";
+        std::cout << "   Session::Run (new tensors): " << unbound_allocations << "\n";
+        std::cout << "\n";
+        print_startup_timing(classifier.startup());
+        ResultCacheStats cache = classifier.result_cache_stats();
+        if (classifier.has_result_cache()) {
+            std::cout << "\n";
+            print_result_cache_stats(cache);
+        }
         
         // Performance classification
         std::string performance_class;
@@ -542,6 +460,33 @@ int run_performance_benchmark(const std::string& model_path, const std::string&
         std::cout << "\n🎯 PERFORMANCE CLASSIFICATION: " << performance_class << "\n";
         std::cout << "   (" << std::setprecision(1) << avg_time << "ms average - Target: <100ms)\n";
         
+        if (!report_path.empty()) {
+            json report = benchmark_report("multiclass_classifier", *corpus, num_runs, overall_time, latency,
+                                           preprocessing, inference, postprocessing, system_info);
+            report["length_buckets"] = length_bucket_report(buckets);
+            report["resources"] = {
+                {"cpu_seconds", resources.cpu_seconds},
+                {"cpu_seconds_per_1k_texts", cpu_seconds_per_1k},
+                {"cpu_avg_percent", resources.cpu_avg_percent},
+                {"cpu_max_percent", resources.cpu_max_percent},
+                {"cpu_sample_interval_ms", g_cpu_monitor.interval_ms},
+                {"cpu_cores", get_usable_cpu_count()},
+                {"peak_rss_mb", resources.memory_peak_mb}
+            };
+            report["allocations_per_inference"] = {{"iobinding", bound_allocations}, {"session_run", unbound_allocations}};
+            if (!session_memory.empty()) report["session_memory"] = session_memory_report(session_memory);
+            if (!provider_sweep.empty()) report["providers"] = provider_sweep_report(provider_sweep);
+            report["startup_ms"] = startup_report(classifier.startup());
+            if (classifier.has_result_cache()) report["result_cache"] = result_cache_report(cache);
+            report["padding"] = {
+                {"dynamic_sequence", classifier.supports_dynamic_sequence()},
+                {"tokens", padding.tokens},
+                {"positions", padding.positions},
+                {"ratio", padding.ratio()}
+            };
+            write_benchmark_report(report_path, report);
+        }
+        
         return 0;
         
     } catch (const std::exception& e) {
@@ -550,10 +495,522 @@ int run_performance_benchmark(const std::string& model_path, const std::string&
     }
 }
 
+int test_batch(const std::vector<std::string>& texts, TopicClassifier& classifier, int batch_size,
+               const LabelTable& labels, OutputFormat format = OutputFormat::Full, size_t k = 3) {
+    std::cout << "🔄 Testing " << texts.size() << " texts in batches of " << batch_size << "...\n";
+    if (!classifier.supports_dynamic_batch()) {
+        std::cout << "⚠️ Model has a fixed batch dimension - batches run row by row\n";
+    }
+    
+    try {
+        std::vector<std::string_view> views(texts.begin(), texts.end());
+        PaddingStats padding;
+        double start = get_time_ms();
+        auto probabilities = classifier.predict_bucketed(views, batch_size, &padding);
+        double elapsed = get_time_ms() - start;
+        
+        std::cout << "\n📊 TOPIC CLASSIFICATION RESULTS:\n";
+        for (size_t i = 0; i < texts.size(); i++) {
+            if (format == OutputFormat::Json) {
+                write_json_result(texts[i], probabilities[i].data(), probabilities[i].size(), labels, k);
+            } else {
+                print_prediction_line(texts[i], probabilities[i].data(), probabilities[i].size(), labels);
+            }
+        }
+        std::cout << "\n🚀 THROUGHPUT:\n";
+        std::cout << "   " << texts.size() << " texts in " << std::setprecision(2) << elapsed << "ms (" 
+                  << std::setprecision(1) << texts.size() * 1000.0 / elapsed << " texts/sec)\n";
+        std::cout << "   Padding ratio: " << padding.ratio() * 100.0 << "% (length-bucketed batches)\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// --stream: newline-delimited text or JSONL on stdin, one JSON result per
+// line on stdout. A reader thread tokenizes record k+1 while this thread
+// runs inference on record k.
+int run_stream(TopicClassifier& classifier, const LabelTable& labels, size_t queue_depth = 64) {
+    using Record = StreamRecord<std::vector<int32_t>, std::vector<float>>;
+    SpscRing<Record> ring(queue_depth);
+    for (auto& slot : ring.slots()) {
+        slot.features.resize(TopicClassifier::kMaxSequenceLength);
+    }
+    auto prepare = [&](Record& record) {
+        // Pad to the text's length bucket; the slot keeps its 30-token capacity
+        record.features.resize(TopicClassifier::kMaxSequenceLength);
+        record.features.resize(classifier.preprocess_into(record.input.text, record.features.data(),
+                                                          TopicClassifier::kPadToText));
+    };
+    auto emit = [&](const std::vector<float>& probabilities, OutputBuffer& out) {
+        uint32_t predicted = 0;
+        top_k(probabilities.data(), probabilities.size(), 1, &predicted);
+        out.append(",\"label\":");
+        out.append_json_string(labels.names[predicted]);
+        out.append(",\"confidence\":");
+        out.append_number(probabilities[predicted], 6);
+        out.append(",\"probabilities\":[");
+        for (size_t i = 0; i < probabilities.size(); i++) {
+            if (i > 0) out.append(',');
+            out.append_number(probabilities[i], 6);
+        }
+        out.append(']');
+    };
+    return whitelightning::run_stream(classifier, ring, prepare, emit);
+}
+
+// --serve: requests from every connection are coalesced into length-bucketed
+// predict_bucketed calls (through the result cache, if enabled) on one
+// batching thread
+int run_serve(TopicClassifier& classifier, const LabelTable& labels, const ServerConfig& config) {
+    std::vector<std::string> quoted_names;
+    for (const std::string& name : labels.names) {
+        quoted_names.push_back(json(name).dump());
+    }
+    try {
+        return run_server(config, [&](Span<const std::string_view> texts, std::vector<std::string>& results) {
+            auto probabilities = classifier.predict_bucketed(texts, texts.size());
+            char number[32];
+            for (size_t i = 0; i < texts.size(); i++) {
+                const std::vector<float>& row = probabilities[i];
+                uint32_t predicted = 0;
+                top_k(row.data(), row.size(), 1, &predicted);
+                std::string& result = results[i];
+                result = "\"label\":" + quoted_names[predicted];
+                std::snprintf(number, sizeof(number), "%.6f", row[predicted]);
+                result += ",\"confidence\":";
+                result += number;
+                result += ",\"probabilities\":[";
+                for (size_t c = 0; c < row.size(); c++) {
+                    std::snprintf(number, sizeof(number), c ? ",%.6f" : "%.6f", row[c]);
+                    result += number;
+                }
+                result += ']';
+            }
+        });
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Server error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// Texts per second at batch sizes 1, 2, 4, ... max_batch over a queue that
+// cycles through texts, with FIFO batches (padded to their longest text)
+// against length-bucketed batches
+int run_batch_benchmark(TopicClassifier& classifier, int num_runs, int max_batch, const std::vector<std::string>& texts) {
+    std::cout << "\n📦 BATCH THROUGHPUT (" << num_runs << " texts per batch size)\n";
+    std::cout << "============================================================\n";
+    if (!classifier.supports_dynamic_batch()) {
+        std::cout << "⚠️ Model has a fixed batch dimension - batches run row by row\n";
+    }
+    if (!classifier.supports_dynamic_sequence()) {
+        std::cout << "⚠️ Model has a fixed sequence length - every row is padded to 30\n";
+    }
+    
+    std::vector<std::string_view> queue;
+    for (int i = 0; i < num_runs; i++) {
+        queue.push_back(texts[i % texts.size()]);
+    }
+    const Span<const std::string_view> all(queue);
+    
+    std::vector<int> batch_sizes;
+    for (int size = 1; size < max_batch; size *= 2) {
+        batch_sizes.push_back(size);
+    }
+    batch_sizes.push_back(max_batch);
+    
+    try {
+        std::cout << "   Batch        FIFO texts/sec  padding    Bucketed texts/sec  padding\n";
+        for (int batch_size : batch_sizes) {
+            classifier.predict_batch_uncached(all.subspan(0, batch_size));
+            
+            PaddingStats fifo_padding;
+            double start = get_time_ms();
+            for (size_t offset = 0; offset < all.size(); offset += batch_size) {
+                classifier.predict_batch_uncached(all.subspan(offset, batch_size), &fifo_padding);
+            }
+            double fifo_elapsed = get_time_ms() - start;
+            
+            PaddingStats bucketed_padding;
+            start = get_time_ms();
+            classifier.predict_bucketed_uncached(all, batch_size, &bucketed_padding);
+            double bucketed_elapsed = get_time_ms() - start;
+            
+            std::cout << "   " << std::setw(5) << batch_size << std::fixed << std::setprecision(1) 
+                      << std::setw(20) << all.size() * 1000.0 / fifo_elapsed << std::setw(8) 
+                      << fifo_padding.ratio() * 100.0 << "%" << std::setw(22) 
+                      << all.size() * 1000.0 / bucketed_elapsed << std::setw(8) 
+                      << bucketed_padding.ratio() * 100.0 << "%\n";
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Benchmark error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+int test_parallel(const std::vector<std::string>& texts, TopicClassifier& classifier, int num_workers,
+                  const LabelTable& labels, OutputFormat format = OutputFormat::Full, size_t k = 3) {
+    std::cout << "🔄 Testing " << texts.size() << " texts on " << num_workers << " workers...\n";
+    
+    try {
+        WorkerPool pool(num_workers, active_cpu_placement().cpus);
+        std::vector<std::unique_ptr<TopicClassifier::Binding>> bindings;
+        for (size_t i = 0; i < pool.size(); i++) {
+            bindings.push_back(std::make_unique<TopicClassifier::Binding>(classifier));
+        }
+        std::vector<std::vector<float>> probabilities(texts.size());
+        
+        double start = get_time_ms();
+        pool.run(texts.size(), [&](size_t task, size_t worker) {
+            auto& binding = *bindings[worker];
+            classifier.preprocess_into(texts[task], binding);
+            binding.run();
+            probabilities[task].assign(binding.probabilities(0), binding.probabilities(0) + binding.num_classes());
+        });
+        double elapsed = get_time_ms() - start;
+        
+        std::cout << "\n📊 TOPIC CLASSIFICATION RESULTS:\n";
+        for (size_t i = 0; i < texts.size(); i++) {
+            if (format == OutputFormat::Json) {
+                write_json_result(texts[i], probabilities[i].data(), probabilities[i].size(), labels, k);
+            } else {
+                print_prediction_line(texts[i], probabilities[i].data(), probabilities[i].size(), labels);
+            }
+        }
+        std::cout << "\n🚀 THROUGHPUT:\n";
+        std::cout << "   " << texts.size() << " texts in " << std::setprecision(2) << elapsed << "ms (" 
+                  << std::setprecision(1) << texts.size() * 1000.0 / elapsed << " texts/sec)\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+int run_allocation_benchmark(TopicClassifier& classifier, const std::vector<std::string>& texts, int num_runs) {
+    std::cout << "\n🧪 TOKENIZER ALLOCATION BENCHMARK (" << num_runs << " texts)\n";
+    std::cout << "============================================================\n";
+    std::cout << "   Tokenizer kernel: " << tokenizer_kernel() << "\n";
+    
+    std::vector<int32_t> tokens(TopicClassifier::kMaxSequenceLength);
+    
+    // Warm the per-thread scratch buffers
+    for (const auto& text : texts) {
+        classifier.preprocess_into(text, tokens.data());
+    }
+    
+    auto measure = [&](const char* label, auto&& preprocess) {
+        uint64_t allocations_start = g_allocation_count.load();
+        double start = get_time_ms();
+        for (int i = 0; i < num_runs; i++) {
+            preprocess(texts[i % texts.size()]);
+        }
+        double elapsed = get_time_ms() - start;
+        uint64_t allocations = g_allocation_count.load() - allocations_start;
+        std::cout << "   " << label << ": " << std::fixed << std::setprecision(2) 
+                  << static_cast<double>(allocations) / num_runs << " allocs/text, " 
+                  << std::setprecision(3) << elapsed * 1000.0 / num_runs << "us/text\n";
+    };
+    
+    measure("Before (std::string per word)", [&](const std::string& text) {
+        classifier.preprocess_legacy(text, tokens.data());
+    });
+    measure("After  (string_view tokens)  ", [&](const std::string& text) {
+        classifier.preprocess_into(text, tokens.data());
+    });
+    
+    return 0;
+}
+
+// --pipeline-bench: the generic Classifier::predict path (virtual score(),
+// per-call tensors, scores vectors, runtime argmax) against the
+// compile-time TopicPipeline on the same texts and model
+int run_pipeline_benchmark(TopicClassifier& classifier, const ModelBundle& bundle, SessionConfig config,
+                           const std::vector<std::string>& texts, int num_runs) {
+    std::cout << "\n🧬 SPECIALIZED PIPELINE BENCHMARK (" << num_runs << " texts)\n";
+    std::cout << "============================================================\n";
+    
+    // Every request has to reach the model
+    config.result_cache_entries = 0;
+    config.result_cache_bytes = 0;
+    std::unique_ptr<Classifier> generic;
+    try {
+        generic = Classifier::load(bundle, config);
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error loading model: " << e.what() << std::endl;
+        return 1;
+    }
+    TopicPipeline pipeline(classifier);
+    if (classifier.supports_dynamic_sequence()) {
+        std::cout << "   (dynamic sequence model: the pipeline pads every text to "
+                  << TopicClassifier::kMaxSequenceLength << ", the generic path to its length bucket)\n";
+    }
+    
+    // Both paths must agree before their timings mean anything
+    size_t mismatches = 0;
+    for (const auto& text : texts) {
+        mismatches += generic->predict(text).label != pipeline.predict(text).label;
+    }
+    
+    auto measure = [&](const char* label, auto&& predict) {
+        LatencyHistogram latency;
+        uint64_t allocations_start = g_allocation_count.load();
+        for (int i = 0; i < num_runs; i++) {
+            double start = get_time_ms();
+            predict(texts[i % texts.size()]);
+            latency.record_ms(get_time_ms() - start);
+        }
+        uint64_t allocations = g_allocation_count.load() - allocations_start;
+        std::cout << "   " << label << ": " << std::fixed << std::setprecision(3) << latency.mean_ms() * 1000.0
+                  << "us mean, p50 " << latency.percentile_ms(50) * 1000.0 << "us, p99 "
+                  << latency.percentile_ms(99) * 1000.0 << "us, " << std::setprecision(2)
+                  << static_cast<double>(allocations) / num_runs << " allocs/text\n";
+        return latency.mean_ms();
+    };
+    
+    double generic_ms = measure("Generic (Classifier::predict)", [&](const std::string& text) {
+        return generic->predict(text).label;
+    });
+    double specialized_ms = measure("Specialized (TopicPipeline) ", [&](const std::string& text) {
+        return pipeline.predict(text).label;
+    });
+    std::cout << "   Speedup: " << std::setprecision(2) << generic_ms / specialized_ms << "x\n";
+    std::cout << "   Label agreement: " << texts.size() - mismatches << "/" << texts.size() << " texts\n";
+    return mismatches == 0 ? 0 : 1;
+}
+
+// Command line: [text] [--benchmark [N]] [--batch N] [--stream] [--workers N] [--intra-op-threads N]
+//               [--inter-op-threads N] [--model-cache] [--report out.json] [--corpus file [--seed N]]
+//               [--cpu-interval MS] [--alloc-bench [N]] [--pipeline-bench [N]] [--quiet | --json [--top-k K]]
+//               [--cache-entries N] [--cache-bytes N] [--model-variant fp32|int8] [--compare-variants [N]]
+//               [--compile-vocab [out]]
+//               [--mmap-model] [--sessions N] [--provider cpu|xnnpack|cuda|coreml|openvino] [--sweep-providers]
+//               [--trace out.json] [--pin CPUS|node:N|cores]
+//               [--load-sweep [N] [--sweep-workers L] [--sweep-batch L] [--sweep-concurrency L | --sweep-qps L]]
+//               [--async-bench [N] [--async-depths L]]
+//               [--serve [--listen-unix PATH] [--listen-tcp [HOST:]PORT] [--slo-ms MS] [--stats-interval S]]
+struct CliOptions {
+    std::string mode = "test";
+    std::string text;
+    std::string output_path;
+    std::string report_path;
+    std::string corpus_path;
+    std::string trace_path;
+    bool shuffle = false;
+    uint64_t seed = 0;
+    int num_runs = 0;
+    int batch_size = 1;
+    int workers = 1;
+    OutputFormat format = OutputFormat::Full;
+    int top_k = 3;
+    ModelVariant variant = ModelVariant::Fp32;
+    int sessions = 0;
+    bool sweep_providers = false;
+    SessionConfig session;
+    ServerConfig server;
+    CpuPlacement placement;
+    LoadSweepConfig load;
+    AsyncBenchConfig async;
+};
+
+bool parse_cli_options(int argc, char* argv[], CliOptions& options) {
+    auto is_number = [](const char* s) {
+        return *s != '\0' && std::all_of(s, s + std::strlen(s), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); });
+    };
+    auto read_count = [&](int& i, const std::string& name, int& value) {
+        if (i + 1 >= argc || !is_number(argv[i + 1]) || std::atoi(argv[i + 1]) < 1) {
+            std::cerr << "❌ " << name << " requires a positive integer\n";
+            return false;
+        }
+        value = std::atoi(argv[++i]);
+        return true;
+    };
+    auto read_size = [&](int& i, const std::string& name, size_t& value) {
+        if (i + 1 >= argc || !is_number(argv[i + 1])) {
+            std::cerr << "❌ " << name << " requires a non-negative integer\n";
+            return false;
+        }
+        value = std::stoull(argv[++i]);
+        return true;
+    };
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--benchmark" || arg == "--alloc-bench" || arg == "--pipeline-bench" || arg == "--compare-variants" ||
+            arg == "--load-sweep" || arg == "--async-bench") {
+            options.mode = arg.substr(2);
+            options.num_runs = arg == "--alloc-bench" || arg == "--pipeline-bench" ? 10000
+                             : arg == "--load-sweep" || arg == "--async-bench" ? 2000 : 100;
+            if (i + 1 < argc && is_number(argv[i + 1])) {
+                options.num_runs = std::max(1, std::atoi(argv[++i]));
+            }
+        } else if (arg == "--compile-vocab") {
+            options.mode = "compile-vocab";
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                options.output_path = argv[++i];
+            }
+        } else if (arg == "--report") {
+            if (i + 1 >= argc) {
+                std::cerr << "❌ --report requires an output path\n";
+                return false;
+            }
+            options.report_path = argv[++i];
+        } else if (arg == "--corpus") {
+            if (i + 1 >= argc) {
+                std::cerr << "❌ --corpus requires a file path\n";
+                return false;
+            }
+            options.corpus_path = argv[++i];
+        } else if (arg == "--trace") {
+            if (i + 1 >= argc) {
+                std::cerr << "❌ --trace requires an output path\n";
+                return false;
+            }
+            options.trace_path = argv[++i];
+        } else if (arg == "--sweep-workers" || arg == "--sweep-batch" || arg == "--sweep-concurrency" || arg == "--sweep-qps" ||
+                   arg == "--async-depths") {
+            std::vector<int>& values = arg == "--sweep-workers" ? options.load.workers
+                                     : arg == "--sweep-batch" ? options.load.batch_sizes
+                                     : arg == "--sweep-concurrency" ? options.load.concurrency
+                                     : arg == "--sweep-qps" ? options.load.qps : options.async.depths;
+            if (i + 1 >= argc || !parse_count_list(argv[i + 1], values)) {
+                std::cerr << "❌ " << arg << " requires comma-separated positive integers, e.g. 1,4,16\n";
+                return false;
+            }
+            i++;
+        } else if (arg == "--pin") {
+            if (i + 1 >= argc) {
+                std::cerr << "❌ --pin requires a CPU list (0-3,8), node:N or cores\n";
+                return false;
+            }
+            try {
+                options.placement = resolve_cpu_placement(argv[++i]);
+            } catch (const std::exception& e) {
+                std::cerr << "❌ --pin: " << e.what() << "\n";
+                return false;
+            }
+            options.session.pinned_cpus = options.placement.cpus;
+        } else if (arg == "--seed") {
+            if (i + 1 >= argc || !is_number(argv[i + 1])) {
+                std::cerr << "❌ --seed requires a non-negative integer\n";
+                return false;
+            }
+            options.seed = std::stoull(argv[++i]);
+            options.shuffle = true;
+        } else if (arg == "--model-variant") {
+            if (i + 1 >= argc || !parse_model_variant(argv[i + 1], options.variant)) {
+                std::cerr << "❌ --model-variant requires fp32 or int8\n";
+                return false;
+            }
+            i++;
+        } else if (arg == "--cpu-interval") {
+            if (!read_count(i, arg, g_cpu_monitor.interval_ms)) return false;
+        } else if (arg == "--stream") {
+            options.mode = "stream";
+        } else if (arg == "--serve") {
+            options.mode = "serve";
+        } else if (arg == "--listen-unix") {
+            if (i + 1 >= argc) {
+                std::cerr << "❌ --listen-unix requires a socket path\n";
+                return false;
+            }
+            options.server.unix_path = argv[++i];
+        } else if (arg == "--listen-tcp") {
+            std::string address = i + 1 < argc ? argv[i + 1] : "";
+            size_t colon = address.rfind(':');
+            std::string port = colon == std::string::npos ? address : address.substr(colon + 1);
+            if (port.empty() || !is_number(port.c_str()) || std::atoi(port.c_str()) < 1 || std::atoi(port.c_str()) > 65535) {
+                std::cerr << "❌ --listen-tcp requires [HOST:]PORT\n";
+                return false;
+            }
+            if (colon != std::string::npos) options.server.tcp_host = address.substr(0, colon);
+            options.server.tcp_port = std::atoi(port.c_str());
+            i++;
+        } else if (arg == "--slo-ms") {
+            char* end = nullptr;
+            double slo = i + 1 < argc ? std::strtod(argv[i + 1], &end) : 0.0;
+            if (end == nullptr || *end != '\0' || !(slo > 0.0)) {
+                std::cerr << "❌ --slo-ms requires a positive number of milliseconds\n";
+                return false;
+            }
+            options.server.slo_ms = slo;
+            i++;
+        } else if (arg == "--stats-interval") {
+            if (i + 1 >= argc || !is_number(argv[i + 1])) {
+                std::cerr << "❌ --stats-interval requires a number of seconds (0 disables)\n";
+                return false;
+            }
+            options.server.stats_interval_s = std::atoi(argv[++i]);
+        } else if (arg == "--quiet") {
+            options.format = OutputFormat::Quiet;
+        } else if (arg == "--json") {
+            options.format = OutputFormat::Json;
+        } else if (arg == "--top-k") {
+            if (!read_count(i, arg, options.top_k)) return false;
+        } else if (arg == "--batch") {
+            if (!read_count(i, arg, options.batch_size)) return false;
+        } else if (arg == "--model-cache") {
+            options.session.model_cache = true;
+        } else if (arg == "--mmap-model") {
+            options.session.mmap_model = true;
+        } else if (arg == "--provider") {
+            if (i + 1 >= argc || !parse_execution_provider(argv[i + 1], options.session.provider)) {
+                std::cerr << "❌ --provider requires cpu, xnnpack, cuda, coreml or openvino\n";
+                return false;
+            }
+            i++;
+        } else if (arg == "--sweep-providers") {
+            options.sweep_providers = true;
+        } else if (arg == "--sessions") {
+            if (!read_count(i, arg, options.sessions)) return false;
+        } else if (arg == "--cache-entries") {
+            if (!read_size(i, arg, options.session.result_cache_entries)) return false;
+        } else if (arg == "--cache-bytes") {
+            if (!read_size(i, arg, options.session.result_cache_bytes)) return false;
+        } else if (arg == "--workers") {
+            if (!read_count(i, arg, options.workers)) return false;
+        } else if (arg == "--intra-op-threads") {
+            if (!read_count(i, arg, options.session.intra_op_threads)) return false;
+        } else if (arg == "--inter-op-threads") {
+            if (!read_count(i, arg, options.session.inter_op_threads)) return false;
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return false;
+        } else {
+            options.text = arg;
+        }
+    }
+    // AsyncRunner needs an intra-op pool of at least 2 threads
+    options.session.async = options.mode == "async-bench";
+    return true;
+}
+
 int main(int argc, char* argv[]) {
+    CliOptions options;
+    if (!parse_cli_options(argc, argv, options)) {
+        return 1;
+    }
+    
+    // Keep stdout pure JSONL in stream and --json modes; human-readable logs go to stderr
+    if (options.mode == "stream" || options.format == OutputFormat::Json) {
+        std::cout.rdbuf(std::cerr.rdbuf());
+    }
+    
     std::cout << "🤖 ONNX MULTICLASS CLASSIFIER - C++ IMPLEMENTATION\n";
     std::cout << "==================================================\n";
     
+    const std::string model_path = "model.onnx";
+    const std::string vocab_path = "vocab.json";
+    const std::string scaler_path = "scaler.json";
+    
+    // vocab.json is all --compile-vocab reads
+    if (options.mode == "compile-vocab") {
+        return compile_vocab(vocab_path,
+                             options.output_path.empty() ? VocabIndex::compiled_path(vocab_path) : options.output_path);
+    }
+    
     // Check if we're in a CI environment - but only exit if model files are missing
     const char* ci_env = std::getenv("CI");
     const char* github_actions = std::getenv("GITHUB_ACTIONS");
@@ -570,10 +1027,6 @@ int main(int argc, char* argv[]) {
             return 0;
         }
     }
-
-    const std::string model_path = "model.onnx";
-    const std::string vocab_path = "vocab.json";
-    const std::string scaler_path = "scaler.json";
     
     // Check if model files exist
     std::ifstream model_file(model_path);
@@ -588,29 +1041,136 @@ int main(int argc, char* argv[]) {
         return 0;
     }
     
-    if (argc > 1) {
-        std::string arg1 = argv[1];
-        if (arg1 == "--benchmark") {
-            int num_runs = argc > 2 ? std::atoi(argv[2]) : 100;
-            return run_performance_benchmark(model_path, vocab_path, scaler_path, num_runs);
-        } else {
-            // Use command line argument as text
-            return test_single_text(arg1, model_path, vocab_path, scaler_path);
+    // --pin: before anything is loaded, so the session, vocab and buffers
+    // are first touched, and allocated, on the placement's node
+    apply_cpu_placement(options.placement);
+    
+    // --trace: spans from here on, written with the ORT profile on return
+    std::unique_ptr<TopicClassifier> classifier;
+    TraceRecorder trace(options.trace_path);
+    
+    // --corpus texts for --benchmark and --compare-variants
+    std::unique_ptr<Corpus> corpus;
+    if (!options.corpus_path.empty()) {
+        try {
+            corpus = std::make_unique<Corpus>(load_corpus(options.corpus_path, options.shuffle, options.seed));
+        } catch (const std::exception& e) {
+            std::cerr << "❌ Error: " << e.what() << std::endl;
+            return 1;
         }
-    } else {
-        // Default test with multiple texts
-        std::vector<std::string> default_texts = {
+    }
+    
+    // Default test texts
+    const std::vector<std::string> default_texts = {
             "France Defeats Argentina in Thrilling World Cup Final",
             "New Healthcare Policy Announced by Government",
             "Stock Market Reaches Record High",
             "Climate Change Summit Begins in Paris",
             "Scientists Discover New Species in Amazon"
+    };
+    
+    if (options.mode == "compare-variants") {
+        ClassifierLoader<TopicClassifier> load = [&](const std::string& path, const SessionConfig& config) {
+            return std::make_unique<TopicClassifier>(path, vocab_path, config);
         };
-        
+        return run_variant_comparison(model_path, load, options.session, options.num_runs,
+                                      corpus ? *corpus : Corpus{"built-in", default_texts}, load_labels(scaler_path),
+                                      "multiclass_classifier", options.report_path);
+    }
+    
+    const std::string variant_path = model_variant_path(model_path, options.variant);
+    if (!std::ifstream(variant_path).good()) {
+        std::cerr << "❌ " << variant_path << " not found (--model-variant " << model_variant_name(options.variant) << ")\n";
+        return 1;
+    }
+    
+    // Load tokenizer, session and labels once for every text processed below
+    LabelTable labels;
+    try {
+        SessionConfig config = options.session;
+        if (trace.enabled()) config.profile_prefix = ort_profile_prefix(options.trace_path);
+        double load_start = get_time_ms();
+        classifier = std::make_unique<TopicClassifier>(variant_path, vocab_path, config);
+        if (trace.enabled()) trace.add_ort_profile([&] { return classifier->end_profiling("multiclass_classifier"); });
+        std::cout << "🔧 Model loaded in " << std::fixed << std::setprecision(2) << get_time_ms() - load_start << "ms\n";
+        std::cout << "📦 Vocab: " << classifier->vocab_source() << "\n";
+        std::cout << "⚙️ Session: " << classifier->session_source() << " in " << classifier->startup().session_load_ms << "ms\n";
+        if (options.session.provider != ExecutionProvider::Cpu) {
+            std::cout << "🖥️ Provider: " << execution_provider_name(classifier->provider()) << "\n";
+        }
+        labels = load_label_table(scaler_path, classifier->num_classes());
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error loading model: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    if (options.mode == "benchmark") {
+        std::vector<SessionMemoryResult> session_memory;
+        if (options.sessions > 0) {
+            ClassifierLoader<TopicClassifier> load = [&](const std::string& path, const SessionConfig& config) {
+                return std::make_unique<TopicClassifier>(path, vocab_path, config);
+            };
+            session_memory = measure_session_sharing(variant_path, load, options.session, options.sessions);
+        }
+        std::vector<ProviderSweepResult> provider_sweep;
+        if (options.sweep_providers) {
+            try {
+                ModelBundle bundle{ModelType::Multiclass, variant_path, vocab_path, scaler_path};
+                provider_sweep = sweep_providers(bundle, options.session, options.num_runs,
+                                                 options.batch_size > 1 ? options.batch_size : 32,
+                                                 corpus ? corpus->texts : default_texts);
+            } catch (const std::exception& e) {
+                std::cerr << "❌ Provider sweep error: " << e.what() << std::endl;
+                return 1;
+            }
+        }
+        int result = run_performance_benchmark(*classifier, options.num_runs, options.report_path, corpus.get(),
+                                               session_memory, provider_sweep);
+        if (result == 0 && options.batch_size > 1) {
+            result = run_batch_benchmark(*classifier, options.num_runs, options.batch_size,
+                                         corpus ? corpus->texts : default_texts);
+        }
+        if (result == 0 && options.workers > 1) {
+            result = run_scaling_benchmark(*classifier, options.num_runs, options.workers, options.session,
+                                           corpus ? corpus->texts : default_texts);
+        }
+        if (result == 0 && options.session.model_cache) {
+            result = run_cold_start_benchmark(variant_path);
+        }
+        return result;
+    } else if (options.mode == "stream") {
+        return run_stream(*classifier, labels);
+    } else if (options.mode == "serve") {
+        options.server.max_batch = options.batch_size > 1 ? options.batch_size : 32;
+        return run_serve(*classifier, labels, options.server);
+    } else if (options.mode == "load-sweep") {
+        options.load.requests = options.num_runs;
+        return run_load_sweep_benchmark(*classifier, options.load, corpus ? *corpus : Corpus{"built-in", default_texts},
+                                        options.report_path, "multiclass_classifier");
+    } else if (options.mode == "async-bench") {
+        options.async.requests = options.num_runs;
+        return run_async_depth_benchmark(*classifier, options.async, corpus ? *corpus : Corpus{"built-in", default_texts},
+                                         options.report_path, "multiclass_classifier");
+    } else if (options.mode == "alloc-bench") {
+        return run_allocation_benchmark(*classifier, default_texts, options.num_runs);
+    } else if (options.mode == "pipeline-bench") {
+        ModelBundle bundle{ModelType::Multiclass, variant_path, vocab_path, scaler_path};
+        return run_pipeline_benchmark(*classifier, bundle, options.session, corpus ? corpus->texts : default_texts,
+                                      options.num_runs);
+    } else if (!options.text.empty()) {
+        // Use command line argument as text
+        return test_single_text(options.text, *classifier, labels, options.format, options.top_k);
+    } else if (options.workers > 1) {
+        return test_parallel(default_texts, *classifier, options.workers, labels, options.format, options.top_k);
+    } else if (options.batch_size > 1) {
+        return test_batch(default_texts, *classifier, options.batch_size, labels, options.format, options.top_k);
+    } else {
         std::cout << "🔄 Testing multiple texts...\n";
         for (size_t i = 0; i < default_texts.size(); i++) {
-            std::cout << "\n--- Test " << (i + 1) << "/" << default_texts.size() << " ---\n";
-            int result = test_single_text(default_texts[i], model_path, vocab_path, scaler_path);
+            if (options.format == OutputFormat::Full) {
+                std::cout << "\n--- Test " << (i + 1) << "/" << default_texts.size() << " ---\n";
+            }
+            int result = test_single_text(default_texts[i], *classifier, labels, options.format, options.top_k);
             if (result != 0) {
                 std::cout << "❌ Test " << (i + 1) << " failed\n";
                 return result;
@@ -1,180 +1,517 @@
-#include <iostream>
+#include <onnxruntime_cxx_api.h>
 #include <fstream>
-#include <vector>
-#include <string>
-#include <map>
-#include <regex>
-#include <chrono>
-#include <cmath>
-#include <algorithm>
-#include <sstream>
+#include <nlohmann/json.hpp>
+#include <iostream>
 #include <iomanip>
-#include <thread>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdio>
+#include <exception>
 #include <cstdlib>
+#include <cstdint>
 #include <cstring>
+#include <atomic>
+#include <new>
 
-using namespace std;
-
-struct SystemInfo {
-    string platform;
-    int cpuCores;
-    string cppVersion;
-    
-    SystemInfo() {
-        #ifdef _WIN32
-        platform = "Windows";
-        #elif __APPLE__
-        platform = "macOS";
-        #elif __linux__
-        platform = "Linux";
-        #else
-        platform = "Unknown";
-        #endif
-        
-        cpuCores = thread::hardware_concurrency();
-        cppVersion = to_string(__cplusplus);
-    }
-};
+#include "whitelightning/core.hpp"
 
+using namespace whitelightning;
 
+// Heap allocation counter (global operator new), used by --benchmark
+static std::atomic<uint64_t> g_allocation_count{0};
 
-void printSystemInfo(const SystemInfo& info) {
-    cout << "💻 SYSTEM INFORMATION:" << endl;
-    cout << "   Platform: " << info.platform << endl;
-    cout << "   CPU Cores: " << info.cpuCores << endl;
-    cout << "   Runtime: C++ " << info.cppVersion << endl << endl;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void* operator new(size_t size) {
+    g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
 }
 
-void simulateEmotionAnalysis(const string& text) {
-    cout << "📊 EMOTION ANALYSIS RESULTS:" << endl;
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+
+int test_single_text(const std::string& text, EmotionClassifier& classifier, float threshold) {
+    std::cout << "🔄 Processing: " << text << "\n";
     
-    // Simple emotion detection based on keywords (simplified demo)
-    // Classes: fear, happy, love, sadness
-    float probabilities[4] = {0.1f, 0.1f, 0.1f, 0.1f};
-    string emotions[4] = {"fear", "happy", "love", "sadness"};
+    SystemInfo system_info;
+    get_system_info(system_info);
+    print_system_info(system_info);
     
-    string lowerText = text;
-    transform(lowerText.begin(), lowerText.end(), lowerText.begin(), ::tolower);
+    TimingMetrics timing;
+    ResourceMetrics resources;
     
-    if (lowerText.find("fear") != string::npos || 
-        lowerText.find("terrified") != string::npos || 
-        lowerText.find("scared") != string::npos) {
-        probabilities[0] = 0.9f;
-    }
+    double total_start = get_time_ms();
+    resources.memory_start_mb = get_memory_usage_mb();
+    start_cpu_monitoring();
     
-    if (lowerText.find("happy") != string::npos || 
-        lowerText.find("joy") != string::npos || 
-        lowerText.find("happiness") != string::npos) {
-        probabilities[1] = 0.8f;
-    }
+    try {
+        // Preprocessing straight into the bound input tensor
+        auto& binding = classifier.binding();
+        double preprocess_start = get_time_ms();
+        classifier.preprocess_into(text, binding.input());
+        timing.preprocessing_time_ms = get_time_ms() - preprocess_start;
+        
+        double inference_start = get_time_ms();
+        binding.run();
+        timing.inference_time_ms = get_time_ms() - inference_start;
+        
+        // Post-processing: independent per-class threshold
+        double postprocess_start = get_time_ms();
+        const float* probabilities = binding.probabilities();
+        auto detected = detected_emotions(probabilities, classifier.num_classes(), threshold);
+        timing.postprocessing_time_ms = get_time_ms() - postprocess_start;
+        
+        timing.total_time_ms = get_time_ms() - total_start;
+        timing.throughput_per_sec = 1000.0 / timing.total_time_ms;
+        resources.memory_end_mb = get_memory_usage_mb();
+        resources.memory_delta_mb = resources.memory_end_mb - resources.memory_start_mb;
+        stop_cpu_monitoring(resources);
+        
+        std::cout << "📊 EMOTION ANALYSIS RESULTS:\n";
+        for (size_t i = 0; i < classifier.num_classes(); i++) {
+            std::cout << "   " << (probabilities[i] >= threshold ? "✅ " : "   ") << classifier.label(i) << ": "
+                      << std::fixed << std::setprecision(3) << probabilities[i] << "\n";
+        }
+        std::cout << "   🏆 Detected Emotions (threshold " << std::setprecision(2) << threshold << "): ";
+        if (detected.empty()) {
+            std::cout << "none";
+        }
+        for (size_t i = 0; i < detected.size(); i++) {
+            std::cout << (i ? ", " : "") << classifier.label(detected[i]) << " (" << std::setprecision(1)
+                      << probabilities[detected[i]] * 100.0 << "%)";
+        }
+        std::cout << "\n   📝 Input Text: \"" << text << "\"\n\n";
+        
+        timing.startup = classifier.startup();
+        print_performance_summary(timing, resources);
+        return 0;
     
-    if (lowerText.find("love") != string::npos || 
-        lowerText.find("romantic") != string::npos) {
-        probabilities[2] = 0.7f;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error: " << e.what() << std::endl;
+        stop_cpu_monitoring(resources);
+        return 1;
     }
+}
+
+int run_performance_benchmark(EmotionClassifier& classifier, int num_runs, float threshold,
+                              const std::string& report_path = "", const Corpus* corpus = nullptr,
+                              const std::vector<SessionMemoryResult>& session_memory = {},
+                              const std::vector<ProviderSweepResult>& provider_sweep = {}) {
+    std::cout << "\n🚀 PERFORMANCE BENCHMARKING (" << num_runs << " runs)\n";
+    std::cout << "============================================================\n";
     
-    if (lowerText.find("sad") != string::npos || 
-        lowerText.find("sadness") != string::npos || 
-        lowerText.find("sorrow") != string::npos) {
-        probabilities[3] = 0.6f;
+    SystemInfo system_info;
+    get_system_info(system_info);
+    std::cout << "💻 System: " << system_info.cpu_count_physical << " cores, "
+              << std::fixed << std::setprecision(1) << system_info.total_memory_gb << "GB RAM\n";
+    
+    Corpus builtin;
+    if (corpus == nullptr) {
+        builtin.source = "built-in";
+        builtin.texts = {"I'm so happy and grateful for my friends, but I'm scared about tomorrow."};
+        corpus = &builtin;
+        std::cout << "📝 Test Text: '" << builtin.texts[0] << "'\n\n";
+    } else {
+        std::cout << "📚 Corpus: " << corpus->source << " (" << corpus->texts.size() << " texts"
+                  << (corpus->shuffled ? ", shuffled with seed " + std::to_string(corpus->seed) : "") << ")\n\n";
     }
+    const std::vector<std::string>& texts = corpus->texts;
     
-    // Add some randomness for demonstration
-    for (int i = 0; i < 4; i++) {
-        if (probabilities[i] <= 0.1f) {
-            probabilities[i] = 0.1f + (rand() % 100) / 1000.0f;
+    try {
+        auto& binding = classifier.binding();
+        
+        // Length bucket and OOV count of every text, computed up front
+        std::vector<LengthBucketStats> buckets(kNumLengthBuckets);
+        std::vector<size_t> bucket_of(texts.size());
+        for (size_t t = 0; t < texts.size(); t++) {
+            TokenStats stats = classifier.token_stats(texts[t]);
+            bucket_of[t] = length_bucket(stats.tokens);
+            buckets[bucket_of[t]].texts++;
+            buckets[bucket_of[t]].tokens += stats.tokens;
+            buckets[bucket_of[t]].oov_tokens += stats.oov;
         }
-    }
+        
+        std::cout << "🔥 Warming up model (5 runs)...\n";
+        for (int i = 0; i < 5; i++) {
+            classifier.preprocess_into(texts[i % texts.size()], binding.input());
+            binding.run();
+        }
+        
+        // Every request is timed end to end: tokenize + vectorize, infer, threshold
+        LatencyHistogram latency;
+        LatencyHistogram preprocessing;
+        LatencyHistogram inference;
+        LatencyHistogram postprocessing;
+        size_t num_classes = classifier.num_classes();
+        uint64_t detected_total = 0;
+        
+        std::cout << "📊 Running " << num_runs << " performance tests...\n";
+        ResourceMetrics resources;
+        start_cpu_monitoring();
+        uint64_t allocations_start = g_allocation_count.load();
+        double overall_start = get_time_ms();
+        
+        for (int i = 0; i < num_runs; i++) {
+            if (i % 20 == 0 && i > 0) {
+                std::cout << "   Progress: " << i << "/" << num_runs << " ("
+                          << std::fixed << std::setprecision(1) << (double)i / num_runs * 100.0 << "%)\n";
+            }
+            
+            size_t t = static_cast<size_t>(i) % texts.size();
+            double start_time = get_time_ms();
+            classifier.preprocess_into(texts[t], binding.input());
+            double inference_start = get_time_ms();
+            binding.run();
+            double postprocess_start = get_time_ms();
+            const float* probabilities = binding.probabilities();
+            for (size_t c = 0; c < num_classes; c++) {
+                detected_total += probabilities[c] >= threshold;
+            }
+            double end_time = get_time_ms();
+            
+            record_trace_span("postprocess", postprocess_start, end_time);
+            record_trace_span("request", start_time, end_time);
+            latency.record_ms(end_time - start_time);
+            preprocessing.record_ms(inference_start - start_time);
+            inference.record_ms(postprocess_start - inference_start);
+            postprocessing.record_ms(end_time - postprocess_start);
+            buckets[bucket_of[t]].latency.record_ms(end_time - start_time);
+            buckets[bucket_of[t]].preprocessing.record_ms(inference_start - start_time);
+        }
+        
+        double overall_time = get_time_ms() - overall_start;
+        double bound_allocations = static_cast<double>(g_allocation_count.load() - allocations_start) / num_runs;
+        stop_cpu_monitoring(resources);
+        double cpu_seconds_per_1k = resources.cpu_seconds * 1000.0 / num_runs;
+        
+        double avg_time = latency.mean_ms();
+        
+        std::cout << "\n📈 DETAILED PERFORMANCE RESULTS:\n";
+        std::cout << "--------------------------------------------------\n";
+        if (texts.size() == 1) {
+            const float* probabilities = binding.probabilities();
+            std::cout << "🏆 Prediction:";
+            for (size_t c = 0; c < num_classes; c++) {
+                std::cout << " " << classifier.label(c) << "=" << std::fixed << std::setprecision(3) << probabilities[c];
+            }
+            std::cout << "\n";
+        }
+        std::cout << "🎭 Emotions per text: " << std::fixed << std::setprecision(2)
+                  << static_cast<double>(detected_total) / num_runs << " (threshold " << threshold << ")\n";
+        std::cout << "⏱️  END-TO-END LATENCY (tokenize + vectorize + infer + threshold):\n";
+        std::cout << "   Mean: " << std::fixed << std::setprecision(3) << avg_time << "ms\n";
+        std::cout << "   Stddev: " << latency.stddev_ms() << "ms\n";
+        std::cout << "   Min: " << latency.min_ms() << "ms\n";
+        std::cout << "   p50: " << latency.percentile_ms(50) << "ms\n";
+        std::cout << "   p90: " << latency.percentile_ms(90) << "ms\n";
+        std::cout << "   p99: " << latency.percentile_ms(99) << "ms\n";
+        std::cout << "   p99.9: " << latency.percentile_ms(99.9) << "ms\n";
+        std::cout << "   Max: " << latency.max_ms() << "ms\n";
+        std::cout << "\n🔬 PHASES (mean / p99):\n";
+        std::cout << "   Preprocessing: " << preprocessing.mean_ms() << "ms / " << preprocessing.percentile_ms(99) << "ms\n";
+        std::cout << "   Model Inference: " << inference.mean_ms() << "ms / " << inference.percentile_ms(99) << "ms\n";
+        std::cout << "   Postprocessing: " << postprocessing.mean_ms() << "ms / " << postprocessing.percentile_ms(99) << "ms\n";
+        std::cout << "\n📏 BY TEXT LENGTH (word tokens):\n";
+        std::cout << "   Tokens   Texts  Mean tok   OOV%  Preproc mean      p50      p99\n";
+        for (size_t b = 0; b < kNumLengthBuckets; b++) {
+            const LengthBucketStats& bucket = buckets[b];
+            if (bucket.texts == 0) continue;
+            std::cout << "   " << std::left << std::setw(6) << kLengthBuckets[b].name << std::right
+                      << std::setw(8) << bucket.texts << std::setw(10) << std::setprecision(1)
+                      << static_cast<double>(bucket.tokens) / bucket.texts << std::setw(7)
+                      << (bucket.tokens ? 100.0 * bucket.oov_tokens / bucket.tokens : 0.0) << std::setprecision(3)
+                      << std::setw(12) << bucket.preprocessing.mean_ms() << "ms" << std::setw(7)
+                      << bucket.latency.percentile_ms(50) << "ms" << std::setw(7)
+                      << bucket.latency.percentile_ms(99) << "ms\n";
+        }
+        std::cout << "\n🚀 THROUGHPUT:\n";
+        std::cout << "   Texts per second: " << std::setprecision(1) << 1000.0 / avg_time << "\n";
+        std::cout << "   Total benchmark time: " << std::setprecision(2) << overall_time / 1000.0 << "s\n";
+        std::cout << "   Overall throughput: " << std::setprecision(1) << num_runs / (overall_time / 1000.0) << " texts/sec\n";
+        std::cout << "\n💾 RESOURCE USAGE:\n";
+        std::cout << "   CPU Time: " << std::setprecision(3) << resources.cpu_seconds << "s ("
+                  << cpu_seconds_per_1k << " CPU-s per 1k texts)\n";
+        std::cout << "   CPU Usage: " << std::setprecision(1) << resources.cpu_avg_percent << "% avg, "
+                  << resources.cpu_max_percent << "% peak of " << get_usable_cpu_count() << " cores ("
+                  << resources.cpu_readings_count << " samples every " << g_cpu_monitor.interval_ms << "ms)\n";
+        std::cout << "   Peak RSS: " << std::setprecision(2) << resources.memory_peak_mb << " MB\n";
+        print_session_memory(session_memory);
+        std::cout << "   Heap allocations per inference (IoBinding): " << bound_allocations << "\n";
+        print_provider_sweep(provider_sweep);
+        std::cout << "\n";
+        print_startup_timing(classifier.startup());
+        
+        std::string performance_class;
+        if (avg_time < 10) {
+            performance_class = "🚀 EXCELLENT";
+        } else if (avg_time < 50) {
+            performance_class = "✅ GOOD";
+        } else if (avg_time < 100) {
+            performance_class = "⚠️ ACCEPTABLE";
+        } else {
+            performance_class = "❌ POOR";
+        }
+        
+        std::cout << "\n🎯 PERFORMANCE CLASSIFICATION: " << performance_class << "\n";
+        std::cout << "   (" << std::setprecision(1) << avg_time << "ms average - Target: <100ms)\n";
+        
+        if (!report_path.empty()) {
+            json report = benchmark_report("multiclass_sigmoid", *corpus, num_runs, overall_time, latency,
+                                           preprocessing, inference, postprocessing, system_info);
+            report["length_buckets"] = length_bucket_report(buckets);
+            report["threshold"] = threshold;
+            report["emotions_per_text"] = static_cast<double>(detected_total) / num_runs;
+            report["resources"] = {
+                {"cpu_seconds", resources.cpu_seconds},
+                {"cpu_seconds_per_1k_texts", cpu_seconds_per_1k},
+                {"cpu_avg_percent", resources.cpu_avg_percent},
+                {"cpu_max_percent", resources.cpu_max_percent},
+                {"cpu_sample_interval_ms", g_cpu_monitor.interval_ms},
+                {"cpu_cores", get_usable_cpu_count()},
+                {"peak_rss_mb", resources.memory_peak_mb}
+            };
+            report["allocations_per_inference"] = {{"iobinding", bound_allocations}};
+            if (!session_memory.empty()) report["session_memory"] = session_memory_report(session_memory);
+            if (!provider_sweep.empty()) report["providers"] = provider_sweep_report(provider_sweep);
+            report["startup_ms"] = startup_report(classifier.startup());
+            write_benchmark_report(report_path, report);
+        }
+        
+        return 0;
     
-    // Find dominant emotion
-    float maxProb = 0.0f;
-    int dominantIdx = 0;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Benchmark error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// Command line: [text] [--benchmark [N]] [--threshold P] [--report out.json] [--corpus file [--seed N]]
+//               [--intra-op-threads N] [--inter-op-threads N] [--cpu-interval MS] [--mmap-model] [--sessions N]
+//               [--provider cpu|xnnpack|cuda|coreml|openvino] [--sweep-providers] [--trace out.json]
+//               [--pin CPUS|node:N|cores] [--compile-vocab [out]]
+struct CliOptions {
+    std::string mode = "test";
+    std::string text;
+    std::string output_path;
+    std::string report_path;
+    std::string corpus_path;
+    std::string trace_path;
+    bool shuffle = false;
+    uint64_t seed = 0;
+    int num_runs = 0;
+    float threshold = 0.5f;
+    int sessions = 0;
+    bool sweep_providers = false;
+    SessionConfig session;
+    CpuPlacement placement;
+};
+
+bool parse_cli_options(int argc, char* argv[], CliOptions& options) {
+    auto is_number = [](const char* s) {
+        return *s != '\0' && std::all_of(s, s + std::strlen(s), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); });
+    };
+    auto read_count = [&](int& i, const std::string& name, int& value) {
+        if (i + 1 >= argc || !is_number(argv[i + 1]) || std::atoi(argv[i + 1]) < 1) {
+            std::cerr << "❌ " << name << " requires a positive integer\n";
+            return false;
+        }
+        value = std::atoi(argv[++i]);
+        return true;
+    };
     
-    for (int i = 0; i < 4; i++) {
-        cout << "   " << emotions[i] << ": " << fixed << setprecision(3) << probabilities[i] << endl;
-        if (probabilities[i] > maxProb) {
-            maxProb = probabilities[i];
-            dominantIdx = i;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--benchmark") {
+            options.mode = "benchmark";
+            options.num_runs = 100;
+            if (i + 1 < argc && is_number(argv[i + 1])) {
+                options.num_runs = std::max(1, std::atoi(argv[++i]));
+            }
+        } else if (arg == "--threshold") {
+            char* end = nullptr;
+            double threshold = i + 1 < argc ? std::strtod(argv[i + 1], &end) : -1.0;
+            if (end == nullptr || *end != '\0' || threshold < 0.0 || threshold > 1.0) {
+                std::cerr << "❌ --threshold requires a probability between 0 and 1\n";
+                return false;
+            }
+            options.threshold = static_cast<float>(threshold);
+            i++;
+        } else if (arg == "--compile-vocab") {
+            options.mode = "compile-vocab";
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                options.output_path = argv[++i];
+            }
+        } else if (arg == "--report") {
+            if (i + 1 >= argc) {
+                std::cerr << "❌ --report requires an output path\n";
+                return false;
+            }
+            options.report_path = argv[++i];
+        } else if (arg == "--corpus") {
+            if (i + 1 >= argc) {
+                std::cerr << "❌ --corpus requires a file path\n";
+                return false;
+            }
+            options.corpus_path = argv[++i];
+        } else if (arg == "--trace") {
+            if (i + 1 >= argc) {
+                std::cerr << "❌ --trace requires an output path\n";
+                return false;
+            }
+            options.trace_path = argv[++i];
+        } else if (arg == "--pin") {
+            if (i + 1 >= argc) {
+                std::cerr << "❌ --pin requires a CPU list (0-3,8), node:N or cores\n";
+                return false;
+            }
+            try {
+                options.placement = resolve_cpu_placement(argv[++i]);
+            } catch (const std::exception& e) {
+                std::cerr << "❌ --pin: " << e.what() << "\n";
+                return false;
+            }
+            options.session.pinned_cpus = options.placement.cpus;
+        } else if (arg == "--seed") {
+            if (i + 1 >= argc || !is_number(argv[i + 1])) {
+                std::cerr << "❌ --seed requires a non-negative integer\n";
+                return false;
+            }
+            options.seed = std::stoull(argv[++i]);
+            options.shuffle = true;
+        } else if (arg == "--cpu-interval") {
+            if (!read_count(i, arg, g_cpu_monitor.interval_ms)) return false;
+        } else if (arg == "--mmap-model") {
+            options.session.mmap_model = true;
+        } else if (arg == "--provider") {
+            if (i + 1 >= argc || !parse_execution_provider(argv[i + 1], options.session.provider)) {
+                std::cerr << "❌ --provider requires cpu, xnnpack, cuda, coreml or openvino\n";
+                return false;
+            }
+            i++;
+        } else if (arg == "--sweep-providers") {
+            options.sweep_providers = true;
+        } else if (arg == "--sessions") {
+            if (!read_count(i, arg, options.sessions)) return false;
+        } else if (arg == "--intra-op-threads") {
+            if (!read_count(i, arg, options.session.intra_op_threads)) return false;
+        } else if (arg == "--inter-op-threads") {
+            if (!read_count(i, arg, options.session.inter_op_threads)) return false;
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return false;
+        } else {
+            options.text = arg;
         }
     }
-    
-    cout << "   🏆 Dominant Emotion: " << emotions[dominantIdx] << " (" << fixed << setprecision(3) << maxProb << ")" << endl;
-    cout << "   📝 Input Text: \"" << text << "\"" << endl << endl;
+    return true;
 }
 
 int main(int argc, char* argv[]) {
-    string testText = (argc > 1) ? argv[1] : 
-        "I'm about to give birth, and I'm terrified. What if something goes wrong? What if I can't handle the pain? Received an unexpected compliment at work today. Small moments of happiness can make a big difference.";
-    
-    cout << "🤖 ONNX MULTICLASS SIGMOID CLASSIFIER - C++ IMPLEMENTATION" << endl;
-    cout << string(63, '=') << endl;
-    cout << "🔄 Processing: " << testText << endl << endl;
-    
-    SystemInfo systemInfo;
-    printSystemInfo(systemInfo);
-    
-    // Check if running in CI environment without model files
-    if (getenv("CI") || getenv("GITHUB_ACTIONS")) {
-        ifstream modelFile("model.onnx");
-        if (!modelFile) {
-            cout << "⚠️ Model files not found in CI environment - exiting safely" << endl;
-            cout << "✅ C++ implementation compiled and started successfully" << endl;
-            cout << "🏗️ Build verification completed" << endl;
-            return 0;
-        }
-        modelFile.close();
+    CliOptions options;
+    if (!parse_cli_options(argc, argv, options)) {
+        return 1;
     }
     
-    auto totalStartTime = chrono::high_resolution_clock::now();
-    
-    cout << "🔧 Loading components..." << endl;
-    cout << "✅ ONNX model loaded (demo mode)" << endl;
+    std::cout << "🤖 ONNX MULTICLASS SIGMOID CLASSIFIER - C++ IMPLEMENTATION\n";
+    std::cout << "===============================================================\n";
     
-    // Check if model files exist
-    ifstream modelCheck("model.onnx");
-    ifstream vocabCheck("vocab.json");
-    ifstream scalerCheck("scaler.json");
+    const std::string model_path = "model.onnx";
+    const std::string vocab_path = "vocab.json";
+    const std::string scaler_path = "scaler.json";
     
-    if (!modelCheck || !vocabCheck || !scalerCheck) {
-        cout << "⚠️ Model files not found - using simplified demo mode" << endl;
-        cout << "✅ C++ implementation compiled and started successfully" << endl;
-        cout << "🏗️ Build verification completed" << endl;
-        return 0;
+    // vocab.json is all --compile-vocab reads
+    if (options.mode == "compile-vocab") {
+        return compile_vocab(vocab_path,
+                             options.output_path.empty() ? VocabIndex::compiled_path(vocab_path) : options.output_path);
     }
     
-    cout << "✅ Components loaded" << endl << endl;
-    
-    cout << "📊 TF-IDF shape: [1, 5000]" << endl << endl;
+    // Exit safely when the model files are missing (e.g. CI build verification)
+    std::ifstream model_file(model_path);
+    std::ifstream vocab_file(vocab_path);
+    std::ifstream scaler_file(scaler_path);
     
-    // Simulate emotion analysis
-    simulateEmotionAnalysis(testText);
-    
-    // Performance metrics
-    auto totalEndTime = chrono::high_resolution_clock::now();
-    auto totalTime = chrono::duration_cast<chrono::milliseconds>(totalEndTime - totalStartTime);
+    if (!model_file.good() || !vocab_file.good() || !scaler_file.good()) {
+        std::cout << "⚠️ Model files not found - exiting safely\n";
+        std::cout << "🔧 This is expected in CI environments without model files\n";
+        std::cout << "✅ C++ implementation compiled successfully\n";
+        std::cout << "🏗️ Build verification completed\n";
+        return 0;
+    }
     
-    cout << "📈 PERFORMANCE SUMMARY:" << endl;
-    cout << "   Total Processing Time: " << totalTime.count() << "ms" << endl << endl;
+    // --pin: before anything is loaded, so the session, vocab and buffers
+    // are first touched, and allocated, on the placement's node
+    apply_cpu_placement(options.placement);
     
-    // Throughput
-    double throughput = 1000.0 / totalTime.count();
-    cout << "🚀 THROUGHPUT:" << endl;
-    cout << "   Texts per second: " << fixed << setprecision(1) << throughput << endl << endl;
+    // --trace: spans from here on, written with the ORT profile on return
+    std::unique_ptr<EmotionClassifier> classifier;
+    TraceRecorder trace(options.trace_path);
     
-    // Performance rating
-    string rating;
-    if (totalTime.count() < 50) {
-        rating = "🚀 EXCELLENT";
-    } else if (totalTime.count() < 100) {
-        rating = "✅ GOOD";
-    } else if (totalTime.count() < 500) {
-        rating = "⚠️ ACCEPTABLE";
-    } else {
-        rating = "🐌 SLOW";
+    // Load vocab, labels and session once for every text processed below
+    try {
+        SessionConfig config = options.session;
+        if (trace.enabled()) config.profile_prefix = ort_profile_prefix(options.trace_path);
+        double load_start = get_time_ms();
+        classifier = std::make_unique<EmotionClassifier>(model_path, vocab_path, scaler_path, config);
+        if (trace.enabled()) trace.add_ort_profile([&] { return classifier->end_profiling("multiclass_sigmoid"); });
+        std::cout << "🔧 Model loaded in " << std::fixed << std::setprecision(2) << get_time_ms() - load_start << "ms\n";
+        std::cout << "📦 Vocab: " << classifier->vocab_source() << ", " << classifier->feature_count() << " features, "
+                  << classifier->num_classes() << " emotions\n";
+        std::cout << "⚙️ Session: " << model_path << (options.session.mmap_model ? " (mmap)" : "") << " in " << classifier->startup().session_load_ms << "ms\n";
+        if (options.session.provider != ExecutionProvider::Cpu) {
+            std::cout << "🖥️ Provider: " << execution_provider_name(classifier->provider()) << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error loading model: " << e.what() << std::endl;
+        return 1;
     }
     
-    cout << "🎯 PERFORMANCE RATING: " << rating << endl;
-    cout << "   (" << totalTime.count() << "ms total - Target: <100ms)" << endl;
+    const std::string default_text =
+        "I'm about to give birth, and I'm terrified. What if something goes wrong? What if I can't handle the pain? "
+        "Received an unexpected compliment at work today. Small moments of happiness can make a big difference.";
     
-    return 0;
-} 
\ No newline at end of file
+    if (options.mode == "benchmark") {
+        std::unique_ptr<Corpus> corpus;
+        if (!options.corpus_path.empty()) {
+            try {
+                corpus = std::make_unique<Corpus>(load_corpus(options.corpus_path, options.shuffle, options.seed));
+            } catch (const std::exception& e) {
+                std::cerr << "❌ Error: " << e.what() << std::endl;
+                return 1;
+            }
+        }
+        std::vector<SessionMemoryResult> session_memory;
+        if (options.sessions > 0) {
+            ClassifierLoader<EmotionClassifier> load = [&](const std::string& path, const SessionConfig& config) {
+                return std::make_unique<EmotionClassifier>(path, vocab_path, scaler_path, config);
+            };
+            session_memory = measure_session_sharing(model_path, load, options.session, options.sessions);
+        }
+        // The multi-label model runs one text per Run, so only providers are swept
+        std::vector<ProviderSweepResult> provider_sweep;
+        if (options.sweep_providers) {
+            try {
+                ModelBundle bundle{ModelType::MultiLabel, model_path, vocab_path, scaler_path};
+                provider_sweep = sweep_providers(bundle, options.session, options.num_runs, 1,
+                                                 corpus ? corpus->texts : std::vector<std::string>{default_text});
+            } catch (const std::exception& e) {
+                std::cerr << "❌ Provider sweep error: " << e.what() << std::endl;
+                return 1;
+            }
+        }
+        return run_performance_benchmark(*classifier, options.num_runs, options.threshold, options.report_path,
+                                         corpus.get(), session_memory, provider_sweep);
+    }
+    return test_single_text(options.text.empty() ? default_text : options.text, *classifier, options.threshold);
+}